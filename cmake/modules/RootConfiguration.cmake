@@ -430,6 +430,11 @@ if(dataframe)
 else()
   set(hasdataframe undef)
 endif()
+if(clad)
+  set(hasclad define)
+else()
+  set(hasclad undef)
+endif()
 if(dev)
   set(use_less_includes define)
 else()
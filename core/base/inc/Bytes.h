@@ -444,6 +444,87 @@ inline void frombuf(char *&buf, Long_t *x)   { frombuf(buf, (ULong_t *) x); }
 inline void frombuf(char *&buf, Long64_t *x) { frombuf(buf, (ULong64_t *) x); }
 
 
+//______________________________________________________________________________
+// Array versions of tobuf() and frombuf() for n values of 2, 4 or 8 bytes.
+// Large arrays are byte swapped by the vectorized kernels of Bytes.cxx
+// (SSSE3, AVX2, AVX-512 or NEON, selected at run time).
+namespace ROOT {
+namespace Internal {
+
+void ByteSwapCopy16(void *to, const void *from, size_t n);
+void ByteSwapCopy32(void *to, const void *from, size_t n);
+void ByteSwapCopy64(void *to, const void *from, size_t n);
+const char *GetByteSwapKernelName();
+
+/// Copy n values of type T, swapping the bytes of each of them; to and from
+/// may be the same buffer.
+template <typename T>
+inline void ByteSwapCopy(void *to, const void *from, size_t n)
+{
+   static_assert(sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "Unsupported type size");
+   // Below a few vectors, the call through the dispatch table costs more than it saves.
+   if (n * sizeof(T) < 64) {
+      char *out = (char *)to;
+      const char *in = (const char *)from;
+      for (size_t i = 0; i < n; ++i, in += sizeof(T), out += sizeof(T)) {
+         char tmp[sizeof(T)];
+         for (size_t b = 0; b < sizeof(T); ++b)
+            tmp[b] = in[sizeof(T) - 1 - b];
+         memcpy(out, tmp, sizeof(T));
+      }
+   } else if (sizeof(T) == 2) {
+      ByteSwapCopy16(to, from, n);
+   } else if (sizeof(T) == 4) {
+      ByteSwapCopy32(to, from, n);
+   } else {
+      ByteSwapCopy64(to, from, n);
+   }
+}
+
+template <typename T>
+inline void ToBufArray(char *&buf, const T *x, Int_t n)
+{
+#ifdef R__BYTESWAP
+   ByteSwapCopy<T>(buf, x, n);
+#else
+   memcpy(buf, x, n * sizeof(T));
+#endif
+   buf += n * sizeof(T);
+}
+
+template <typename T>
+inline void FromBufArray(char *&buf, T *x, Int_t n)
+{
+#ifdef R__BYTESWAP
+   ByteSwapCopy<T>(x, buf, n);
+#else
+   memcpy(x, buf, n * sizeof(T));
+#endif
+   buf += n * sizeof(T);
+}
+
+} // namespace Internal
+} // namespace ROOT
+
+inline void tobuf(char *&buf, const Short_t *x, Int_t n)   { ROOT::Internal::ToBufArray(buf, x, n); }
+inline void tobuf(char *&buf, const UShort_t *x, Int_t n)  { ROOT::Internal::ToBufArray(buf, x, n); }
+inline void tobuf(char *&buf, const Int_t *x, Int_t n)     { ROOT::Internal::ToBufArray(buf, x, n); }
+inline void tobuf(char *&buf, const UInt_t *x, Int_t n)    { ROOT::Internal::ToBufArray(buf, x, n); }
+inline void tobuf(char *&buf, const Long64_t *x, Int_t n)  { ROOT::Internal::ToBufArray(buf, x, n); }
+inline void tobuf(char *&buf, const ULong64_t *x, Int_t n) { ROOT::Internal::ToBufArray(buf, x, n); }
+inline void tobuf(char *&buf, const Float_t *x, Int_t n)   { ROOT::Internal::ToBufArray(buf, x, n); }
+inline void tobuf(char *&buf, const Double_t *x, Int_t n)  { ROOT::Internal::ToBufArray(buf, x, n); }
+
+inline void frombuf(char *&buf, Short_t *x, Int_t n)   { ROOT::Internal::FromBufArray(buf, x, n); }
+inline void frombuf(char *&buf, UShort_t *x, Int_t n)  { ROOT::Internal::FromBufArray(buf, x, n); }
+inline void frombuf(char *&buf, Int_t *x, Int_t n)     { ROOT::Internal::FromBufArray(buf, x, n); }
+inline void frombuf(char *&buf, UInt_t *x, Int_t n)    { ROOT::Internal::FromBufArray(buf, x, n); }
+inline void frombuf(char *&buf, Long64_t *x, Int_t n)  { ROOT::Internal::FromBufArray(buf, x, n); }
+inline void frombuf(char *&buf, ULong64_t *x, Int_t n) { ROOT::Internal::FromBufArray(buf, x, n); }
+inline void frombuf(char *&buf, Float_t *x, Int_t n)   { ROOT::Internal::FromBufArray(buf, x, n); }
+inline void frombuf(char *&buf, Double_t *x, Int_t n)  { ROOT::Internal::FromBufArray(buf, x, n); }
+
+
 //______________________________________________________________________________
 #ifdef R__BYTESWAP
 inline UShort_t host2net(UShort_t x)
@@ -0,0 +1,201 @@
+// @(#)root/base:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2020, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// Bytes                                                                //
+//                                                                      //
+// Vectorized byte swapping of arrays used by the array versions of     //
+// tobuf() and frombuf(). The best kernel supported by the CPU is       //
+// selected the first time one of the routines is called.              //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Bytes.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define R__BYTESWAP_X86
+#include <immintrin.h>
+#if defined(__clang__) || __GNUC__ >= 6
+#define R__BYTESWAP_AVX512
+#endif
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define R__BYTESWAP_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+using Kernel_t = void (*)(char *out, const char *in, size_t n);
+
+struct RByteSwapKernels {
+   Kernel_t fSwap16;
+   Kernel_t fSwap32;
+   Kernel_t fSwap64;
+   const char *fName;
+};
+
+template <int Size>
+void SwapCopyScalar(char *out, const char *in, size_t n)
+{
+   for (size_t i = 0; i < n; ++i, in += Size, out += Size) {
+      char tmp[Size];
+      for (int b = 0; b < Size; ++b)
+         tmp[b] = in[Size - 1 - b];
+      memcpy(out, tmp, Size);
+   }
+}
+
+#if defined(R__BYTESWAP_X86)
+
+/// Fill 'mask' with the byte shuffle reversing each element of Size bytes.
+template <int Size>
+void MakeShuffleMask(char *mask, int len)
+{
+   for (int i = 0; i < len; ++i)
+      mask[i] = (i / Size) * Size + (Size - 1 - i % Size);
+}
+
+template <int Size>
+__attribute__((target("ssse3"))) void SwapCopySSSE3(char *out, const char *in, size_t n)
+{
+   alignas(16) char mask[16];
+   MakeShuffleMask<Size>(mask, 16);
+   const __m128i shuffle = _mm_load_si128((const __m128i *)mask);
+   const size_t nbytes = n * Size;
+   size_t i = 0;
+   for (; i + 16 <= nbytes; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+      _mm_storeu_si128((__m128i *)(out + i), _mm_shuffle_epi8(v, shuffle));
+   }
+   SwapCopyScalar<Size>(out + i, in + i, (nbytes - i) / Size);
+}
+
+template <int Size>
+__attribute__((target("avx2"))) void SwapCopyAVX2(char *out, const char *in, size_t n)
+{
+   // The byte shuffle works within each 128-bit lane, hence the same mask in both lanes.
+   alignas(32) char mask[32];
+   MakeShuffleMask<Size>(mask, 32);
+   const __m256i shuffle = _mm256_load_si256((const __m256i *)mask);
+   const size_t nbytes = n * Size;
+   size_t i = 0;
+   for (; i + 64 <= nbytes; i += 64) {
+      __m256i v0 = _mm256_loadu_si256((const __m256i *)(in + i));
+      __m256i v1 = _mm256_loadu_si256((const __m256i *)(in + i + 32));
+      _mm256_storeu_si256((__m256i *)(out + i), _mm256_shuffle_epi8(v0, shuffle));
+      _mm256_storeu_si256((__m256i *)(out + i + 32), _mm256_shuffle_epi8(v1, shuffle));
+   }
+   for (; i + 32 <= nbytes; i += 32) {
+      __m256i v = _mm256_loadu_si256((const __m256i *)(in + i));
+      _mm256_storeu_si256((__m256i *)(out + i), _mm256_shuffle_epi8(v, shuffle));
+   }
+   SwapCopyScalar<Size>(out + i, in + i, (nbytes - i) / Size);
+}
+
+#if defined(R__BYTESWAP_AVX512)
+template <int Size>
+__attribute__((target("avx512f,avx512bw"))) void SwapCopyAVX512(char *out, const char *in, size_t n)
+{
+   alignas(64) char mask[64];
+   MakeShuffleMask<Size>(mask, 64);
+   const __m512i shuffle = _mm512_load_si512((const void *)mask);
+   const size_t nbytes = n * Size;
+   size_t i = 0;
+   for (; i + 64 <= nbytes; i += 64) {
+      __m512i v = _mm512_loadu_si512((const void *)(in + i));
+      _mm512_storeu_si512((void *)(out + i), _mm512_shuffle_epi8(v, shuffle));
+   }
+   SwapCopyScalar<Size>(out + i, in + i, (nbytes - i) / Size);
+}
+#endif
+
+#elif defined(R__BYTESWAP_NEON)
+
+template <int Size>
+void SwapCopyNEON(char *out, const char *in, size_t n)
+{
+   const size_t nbytes = n * Size;
+   size_t i = 0;
+   for (; i + 16 <= nbytes; i += 16) {
+      uint8x16_t v = vld1q_u8((const uint8_t *)(in + i));
+      if (Size == 2)
+         v = vrev16q_u8(v);
+      else if (Size == 4)
+         v = vrev32q_u8(v);
+      else
+         v = vrev64q_u8(v);
+      vst1q_u8((uint8_t *)(out + i), v);
+   }
+   SwapCopyScalar<Size>(out + i, in + i, (nbytes - i) / Size);
+}
+
+#endif
+
+RByteSwapKernels SelectKernels()
+{
+#if defined(R__BYTESWAP_X86)
+   __builtin_cpu_init();
+#if defined(R__BYTESWAP_AVX512)
+   if (__builtin_cpu_supports("avx512bw"))
+      return {SwapCopyAVX512<2>, SwapCopyAVX512<4>, SwapCopyAVX512<8>, "AVX-512"};
+#endif
+   if (__builtin_cpu_supports("avx2"))
+      return {SwapCopyAVX2<2>, SwapCopyAVX2<4>, SwapCopyAVX2<8>, "AVX2"};
+   if (__builtin_cpu_supports("ssse3"))
+      return {SwapCopySSSE3<2>, SwapCopySSSE3<4>, SwapCopySSSE3<8>, "SSSE3"};
+#elif defined(R__BYTESWAP_NEON)
+   return {SwapCopyNEON<2>, SwapCopyNEON<4>, SwapCopyNEON<8>, "NEON"};
+#endif
+   return {SwapCopyScalar<2>, SwapCopyScalar<4>, SwapCopyScalar<8>, "scalar"};
+}
+
+const RByteSwapKernels &GetKernels()
+{
+   static const RByteSwapKernels kernels = SelectKernels();
+   return kernels;
+}
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 2-byte values from 'from' to 'to', swapping their bytes.
+/// 'to' and 'from' may be the same buffer but must not otherwise overlap.
+
+void ROOT::Internal::ByteSwapCopy16(void *to, const void *from, size_t n)
+{
+   GetKernels().fSwap16((char *)to, (const char *)from, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 4-byte values from 'from' to 'to', swapping their bytes.
+/// 'to' and 'from' may be the same buffer but must not otherwise overlap.
+
+void ROOT::Internal::ByteSwapCopy32(void *to, const void *from, size_t n)
+{
+   GetKernels().fSwap32((char *)to, (const char *)from, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 8-byte values from 'from' to 'to', swapping their bytes.
+/// 'to' and 'from' may be the same buffer but must not otherwise overlap.
+
+void ROOT::Internal::ByteSwapCopy64(void *to, const void *from, size_t n)
+{
+   GetKernels().fSwap64((char *)to, (const char *)from, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the instruction set used by the byte swapping kernels.
+
+const char *ROOT::Internal::GetByteSwapKernelName()
+{
+   return GetKernels().fName;
+}
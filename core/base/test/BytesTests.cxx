@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+
+#include "Bytes.h"
+
+#include <cstring>
+#include <vector>
+
+template <typename T>
+static T ReferenceSwap(T value)
+{
+   char in[sizeof(T)], out[sizeof(T)];
+   memcpy(in, &value, sizeof(T));
+   for (size_t b = 0; b < sizeof(T); ++b)
+      out[b] = in[sizeof(T) - 1 - b];
+   memcpy(&value, out, sizeof(T));
+   return value;
+}
+
+template <typename T>
+static void CheckByteSwapCopy()
+{
+   // Cover lengths below, at and above the vector widths, and unaligned buffers.
+   for (size_t n : {0, 1, 3, 7, 8, 15, 16, 33, 64, 127, 1000}) {
+      std::vector<char> storage((n + 1) * sizeof(T));
+      std::vector<T> in(n);
+      for (size_t i = 0; i < n; ++i)
+         in[i] = static_cast<T>(0x0102030405060708ULL * (i + 1));
+      char *out = storage.data() + 1;
+      ROOT::Internal::ByteSwapCopy<T>(out, in.data(), n);
+      for (size_t i = 0; i < n; ++i) {
+         T value;
+         memcpy(&value, out + i * sizeof(T), sizeof(T));
+         EXPECT_EQ(ReferenceSwap(in[i]), value) << "n=" << n << " i=" << i;
+      }
+      // In place, swapping twice restores the input.
+      std::vector<T> inplace(in);
+      ROOT::Internal::ByteSwapCopy<T>(inplace.data(), inplace.data(), n);
+      ROOT::Internal::ByteSwapCopy<T>(inplace.data(), inplace.data(), n);
+      EXPECT_EQ(in, inplace);
+   }
+}
+
+TEST(Bytes, ByteSwapCopy)
+{
+   ASSERT_NE(nullptr, ROOT::Internal::GetByteSwapKernelName());
+   CheckByteSwapCopy<UShort_t>();
+   CheckByteSwapCopy<UInt_t>();
+   CheckByteSwapCopy<ULong64_t>();
+}
+
+TEST(Bytes, ArrayRoundTrip)
+{
+   const Int_t n = 200;
+   std::vector<Double_t> values(n);
+   std::vector<Int_t> ints(n);
+   for (Int_t i = 0; i < n; ++i) {
+      values[i] = 0.25 * i - 7.;
+      ints[i] = i * 1000 - 5;
+   }
+
+   std::vector<char> buffer(n * (sizeof(Double_t) + sizeof(Int_t)));
+   char *cur = buffer.data();
+   tobuf(cur, values.data(), n);
+   tobuf(cur, ints.data(), n);
+   EXPECT_EQ(buffer.data() + buffer.size(), cur);
+
+   // The array overloads must produce the same bytes as the scalar ones.
+   std::vector<char> scalar(buffer.size());
+   cur = scalar.data();
+   for (Int_t i = 0; i < n; ++i)
+      tobuf(cur, values[i]);
+   for (Int_t i = 0; i < n; ++i)
+      tobuf(cur, ints[i]);
+   EXPECT_EQ(scalar, buffer);
+
+   std::vector<Double_t> valuesRead(n);
+   std::vector<Int_t> intsRead(n);
+   cur = buffer.data();
+   frombuf(cur, valuesRead.data(), n);
+   frombuf(cur, intsRead.data(), n);
+   EXPECT_EQ(values, valuesRead);
+   EXPECT_EQ(ints, intsRead);
+}
@@ -58,6 +58,29 @@ struct InterpreterMutexRegistrationRAII {
    InterpreterMutexRegistrationRAII(TVirtualMutex* mutex);
    ~InterpreterMutexRegistrationRAII();
 };
+
+/// Functions compiled with the interpreter from generated code, shared between
+/// the objects generating the same code. The failures are cached as well, so
+/// that the compilation of a given code is attempted only once. The caller is
+/// responsible for the locking.
+class TJITFunctionCache {
+   std::map<std::string, void *> fFunctions; ///< Compiled functions (nullptr on failure) by key.
+   Int_t fNextId = 0;                        ///< Id of the next function to compile.
+
+public:
+   /// Return true if the compilation was already attempted for 'key', setting 'func' to its result.
+   bool Find(const std::string &key, void *&func) const
+   {
+      auto res = fFunctions.find(key);
+      if (res == fFunctions.end())
+         return false;
+      func = res->second;
+      return true;
+   }
+   /// Return a number unique in this cache, to be used in the name of the next function to compile.
+   Int_t NextId() { return fNextId++; }
+   void *Compile(const std::string &key, const char *code, const char *name);
+};
 }
 }
 
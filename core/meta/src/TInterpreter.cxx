@@ -65,3 +65,17 @@ TInterpreter *TInterpreter::Instance()
    }
    return gInterpreterLocal;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Declare 'code' to the interpreter and return the address of the function
+/// 'name' it defines, or nullptr if the code cannot be compiled. The result,
+/// including a failure, is cached under 'key' (see Find()).
+
+void *ROOT::Internal::TJITFunctionCache::Compile(const std::string &key, const char *code, const char *name)
+{
+   void *func = nullptr;
+   if (gInterpreter && gInterpreter->Declare(code))
+      func = reinterpret_cast<void *>(gInterpreter->Calc(name));
+   fFunctions[key] = func;
+   return func;
+}
@@ -17,6 +17,8 @@
 #ifndef ROOT_RZip
 #define ROOT_RZip
 
+#include <functional>
+
 extern "C" unsigned long R__crc32(unsigned long crc, const unsigned char* buf, unsigned int len);
 
 extern "C" unsigned long R__memcompress(char *tgt, unsigned long tgtsize, char *src, unsigned long srcsize);
@@ -35,4 +37,56 @@ extern "C" int R__unzip_header(int *srcsize, unsigned char *src, int *tgtsize);
 
 enum { kMAXZIPBUF = 0xffffff };
 
+namespace ROOT {
+namespace Internal {
+
+class RZstdDictionary;
+
+/// Return the algorithm used to compress with 'algorithm', i.e. the global setting for kUseGlobal.
+ROOT::RCompressionSetting::EAlgorithm::EValues R__resolveAlgorithm(ROOT::RCompressionSetting::EAlgorithm::EValues algorithm);
+
+/**
+ * As the C function of the same name; for the ZSTD algorithm, a non-null 'zstdDict' is used as the compression
+ * dictionary. R__unzip() finds the dictionary from the ID stored in the compressed frame, provided that it was
+ * registered beforehand with RZstdDictionary::Register().
+ */
+void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep,
+                             ROOT::RCompressionSetting::EAlgorithm::EValues algorithm,
+                             const RZstdDictionary *zstdDict);
+
+/**
+ * Compress 'srcsize' bytes of 'src' into 'tgt' as a sequence of blocks of at most kMAXZIPBUF input bytes,
+ * each with its own header, as done for TKey and TBasket payloads. 'tgt' must hold 'srcsize' bytes plus
+ * the size of one header (9 bytes) per block. With 'nthreads' > 1 the blocks are compressed concurrently;
+ * the output does not depend on the number of threads. 'zstdDict' is the ZSTD dictionary to use, if any.
+ * Returns the total compressed size, or 0 if one of the blocks could not be compressed.
+ */
+int R__zipBlocks(int cxlevel, int srcsize, char *src, int tgtsize, char *tgt,
+                 ROOT::RCompressionSetting::EAlgorithm::EValues algorithm, int nthreads = 1,
+                 const RZstdDictionary *zstdDict = nullptr);
+
+/**
+ * Decompress the sequence of compressed blocks in the 'srcsize' bytes of 'src' into the 'tgtsize' bytes of 'tgt',
+ * stopping once 'tgtsize' bytes are produced. With 'nthreads' > 1 and several blocks, the blocks are decompressed
+ * concurrently. Returns the number of bytes decompressed, or 0 in case of error.
+ */
+int R__unzipBlocks(int srcsize, unsigned char *src, int tgtsize, unsigned char *tgt, int nthreads = 1);
+
+/**
+ * Calls work(i) for each block i in [0, nblocks), possibly concurrently, e.g. as tasks of a thread pool.
+ */
+using RBlockRunner = std::function<void(int nblocks, const std::function<void(int)> &work)>;
+
+/**
+ * As above, processing the blocks with 'runner' instead of on 'nthreads' threads; without a runner, the
+ * blocks are processed sequentially.
+ */
+int R__zipBlocks(int cxlevel, int srcsize, char *src, int tgtsize, char *tgt,
+                 ROOT::RCompressionSetting::EAlgorithm::EValues algorithm, const RBlockRunner &runner,
+                 const RZstdDictionary *zstdDict = nullptr);
+int R__unzipBlocks(int srcsize, unsigned char *src, int tgtsize, unsigned char *tgt, const RBlockRunner &runner);
+
+} // namespace Internal
+} // namespace ROOT
+
 #endif
@@ -16,8 +16,12 @@
 
 #include "zlib.h"
 
+#include <atomic>
 #include <cstdio>
 #include <cassert>
+#include <cstring>
+#include <thread>
+#include <vector>
 
 // The size of the ROOT block framing headers for compression:
 // - 3 bytes to identify the compression algorithm and version.
@@ -110,6 +114,25 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
   }
 }
 
+ROOT::RCompressionSetting::EAlgorithm::EValues
+ROOT::Internal::R__resolveAlgorithm(ROOT::RCompressionSetting::EAlgorithm::EValues algorithm)
+{
+  return algorithm == ROOT::RCompressionSetting::EAlgorithm::kUseGlobal ? R__ZipMode : algorithm;
+}
+
+void ROOT::Internal::R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep,
+                                             ROOT::RCompressionSetting::EAlgorithm::EValues algorithm,
+                                             const RZstdDictionary *zstdDict)
+{
+  algorithm = R__resolveAlgorithm(algorithm);
+  if (!zstdDict || algorithm != ROOT::RCompressionSetting::EAlgorithm::kZSTD || cxlevel <= 0 ||
+      *srcsize < 1 + HDRSIZE + 1) {
+    ::R__zipMultipleAlgorithm(cxlevel, srcsize, src, tgtsize, tgt, irep, algorithm);
+    return;
+  }
+  R__zipZSTDDict(*zstdDict, cxlevel, srcsize, src, tgtsize, tgt, irep);
+}
+
   // The very old algorithm for backward compatibility
   // 0 for selecting with R__ZipMode in a backward compatible way
   // 3 for selecting in other cases
@@ -420,3 +443,149 @@ void R__unzipZLIB(int *srcsize, unsigned char *src, int *tgtsize, unsigned char
      *irep = stream.total_out;
      return;
 }
+
+/**
+ * Call work(i) for each block i in [0, nblocks), on up to nthreads threads.
+ */
+static void R__forEachBlock(int nblocks, int nthreads, const std::function<void(int)> &work)
+{
+   if (nthreads > nblocks)
+      nthreads = nblocks;
+   if (nthreads <= 1) {
+      for (int i = 0; i < nblocks; ++i)
+         work(i);
+      return;
+   }
+
+   std::atomic<int> next{0};
+   auto worker = [&]() {
+      for (int i = next++; i < nblocks; i = next++)
+         work(i);
+   };
+   std::vector<std::thread> threads;
+   threads.reserve(nthreads - 1);
+   for (int t = 1; t < nthreads; ++t)
+      threads.emplace_back(worker);
+   worker();
+   for (auto &thread : threads)
+      thread.join();
+}
+
+/**
+ * Return the runner processing the blocks on nthreads threads, none if nthreads <= 1.
+ */
+static ROOT::Internal::RBlockRunner R__threadBlockRunner(int nthreads)
+{
+   if (nthreads <= 1)
+      return {};
+   return [nthreads](int nblocks, const std::function<void(int)> &work) { R__forEachBlock(nblocks, nthreads, work); };
+}
+
+int ROOT::Internal::R__zipBlocks(int cxlevel, int srcsize, char *src, int tgtsize, char *tgt,
+                                 ROOT::RCompressionSetting::EAlgorithm::EValues algorithm, int nthreads,
+                                 const RZstdDictionary *zstdDict)
+{
+   return R__zipBlocks(cxlevel, srcsize, src, tgtsize, tgt, algorithm, R__threadBlockRunner(nthreads), zstdDict);
+}
+
+int ROOT::Internal::R__zipBlocks(int cxlevel, int srcsize, char *src, int tgtsize, char *tgt,
+                                 ROOT::RCompressionSetting::EAlgorithm::EValues algorithm, const RBlockRunner &runner,
+                                 const RZstdDictionary *zstdDict)
+{
+   const int nblocks = 1 + (srcsize - 1) / kMAXZIPBUF;
+   if (srcsize <= 0 || tgtsize < srcsize + HDRSIZE * nblocks)
+      return 0;
+
+   if (nblocks == 1 || !runner) {
+      int noutot = 0;
+      for (int i = 0; i < nblocks; ++i) {
+         int bufmax = (i == nblocks - 1) ? srcsize - i * kMAXZIPBUF : kMAXZIPBUF;
+         int nout = 0;
+         R__zipMultipleAlgorithm(cxlevel, &bufmax, src + (long)i * kMAXZIPBUF, &bufmax, tgt + noutot, &nout, algorithm,
+                                 zstdDict);
+         if (nout == 0)
+            return 0;
+         noutot += nout;
+      }
+      return noutot;
+   }
+
+   // Block i is compressed at the position it would have if no block shrank, then
+   // the blocks are moved down, in order, behind each other.
+   std::vector<int> nouts(nblocks, 0);
+   runner(nblocks, [&](int i) {
+      int bufmax = (i == nblocks - 1) ? srcsize - i * kMAXZIPBUF : kMAXZIPBUF;
+      R__zipMultipleAlgorithm(cxlevel, &bufmax, src + (long)i * kMAXZIPBUF, &bufmax,
+                              tgt + (long)i * (kMAXZIPBUF + HDRSIZE), &nouts[i], algorithm, zstdDict);
+   });
+   int noutot = 0;
+   for (int i = 0; i < nblocks; ++i) {
+      if (nouts[i] == 0)
+         return 0;
+      if (i)
+         memmove(tgt + noutot, tgt + (long)i * (kMAXZIPBUF + HDRSIZE), nouts[i]);
+      noutot += nouts[i];
+   }
+   return noutot;
+}
+
+int ROOT::Internal::R__unzipBlocks(int srcsize, unsigned char *src, int tgtsize, unsigned char *tgt, int nthreads)
+{
+   return R__unzipBlocks(srcsize, src, tgtsize, tgt, R__threadBlockRunner(nthreads));
+}
+
+int ROOT::Internal::R__unzipBlocks(int srcsize, unsigned char *src, int tgtsize, unsigned char *tgt,
+                                   const RBlockRunner &runner)
+{
+   struct RBlock {
+      int fSrcOffset;
+      int fSrcSize;
+      int fTgtOffset;
+      int fTgtSize;
+   };
+
+   // Locate the blocks from their headers.
+   std::vector<RBlock> blocks;
+   int srcoffset = 0, tgtoffset = 0;
+   while (tgtoffset < tgtsize && srcoffset + HDRSIZE <= srcsize) {
+      int nin, nbuf;
+      if (R__unzip_header(&nin, src + srcoffset, &nbuf) != 0)
+         break;
+      blocks.push_back({srcoffset, nin, tgtoffset, nbuf});
+      srcoffset += nin;
+      tgtoffset += nbuf;
+   }
+   if (blocks.empty())
+      return 0;
+
+   // Serially, or if the headers do not describe the expected sizes, proceed as the
+   // historical loop does: block after block, each at the end of the previous output.
+   if (!runner || blocks.size() == 1 || srcoffset > srcsize || tgtoffset > tgtsize) {
+      int noutot = 0;
+      unsigned char *bufcur = src;
+      while (true) {
+         int nin, nbuf, nout = 0;
+         if (R__unzip_header(&nin, bufcur, &nbuf) != 0)
+            break;
+         nbuf = tgtsize - noutot;
+         R__unzip(&nin, bufcur, &nbuf, tgt + noutot, &nout);
+         if (!nout)
+            return 0;
+         noutot += nout;
+         if (noutot >= tgtsize)
+            break;
+         bufcur += nin;
+      }
+      return noutot;
+   }
+
+   std::atomic<bool> failed{false};
+   runner((int)blocks.size(), [&](int i) {
+      const RBlock &block = blocks[i];
+      int nin = block.fSrcSize, nbuf = block.fTgtSize, nout = 0;
+      R__unzip(&nin, src + block.fSrcOffset, &nbuf, tgt + block.fTgtOffset, &nout);
+      if (nout != block.fTgtSize)
+         failed = true;
+   });
+   return failed ? 0 : tgtoffset;
+}
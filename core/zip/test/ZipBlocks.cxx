@@ -0,0 +1,135 @@
+#include "RZip.h"
+#include "ZipZSTD.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// Input spanning several compression blocks, compressible but not trivially so.
+static std::vector<char> MakeInput(int size)
+{
+   std::vector<char> input(size);
+   std::mt19937 gen(42);
+   std::uniform_int_distribution<int> dist(0, 15);
+   for (auto &c : input)
+      c = 'a' + dist(gen);
+   return input;
+}
+
+TEST(ZipBlocks, ParallelOutputMatchesSerial)
+{
+   const int srcsize = 2 * kMAXZIPBUF + 1000;
+   auto input = MakeInput(srcsize);
+   const int tgtsize = srcsize + 9 * 3;
+
+   const auto algorithm = ROOT::RCompressionSetting::EAlgorithm::kZLIB;
+
+   std::vector<char> serial(tgtsize), parallel(tgtsize);
+   const int nserial = ROOT::Internal::R__zipBlocks(1, srcsize, input.data(), tgtsize, serial.data(), algorithm, 1);
+   const int nparallel =
+      ROOT::Internal::R__zipBlocks(1, srcsize, input.data(), tgtsize, parallel.data(), algorithm, 4);
+   ASSERT_GT(nserial, 0);
+   ASSERT_LT(nserial, srcsize);
+   ASSERT_EQ(nserial, nparallel);
+   EXPECT_EQ(0, memcmp(serial.data(), parallel.data(), nserial));
+
+   for (int nthreads : {1, 4}) {
+      std::vector<char> output(srcsize);
+      const int nout = ROOT::Internal::R__unzipBlocks(nserial, (unsigned char *)serial.data(), srcsize,
+                                                      (unsigned char *)output.data(), nthreads);
+      EXPECT_EQ(srcsize, nout);
+      EXPECT_EQ(input, output);
+   }
+}
+
+TEST(ZipBlocks, BlockRunner)
+{
+   const int srcsize = 2 * kMAXZIPBUF + 1000;
+   auto input = MakeInput(srcsize);
+   const int tgtsize = srcsize + 9 * 3;
+   const auto algorithm = ROOT::RCompressionSetting::EAlgorithm::kZLIB;
+
+   // Process the blocks in reverse order, as a pool of tasks may.
+   int nruns = 0;
+   ROOT::Internal::RBlockRunner reversed = [&](int nblocks, const std::function<void(int)> &work) {
+      ++nruns;
+      for (int i = nblocks - 1; i >= 0; --i)
+         work(i);
+   };
+
+   std::vector<char> serial(tgtsize), withRunner(tgtsize);
+   const int nserial = ROOT::Internal::R__zipBlocks(1, srcsize, input.data(), tgtsize, serial.data(), algorithm, 1);
+   const int nrunner =
+      ROOT::Internal::R__zipBlocks(1, srcsize, input.data(), tgtsize, withRunner.data(), algorithm, reversed);
+   EXPECT_EQ(1, nruns);
+   ASSERT_GT(nserial, 0);
+   ASSERT_EQ(nserial, nrunner);
+   EXPECT_EQ(0, memcmp(serial.data(), withRunner.data(), nserial));
+
+   std::vector<char> output(srcsize);
+   EXPECT_EQ(srcsize, ROOT::Internal::R__unzipBlocks(nrunner, (unsigned char *)withRunner.data(), srcsize,
+                                                     (unsigned char *)output.data(), reversed));
+   EXPECT_EQ(2, nruns);
+   EXPECT_EQ(input, output);
+}
+
+TEST(ZipBlocks, CorruptedBlock)
+{
+   const int srcsize = 2 * kMAXZIPBUF + 1000;
+   auto input = MakeInput(srcsize);
+   const int tgtsize = srcsize + 9 * 3;
+   std::vector<char> compressed(tgtsize);
+   const int nzip = ROOT::Internal::R__zipBlocks(1, srcsize, input.data(), tgtsize, compressed.data(),
+                                                 ROOT::RCompressionSetting::EAlgorithm::kZLIB, 4);
+   ASSERT_GT(nzip, 0);
+
+   // Damage the payload of the last block.
+   compressed[nzip - 10] ^= 0x5a;
+   compressed[nzip - 20] ^= 0x5a;
+   std::vector<char> output(srcsize);
+   EXPECT_EQ(0, ROOT::Internal::R__unzipBlocks(nzip, (unsigned char *)compressed.data(), srcsize,
+                                               (unsigned char *)output.data(), 4));
+}
+
+TEST(ZipBlocks, ZstdDictionary)
+{
+   // Small records sharing most of their content, as the baskets of a branch do.
+   auto makeRecord = [](int i) {
+      std::string record = "event=" + std::to_string(i) + ";run=4711;detector=calorimeter;energy=";
+      record += std::to_string(i * 37 % 1000) + ";quality=good;trigger=muon+electron+jet;padding=";
+      record += std::string(64, 'x');
+      return record;
+   };
+
+   ROOT::Internal::RZstdDictionaryTrainer trainer(1024);
+   const ROOT::Internal::RZstdDictionary *dict = nullptr;
+   for (int i = 0; i < 2000 && !dict; ++i) {
+      std::string sample;
+      for (int j = 0; j < 8; ++j)
+         sample += makeRecord(8 * i + j);
+      dict = trainer.AddSample(sample.data(), sample.size());
+   }
+   ASSERT_NE(nullptr, dict);
+   EXPECT_TRUE(trainer.IsDone());
+   EXPECT_EQ(dict, ROOT::Internal::RZstdDictionary::Find(dict->GetID()));
+   EXPECT_EQ(dict, ROOT::Internal::RZstdDictionary::Register(dict->GetContent().data(), dict->GetContent().size()));
+   EXPECT_EQ(nullptr, ROOT::Internal::RZstdDictionary::Register("not a dictionary", 16));
+
+   std::string input = makeRecord(100000) + makeRecord(100001);
+   const int srcsize = input.size();
+   const int tgtsize = srcsize + 9;
+   const auto algorithm = ROOT::RCompressionSetting::EAlgorithm::kZSTD;
+   std::vector<char> plain(tgtsize), withDict(tgtsize);
+   const int nplain = ROOT::Internal::R__zipBlocks(5, srcsize, &input[0], tgtsize, plain.data(), algorithm);
+   const int ndict = ROOT::Internal::R__zipBlocks(5, srcsize, &input[0], tgtsize, withDict.data(), algorithm, 1, dict);
+   ASSERT_GT(ndict, 0);
+   EXPECT_TRUE(nplain == 0 || ndict < nplain);
+
+   std::vector<char> output(srcsize);
+   EXPECT_EQ(srcsize, ROOT::Internal::R__unzipBlocks(ndict, (unsigned char *)withDict.data(), srcsize,
+                                                     (unsigned char *)output.data()));
+   EXPECT_EQ(input, std::string(output.data(), output.size()));
+}
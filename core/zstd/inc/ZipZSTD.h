@@ -19,6 +19,83 @@ void R__zipZSTD(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, i
 void R__unzipZSTD(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep);
 #ifdef __cplusplus
 }
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace ROOT {
+namespace Internal {
+
+/**
+ * A ZSTD dictionary, in the format produced by ZDICT_trainFromBuffer() or `zstd --train`.
+ * Dictionaries are registered process-wide by their ID: the ID is part of every ZSTD frame compressed
+ * with the dictionary, so that R__unzipZSTD() finds it without any change of the ROOT block header.
+ * Registered dictionaries are never released; the digested forms used for compression (per level)
+ * and decompression are created once and cached.
+ */
+class RZstdDictionary {
+private:
+   std::string fContent;
+   unsigned int fID = 0;
+   ZSTD_DDict_s *fDDict = nullptr;
+   mutable std::mutex fCDictMutex;
+   mutable std::vector<ZSTD_CDict_s *> fCDicts; ///< Indexed by ZSTD compression level
+
+   RZstdDictionary(std::string content, unsigned int id);
+
+public:
+   RZstdDictionary(const RZstdDictionary &) = delete;
+   RZstdDictionary &operator=(const RZstdDictionary &) = delete;
+   ~RZstdDictionary();
+
+   /// Register a dictionary; returns the already registered one if its ID is known, nullptr if the content
+   /// is not a ZSTD dictionary.
+   static const RZstdDictionary *Register(const void *content, size_t size);
+   /// Return the registered dictionary with the given ID, nullptr if there is none.
+   static const RZstdDictionary *Find(unsigned int id);
+   /// Train a dictionary of at most 'capacity' bytes from 'nsamples' samples stored back-to-back in 'samples'
+   /// and register it; returns nullptr if the training fails, e.g. for lack of samples.
+   static const RZstdDictionary *Train(const void *samples, const size_t *sampleSizes, unsigned int nsamples,
+                                       size_t capacity);
+
+   unsigned int GetID() const { return fID; }
+   const std::string &GetContent() const { return fContent; }
+   ZSTD_CDict_s *GetCDict(int level) const;
+   ZSTD_DDict_s *GetDDict() const { return fDDict; }
+};
+
+/**
+ * Collects the first buffers compressed for a given purpose (e.g. the baskets of a branch) and trains a
+ * dictionary from them once enough samples are available.
+ */
+class RZstdDictionaryTrainer {
+private:
+   size_t fCapacity;
+   std::string fSamples;
+   std::vector<size_t> fSampleSizes;
+   bool fDone = false;
+
+public:
+   explicit RZstdDictionaryTrainer(size_t capacity) : fCapacity(capacity) {}
+
+   /// Add a sample; returns the trained dictionary once enough samples have been collected and nullptr before.
+   /// After the training, successful or not, the trainer is done and ignores further samples.
+   const RZstdDictionary *AddSample(const void *buffer, size_t size);
+   bool IsDone() const { return fDone; }
+};
+
+/// Compress as R__zipZSTD() does, using the dictionary 'dict'.
+void R__zipZSTDDict(const RZstdDictionary &dict, int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt,
+                    int *irep);
+
+} // namespace Internal
+} // namespace ROOT
 #endif
 
 #endif
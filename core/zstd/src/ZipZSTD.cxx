@@ -14,7 +14,9 @@
 
 #include "zdict.h"
 #include <zstd.h>
+#include <algorithm>
 #include <memory>
+#include <unordered_map>
 
 #include <iostream>
 
@@ -22,6 +24,20 @@ static const int kHeaderSize = 9;
 
 static const size_t errorCodeSmallBuffer = (size_t)-70;
 
+/// Fill the ROOT block header in front of a compressed ZSTD frame.
+static void R__writeHeaderZSTD(char *tgt, size_t deflate_size, size_t inflate_size)
+{
+    tgt[0] = 'Z';
+    tgt[1] = 'S';
+    tgt[2] = '\1';
+    tgt[3] = deflate_size & 0xff;
+    tgt[4] = (deflate_size >> 8) & 0xff;
+    tgt[5] = (deflate_size >> 16) & 0xff;
+    tgt[6] = inflate_size & 0xff;
+    tgt[7] = (inflate_size >> 8) & 0xff;
+    tgt[8] = (inflate_size >> 16) & 0xff;
+}
+
 void R__zipZSTD(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep)
 {
     using Ctx_ptr = std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)>;
@@ -45,17 +61,37 @@ void R__zipZSTD(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, i
         *irep = static_cast<size_t>(retval + kHeaderSize);
     }
 
-    size_t deflate_size = retval;
-    size_t inflate_size = static_cast<size_t>(*srcsize);
-    tgt[0] = 'Z';
-    tgt[1] = 'S';
-    tgt[2] = '\1';
-    tgt[3] = deflate_size & 0xff;
-    tgt[4] = (deflate_size >> 8) & 0xff;
-    tgt[5] = (deflate_size >> 16) & 0xff;
-    tgt[6] = inflate_size & 0xff;
-    tgt[7] = (inflate_size >> 8) & 0xff;
-    tgt[8] = (inflate_size >> 16) & 0xff;
+    R__writeHeaderZSTD(tgt, retval, static_cast<size_t>(*srcsize));
+}
+
+void ROOT::Internal::R__zipZSTDDict(const RZstdDictionary &dict, int cxlevel, int *srcsize, char *src, int *tgtsize,
+                                   char *tgt, int *irep)
+{
+    using Ctx_ptr = std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)>;
+    Ctx_ptr fCtx{ZSTD_createCCtx(), &ZSTD_freeCCtx};
+
+    *irep = 0;
+
+    ZSTD_CDict *cdict = dict.GetCDict(2 * cxlevel);
+    if (R__unlikely(!cdict)) {
+        R__zipZSTD(cxlevel, srcsize, src, tgtsize, tgt, irep);
+        return;
+    }
+
+    size_t retval = ZSTD_compress_usingCDict(fCtx.get(),
+                                             &tgt[kHeaderSize], static_cast<size_t>(*tgtsize - kHeaderSize),
+                                             src, static_cast<size_t>(*srcsize), cdict);
+
+    if (R__unlikely(ZSTD_isError(retval))) {
+        if (R__unlikely(retval != errorCodeSmallBuffer)) {
+            std::cerr << "Error in zip ZSTD with dictionary. Type = " << ZSTD_getErrorName(retval) <<
+            " . Code = " << retval << std::endl;
+        }
+        return;
+    }
+    *irep = static_cast<size_t>(retval + kHeaderSize);
+
+    R__writeHeaderZSTD(tgt, retval, static_cast<size_t>(*srcsize));
 }
 
 void R__unzipZSTD(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
@@ -77,9 +113,25 @@ void R__unzipZSTD(int *srcsize, unsigned char *src, int *tgtsize, unsigned char
       return;
     }
 
-    size_t retval = ZSTD_decompressDCtx(fCtx.get(),
-                                        (char *)tgt, static_cast<size_t>(*tgtsize),
-                                        (char *)&src[kHeaderSize], static_cast<size_t>(*srcsize - kHeaderSize));
+    // Frames compressed with a dictionary carry its ID.
+    const unsigned int dictID = ZSTD_getDictID_fromFrame(&src[kHeaderSize], static_cast<size_t>(*srcsize - kHeaderSize));
+    const ROOT::Internal::RZstdDictionary *dict = nullptr;
+    if (dictID != 0) {
+      dict = ROOT::Internal::RZstdDictionary::Find(dictID);
+      if (R__unlikely(!dict)) {
+        std::cerr << "R__unzipZSTD: the buffer was compressed with the dictionary " << dictID <<
+        " which is not available." << std::endl;
+        return;
+      }
+    }
+
+    size_t retval = dict ? ZSTD_decompress_usingDDict(fCtx.get(),
+                                                      (char *)tgt, static_cast<size_t>(*tgtsize),
+                                                      (char *)&src[kHeaderSize], static_cast<size_t>(*srcsize - kHeaderSize),
+                                                      dict->GetDDict())
+                         : ZSTD_decompressDCtx(fCtx.get(),
+                                               (char *)tgt, static_cast<size_t>(*tgtsize),
+                                               (char *)&src[kHeaderSize], static_cast<size_t>(*srcsize - kHeaderSize));
 
     /* The error code 18446744073709551546 arises when the tgt buffer is too small
      * However this error is already handled outside of the compression algorithm
@@ -95,3 +147,109 @@ void R__unzipZSTD(int *srcsize, unsigned char *src, int *tgtsize, unsigned char
         *irep = retval;
     }
 }
+
+namespace {
+
+/// The process-wide dictionaries, by ID.
+struct RZstdDictionaryRegistry {
+   std::mutex fMutex;
+   std::unordered_map<unsigned int, std::unique_ptr<ROOT::Internal::RZstdDictionary>> fDictionaries;
+};
+
+RZstdDictionaryRegistry &GetDictionaryRegistry()
+{
+   // Leaked on purpose: dictionaries may be needed while other static objects are destructed.
+   static RZstdDictionaryRegistry *registry = new RZstdDictionaryRegistry;
+   return *registry;
+}
+
+// Samples are truncated to this size for the training; ZDICT only uses their first bytes anyway.
+constexpr size_t kMaxSampleSize = 128 * 1024;
+// A dictionary is trained once the samples amount to that many times its capacity...
+constexpr size_t kSamplesPerCapacity = 32;
+// ... and there are at least that many samples.
+constexpr size_t kMinSamples = 8;
+
+} // anonymous namespace
+
+ROOT::Internal::RZstdDictionary::RZstdDictionary(std::string content, unsigned int id)
+   : fContent(std::move(content)), fID(id), fCDicts(ZSTD_maxCLevel() + 1, nullptr)
+{
+   fDDict = ZSTD_createDDict(fContent.data(), fContent.size());
+}
+
+ROOT::Internal::RZstdDictionary::~RZstdDictionary()
+{
+   for (auto cdict : fCDicts)
+      ZSTD_freeCDict(cdict);
+   ZSTD_freeDDict(fDDict);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the dictionary digested for compression at the given ZSTD level, nullptr if it cannot be created.
+
+ZSTD_CDict *ROOT::Internal::RZstdDictionary::GetCDict(int level) const
+{
+   level = std::max(1, std::min(level, ZSTD_maxCLevel()));
+   std::lock_guard<std::mutex> lock(fCDictMutex);
+   if (!fCDicts[level])
+      fCDicts[level] = ZSTD_createCDict(fContent.data(), fContent.size(), level);
+   return fCDicts[level];
+}
+
+const ROOT::Internal::RZstdDictionary *ROOT::Internal::RZstdDictionary::Register(const void *content, size_t size)
+{
+   if (!content || size == 0)
+      return nullptr;
+   const unsigned int id = ZDICT_getDictID(content, size);
+   if (id == 0)
+      return nullptr;
+
+   auto &registry = GetDictionaryRegistry();
+   std::lock_guard<std::mutex> lock(registry.fMutex);
+   auto &entry = registry.fDictionaries[id];
+   if (!entry) {
+      entry.reset(new RZstdDictionary(std::string(static_cast<const char *>(content), size), id));
+      if (!entry->fDDict) {
+         registry.fDictionaries.erase(id);
+         return nullptr;
+      }
+   }
+   return entry.get();
+}
+
+const ROOT::Internal::RZstdDictionary *ROOT::Internal::RZstdDictionary::Find(unsigned int id)
+{
+   auto &registry = GetDictionaryRegistry();
+   std::lock_guard<std::mutex> lock(registry.fMutex);
+   auto iter = registry.fDictionaries.find(id);
+   return iter == registry.fDictionaries.end() ? nullptr : iter->second.get();
+}
+
+const ROOT::Internal::RZstdDictionary *
+ROOT::Internal::RZstdDictionary::Train(const void *samples, const size_t *sampleSizes, unsigned int nsamples,
+                                       size_t capacity)
+{
+   std::string dict(capacity, '\0');
+   const size_t size = ZDICT_trainFromBuffer(&dict[0], capacity, samples, sampleSizes, nsamples);
+   if (ZDICT_isError(size))
+      return nullptr;
+   return Register(dict.data(), size);
+}
+
+const ROOT::Internal::RZstdDictionary *ROOT::Internal::RZstdDictionaryTrainer::AddSample(const void *buffer, size_t size)
+{
+   if (fDone || size == 0)
+      return nullptr;
+   size = std::min(size, kMaxSampleSize);
+   fSamples.append(static_cast<const char *>(buffer), size);
+   fSampleSizes.push_back(size);
+   if (fSamples.size() < kSamplesPerCapacity * fCapacity || fSampleSizes.size() < kMinSamples)
+      return nullptr;
+
+   fDone = true;
+   auto dict = RZstdDictionary::Train(fSamples.data(), fSampleSizes.data(), fSampleSizes.size(), fCapacity);
+   std::string().swap(fSamples);
+   std::vector<size_t>().swap(fSampleSizes);
+   return dict;
+}
@@ -18,6 +18,7 @@
 
 #include "TF1.h"
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace ROOT {
@@ -124,6 +125,10 @@ namespace ROOT {
          // evaluate the derivative of the function with respect to the parameters
          void ParameterGradient(const T *x, const double *par, T *grad) const;
 
+         /// return true for linear functions and for the formulas with a gradient generated by Clad
+         /// (see TFormula::GenerateGradientPar), false when the derivatives are computed numerically
+         bool HasParameterGradient() const;
+
          /// precision value used for calculating the derivative step-size
          /// h = eps * |x|. The default is 0.001, give a smaller in case function changes rapidly
          static void SetDerivPrecision(double eps);
@@ -148,6 +153,9 @@ namespace ROOT {
             return fFunc->EvalPar(x, p);
          }
 
+         /// evaluate function at n points passing coordinates x and vector of parameters
+         void DoEvalParBatch(const T *x, size_t n, size_t stride, const double *p, T *out) const;
+
          /// evaluate function using the cached parameter values (of TF1)
          /// re-implement for better efficiency
          T DoEvalVec(const T *x) const
@@ -209,6 +217,27 @@ namespace ROOT {
          }
       };
 
+      /**
+       * Auxiliar class to evaluate the TF1 at many points: TF1::EvalParBatch is only available for double, the
+       * vectorized types are evaluated point by point.
+       */
+      template <class T>
+      struct EvalParBatchHelper {
+         static void EvalParBatch(TF1 *func, const T *x, size_t n, size_t stride, const double *p, T *out)
+         {
+            for (size_t i = 0; i < n; ++i)
+               out[i] = func->EvalPar(x + i * stride, p);
+         }
+      };
+
+      template <>
+      struct EvalParBatchHelper<double> {
+         static void EvalParBatch(TF1 *func, const double *x, size_t n, size_t stride, const double *p, double *out)
+         {
+            func->EvalParBatch(x, n, stride, p, out);
+         }
+      };
+
       // implementations for WrappedMultiTF1Templ<T>
       template<class T>
       WrappedMultiTF1Templ<T>::WrappedMultiTF1Templ(TF1 &f, unsigned int dim)  :
@@ -290,6 +319,23 @@ namespace ROOT {
          }
       }
 
+      template <class T>
+      bool WrappedMultiTF1Templ<T>::HasParameterGradient() const
+      {
+         if (fLinear)
+            return true;
+         // the Clad gradient is only used for scalar evaluation and does not include the normalization
+         const TFormula *formula = fFunc->GetFormula();
+         return std::is_same<T, double>::value && formula && formula->HasGeneratedGradient() &&
+                !fFunc->IsEvalNormalized();
+      }
+
+      template <class T>
+      void WrappedMultiTF1Templ<T>::DoEvalParBatch(const T *x, size_t n, size_t stride, const double *p, T *out) const
+      {
+         EvalParBatchHelper<T>::EvalParBatch(fFunc, x, n, stride, p, out);
+      }
+
       template <class T>
       T WrappedMultiTF1Templ<T>::DoParameterDerivative(const T *x, const double *p, unsigned int ipar) const
       {
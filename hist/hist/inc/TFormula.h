@@ -105,11 +105,13 @@ private:
    std::string       fGradGenerationInput; //! input query to clad to generate a gradient
    CallFuncSignature fFuncPtr = nullptr; //!  function pointer, owned by the JIT.
    CallFuncSignature fGradFuncPtr = nullptr; //!  function pointer, owned by the JIT.
+   mutable std::atomic<CallFuncSignature> fBatchFuncPtr{nullptr}; //!  function pointer evaluating many points, owned by the JIT.
    void *   fLambdaPtr = nullptr;            //!  pointer to the lambda function
    static bool       fIsCladRuntimeIncluded;
 
    void     InputFormulaIntoCling();
    Bool_t   PrepareEvalMethod();
+   CallFuncSignature PrepareBatchEvalMethod() const;
    void     FillDefaults();
    void     HandlePolN(TString &formula);
    void     HandleParametrizedFunctions(TString &formula);
@@ -190,11 +192,13 @@ public:
    Int_t          Compile(const char *expression="");
    virtual void   Copy(TObject &f1) const;
    virtual void   Clear(Option_t * option="");
+   static Int_t   CompilePendingFormulas();
    Double_t       Eval(Double_t x) const;
    Double_t       Eval(Double_t x, Double_t y) const;
    Double_t       Eval(Double_t x, Double_t y , Double_t z) const;
    Double_t       Eval(Double_t x, Double_t y , Double_t z , Double_t t ) const;
    Double_t       EvalPar(const Double_t *x, const Double_t *params=0) const;
+   void           EvalParBatch(const Double_t *x, size_t n, size_t stride, const Double_t *params, Double_t *out) const;
 
    /// Generate gradient computation routine with respect to the parameters.
    /// \returns true if a gradient was generated and GradientPar can be called.
@@ -239,6 +243,7 @@ public:
    Int_t          GetVarNumber(const char *name) const;
    TString        GetVarName(Int_t ivar) const;
    Bool_t         IsValid() const { return fReadyToExecute && fClingInitialized; }
+   static Bool_t  IsDeferredCompilation();
    Bool_t IsVectorized() const { return fVectorized; }
    Bool_t         IsLinear() const { return TestBit(kLinear); }
    void           Print(Option_t *option = "") const;
@@ -257,6 +262,7 @@ public:
                              *name8="p8",const char *name9="p9",const char *name10="p10"); // *MENU*
    void           SetVariable(const TString &name, Double_t value);
    void           SetVariables(const std::pair<TString,Double_t> *vars, const Int_t size);
+   static void    SetDeferredCompilation(Bool_t on = kTRUE);
    void SetVectorized(Bool_t vectorized);
 
    ClassDef(TFormula,13)
@@ -106,6 +106,9 @@ private:
                           Bool_t wantNDim, Option_t* option = "") const;
    Bool_t PrintBin(Long64_t idx, Int_t* coord, Option_t* options) const;
    void AddInternal(const THnBase* h, Double_t c, Bool_t rebinned);
+   /// Add the bins of h, which has the same binning, scaled by c without going
+   /// through their coordinates; return false if the storage does not allow it.
+   virtual Bool_t AddSameBinning(const THnBase* /*h*/, Double_t /*c*/) { return kFALSE; }
    THnBase* RebinBase(Int_t group) const;
    THnBase* RebinBase(const Int_t* group) const;
    void ResetBase(Option_t *option= "");
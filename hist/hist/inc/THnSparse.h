@@ -21,7 +21,6 @@
 
 
 #include "THnBase.h"
-#include "TExMap.h"
 #include "THnSparse_Internal.h"
 
 // needed only for template instantiations of THnSparseT:
@@ -31,6 +30,8 @@
 #include "TArrayS.h"
 #include "TArrayC.h"
 
+#include <vector>
+
 class THnSparseCompactBinCoord;
 
 class THnSparse: public THnBase {
@@ -38,8 +39,7 @@ class THnSparse: public THnBase {
    Int_t      fChunkSize;    // number of entries for each chunk
    Long64_t   fFilledBins;   // number of filled bins
    TObjArray  fBinContent;   // array of THnSparseArrayChunk
-   TExMap     fBins;         //! filled bins
-   TExMap     fBinsContinued;//! filled bins for non-unique hashes, containing pairs of (bin index 0, bin index 1)
+   std::vector<ULong64_t> fBinIndex; //! open addressing table of the filled bins, pairs of (hash, bin index + 1)
    THnSparseCompactBinCoord *fCompactCoord; //! compact coordinate
 
    THnSparse(const THnSparse&); // Not implemented
@@ -57,7 +57,10 @@ class THnSparse: public THnBase {
 
    THnSparseArrayChunk* AddChunk();
    void Reserve(Long64_t nbins);
-   void FillExMap();
+   void FillBinIndex();
+   void ResizeBinIndex(Long64_t nbins);
+   void AddToBinIndex(ULong64_t hash, Long64_t idx);
+   Bool_t AddSameBinning(const THnBase* h, Double_t c);
    virtual TArray* GenerateArray() const = 0;
    Long64_t GetBinIndexForCurrentBin(Bool_t allocate);
 
@@ -84,6 +87,8 @@ class THnSparse: public THnBase {
                                        chunkSize);
    }
 
+   void FillN(Long64_t n, const Double_t* x, const Double_t* w = nullptr);
+
    Int_t GetChunkSize() const { return fChunkSize; }
    Int_t GetNChunks() const { return fBinContent.GetEntriesFast(); }
 
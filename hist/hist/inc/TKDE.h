@@ -65,6 +65,12 @@ public:
       kForcedBinning
    };
 
+   enum EEvaluation { // Density evaluation option
+      kDirect, // Sum the kernels of all the events (or bins)
+      kFFT,    // Convolute the binned data with the kernel using a FFT (fixed bandwidth)
+      kTree    // Sum the kernels using a KD-tree of the events, approximating the far away groups of events
+   };
+
    
    TKDE();                    // defaul constructor used only by I/O 
 
@@ -97,6 +103,8 @@ public:
    void SetBinning(EBinning);
    void SetNBins(UInt_t nbins);
    void SetUseBinsNEvents(UInt_t nEvents);
+   void SetEvaluation(EEvaluation eval);
+   void SetEvaluationTolerance(Double_t tol);
    void SetTuneFactor(Double_t rho);
    void SetRange(Double_t xMin, Double_t xMax); // By default computed from the data
 
@@ -158,6 +166,7 @@ private:
    EIteration fIteration;
    EMirror fMirror;
    EBinning fBinning;
+   EEvaluation fEvaluation;
 
 
    Bool_t fUseMirroring, fMirrorLeft, fMirrorRight, fAsymLeft, fAsymRight;
@@ -179,6 +188,7 @@ private:
    Double_t fAdaptiveBandwidthFactor; // Geometric mean of the kernel density estimation from the data for adaptive iteration
 
    Double_t fWeightSize; // Caches the weight size
+   Double_t fEvalTolerance; // Relative tolerance of the FFT and tree evaluations
 
    std::vector<Double_t> fCanonicalBandwidths;
    std::vector<Double_t> fKernelSigmas2;
@@ -216,6 +226,7 @@ private:
    Double_t ComputeKernelSigma2() const;
    Double_t ComputeKernelMu() const;
    Double_t ComputeKernelIntegral() const;
+   Double_t ComputeKernelSupport() const;
    Double_t ComputeMidspread() ;
    void ComputeDataStats() ;
 
@@ -253,7 +264,7 @@ private:
    TF1* GetPDFUpperConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
    TF1* GetPDFLowerConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
 
-   ClassDef(TKDE, 2) // One dimensional semi-parametric Kernel Density Estimation
+   ClassDef(TKDE, 3) // One dimensional semi-parametric Kernel Density Estimation
 
 };
 
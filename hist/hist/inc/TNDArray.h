@@ -184,6 +184,9 @@ public:
       fData[linidx] += (T) value;
    }
 
+   /// Access the bin storage; nullptr if no bin was set yet, i.e. all bins are 0.
+   const T* GetData() const { return fData; }
+
 protected:
    int fNumData; // number of bins, product of fSizes
    T*  fData; //[fNumData] data
@@ -28,6 +28,8 @@
 #include "TList.h"
 #include "TMath.h"
 #include "TROOT.h"
+#include "TSystem.h"
+#include "TFormula.h"
 
 #include "TVirtualPad.h" // for gPad
 
@@ -55,6 +57,8 @@ namespace HFit {
 
    int CheckFitFunction(const TF1 * f1, int hdim);
 
+   void UseFormulaGradient(TF1 & f1, ROOT::Fit::FitConfig & fitConfig);
+
 
    void GetFunctionRange(const TF1 & f1, ROOT::Fit::DataRange & range);
 
@@ -116,6 +120,33 @@ int HFit::CheckFitFunction(const TF1 * f1, int dim) {
 
 }
 
+void HFit::UseFormulaGradient(TF1 & f1, ROOT::Fit::FitConfig & fitConfig) {
+   // For a function defined by a formula, generate the gradient with respect to the parameters
+   // with Clad and use it in the fit. If it cannot be generated, the fitter falls back to the
+   // gradient computed by the minimizer
+#ifdef R__HAS_CLAD
+   TFormula * formula = f1.GetFormula();
+   if (!formula) return;
+   if (!formula->HasGeneratedGradient() && !formula->HasGradientGenerationFailed()) {
+      // Clad reports the expressions it cannot differentiate as compilation errors:
+      // do not show them, the fit just continues without the analytic gradient
+      RedirectHandle_t handle;
+#ifdef R__WIN32
+      gSystem->RedirectOutput("NUL", "w", &handle);
+#else
+      gSystem->RedirectOutput("/dev/null", "w", &handle);
+#endif
+      formula->GenerateGradientPar();
+      gSystem->RedirectOutput(nullptr, "w", &handle);
+   }
+   if (formula->HasGeneratedGradient())
+      fitConfig.SetAnalyticGradient(true);
+#else
+   (void) f1;
+   (void) fitConfig;
+#endif
+}
+
 
 void HFit::GetFunctionRange(const TF1 & f1, ROOT::Fit::DataRange & range) {
    // get the range form the function and fill and return the DataRange object
@@ -232,8 +263,10 @@ TFitResultPtr HFit::Fit(FitObject * h1, TF1 *f1 , Foption_t & fitOption , const
 
    // set the fit function
    // if option grad is specified use gradient
-   if ( (linear || fitOption.Gradient) )
+   if ( (linear || fitOption.Gradient) ) {
+      if (fitOption.Gradient) HFit::UseFormulaGradient(*f1, fitConfig);
       fitter->SetFunction(ROOT::Math::WrappedMultiTF1(*f1));
+   }
 #ifdef R__HAS_VECCORE
    else if(f1->IsVectorized())
       fitter->SetFunction(static_cast<const ROOT::Math::IParamMultiFunctionTempl<ROOT::Double_v> &>(ROOT::Math::WrappedMultiTF1Templ<ROOT::Double_v>(*f1)));
@@ -844,6 +877,7 @@ TFitResultPtr ROOT::Fit::UnBinFit(ROOT::Fit::UnBinData * data, TF1 * fitfunc, Fo
    // need to create a wrapper for an automatic  normalized TF1 ???
    if ( fitOption.Gradient ) {
       assert ( (int) dim == fitfunc->GetNdim() );
+      HFit::UseFormulaGradient(*fitfunc, fitConfig);
       fitter->SetFunction(ROOT::Math::WrappedMultiTF1(*fitfunc) );
    }
    else
@@ -0,0 +1,87 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2020, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+// Helper functions adding the bin storage of histograms with the same binning,
+// used when merging TH1 and THn.
+
+#ifndef ROOT_HistAddKernels
+#define ROOT_HistAddKernels
+
+#include "RtypesCore.h"
+
+#include <algorithm>
+#include <limits>
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "TROOT.h"
+#endif
+
+namespace ROOT {
+namespace Internal {
+
+// The loops have independent iterations without branches, so that compilers
+// vectorize them; the source and target arrays belong to different histograms.
+
+/// to[i] += from[i] for i in [0, n).
+template <typename T, typename U>
+inline void AddBinArrays(T *to, const U *from, Long64_t n)
+{
+   for (Long64_t i = 0; i < n; ++i)
+      to[i] += from[i];
+}
+
+/// to[i] += c * from[i] for i in [0, n), converting each term to T like TNDArrayT::AddAt().
+template <typename T, typename U>
+inline void AddBinArrays(T *to, const U *from, Long64_t n, Double_t c)
+{
+   for (Long64_t i = 0; i < n; ++i)
+      to[i] += (T)(c * from[i]);
+}
+
+/// to[i] += from[i] for i in [0, n), saturating at +/- the largest value of the
+/// integer type T like TH1C, TH1S and TH1I::AddBinContent().
+template <typename T>
+inline void AddBinArraysSaturated(T *to, const T *from, Long64_t n)
+{
+   const Long64_t max = std::numeric_limits<T>::max();
+   for (Long64_t i = 0; i < n; ++i)
+      to[i] = (T)std::min(std::max((Long64_t)to[i] + (Long64_t)from[i], -max), max);
+}
+
+/// Call f(first, last) for consecutive bin ranges covering [0, nbins). The ranges
+/// are processed on the implicit multi-threading pool if it is enabled and
+/// 'work', the number of bin additions, is large enough.
+template <typename F>
+void ForEachBinRange(Long64_t nbins, Long64_t work, F &&f)
+{
+#ifdef R__USE_IMT
+   constexpr Long64_t kMinWorkPerTask = 1 << 18;
+   const Long64_t ntasks = ROOT::IsImplicitMTEnabled()
+                              ? std::min<Long64_t>({work / kMinWorkPerTask, 4 * ROOT::GetThreadPoolSize(), nbins / 64})
+                              : 0;
+   if (ntasks > 1) {
+      // Keep the ranges multiples of 64 bins, such that no cache line is shared by two tasks.
+      const Long64_t step = (nbins / ntasks + 63) & ~63LL;
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](UInt_t i) { f(i * step, std::min(nbins, (i + 1) * step)); },
+                   ROOT::TSeqU((nbins + step - 1) / step));
+      return;
+   }
+#else
+   (void)work;
+#endif
+   f(0, nbins);
+}
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
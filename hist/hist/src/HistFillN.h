@@ -0,0 +1,30 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2020, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+// Parameters of the FillN methods of TH1, TH2 and TH3, which process the
+// entries by chunks.
+
+#ifndef ROOT_HistFillN
+#define ROOT_HistFillN
+
+#include "RtypesCore.h"
+
+namespace ROOT {
+namespace Internal {
+
+/// Number of entries whose bins are looked up at once by the FillN methods
+constexpr Int_t kFillNChunk = 512;
+/// Number of partial sums of each statistic accumulated by the FillN methods
+constexpr Int_t kFillNLanes = 4;
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -2456,6 +2456,31 @@ void TF1::GradientPar(const Double_t *x, Double_t *grad, Double_t eps)
       GradientParTempl<Double_t>(x, grad, eps);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the function at n points, storing the results in out.
+///
+/// The coordinates of point i start at x[i * stride]. Functions defined by a
+/// formula are evaluated with TFormula::EvalParBatch(), the other functions
+/// point by point with EvalPar().
+
+void TF1::EvalParBatch(const Double_t *x, size_t n, size_t stride, const Double_t *params, Double_t *out)
+{
+   if (fType == EFType::kFormula) {
+      assert(fFormula);
+      fFormula->EvalParBatch(x, n, stride, params, out);
+      if (fNormalized && fNormIntegral != 0) {
+         for (size_t i = 0; i < n; ++i)
+            out[i] /= fNormIntegral;
+      }
+      return;
+   }
+   for (size_t i = 0; i < n; ++i) {
+      if (fType == EFType::kInterpreted)
+         InitArgs(x + i * stride, params);
+      out[i] = EvalPar(x + i * stride, params);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Initialize parameters addresses.
 
@@ -3031,7 +3056,6 @@ void TF1::Paint(Option_t *choptin)
 TH1   *TF1::DoCreateHistogram(Double_t xmin, Double_t  xmax, Bool_t recreate)
 {
    Int_t i;
-   Double_t xv[1];
 
    TH1 *histogram = 0;
 
@@ -3100,11 +3124,12 @@ TH1   *TF1::DoCreateHistogram(Double_t xmin, Double_t  xmax, Bool_t recreate)
    histogram->GetYaxis()->SetTitle(ytitle.Data());
    Double_t *parameters = GetParameters();
 
-   InitArgs(xv, parameters);
-   for (i = 1; i <= fNpx; i++) {
-      xv[0] = histogram->GetBinCenter(i);
-      histogram->SetBinContent(i, EvalPar(xv, parameters));
-   }
+   std::vector<Double_t> xs(fNpx), ys(fNpx);
+   for (i = 1; i <= fNpx; i++)
+      xs[i - 1] = histogram->GetBinCenter(i);
+   EvalParBatch(xs.data(), fNpx, 1, parameters, ys.data());
+   for (i = 1; i <= fNpx; i++)
+      histogram->SetBinContent(i, ys[i - 1]);
 
    // Copy Function attributes to histogram attributes.
    histogram->SetBit(TH1::kNoStats);
@@ -3152,13 +3177,10 @@ void TF1::Save(Double_t xmin, Double_t xmax, Double_t, Double_t, Double_t, Doubl
          int fNsave = bin2 - bin1 + 4;
          //fSave  = new Double_t[fNsave];
          fSave.resize(fNsave);
-         Double_t xv[1];
-
-         InitArgs(xv, parameters);
-         for (Int_t i = bin1; i <= bin2; i++) {
-            xv[0]    = h->GetXaxis()->GetBinCenter(i);
-            fSave[i - bin1] = EvalPar(xv, parameters);
-         }
+         std::vector<Double_t> xs(bin2 - bin1 + 1);
+         for (Int_t i = bin1; i <= bin2; i++)
+            xs[i - bin1] = h->GetXaxis()->GetBinCenter(i);
+         EvalParBatch(xs.data(), xs.size(), 1, parameters, fSave.data());
          fSave[fNsave - 3] = xmin;
          fSave[fNsave - 2] = xmax;
          fSave[fNsave - 1] = xmax;
@@ -3178,12 +3200,10 @@ void TF1::Save(Double_t xmin, Double_t xmax, Double_t, Double_t, Double_t, Doubl
       xmin = fXmin + 0.5 * dx;
       xmax = fXmax - 0.5 * dx;
    }
-   Double_t xv[1];
-   InitArgs(xv, parameters);
-   for (Int_t i = 0; i <= fNpx; i++) {
-      xv[0]    = xmin + dx * i;
-      fSave[i] = EvalPar(xv, parameters);
-   }
+   std::vector<Double_t> xs(fNpx + 1);
+   for (Int_t i = 0; i <= fNpx; i++)
+      xs[i] = xmin + dx * i;
+   EvalParBatch(xs.data(), xs.size(), 1, parameters, fSave.data());
    fSave[fNpx + 1] = xmin;
    fSave[fNpx + 2] = xmax;
 }
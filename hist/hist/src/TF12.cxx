@@ -167,6 +167,15 @@ Double_t TF12::EvalPar(const Double_t *x, const Double_t *params)
    return fF2->EvalPar(xx,params);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate this function at n points, see TF12::EvalPar.
+
+void TF12::EvalParBatch(const Double_t *x, size_t n, size_t stride, const Double_t *params, Double_t *out)
+{
+   for (size_t i = 0; i < n; ++i)
+      out[i] = EvalPar(x + i * stride, params);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Save primitive as a C++ statement(s) on output stream out
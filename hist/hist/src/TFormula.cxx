@@ -212,6 +212,18 @@ static const TString gNamePrefix = "TFormula__";
 //static std::unordered_map<std::string,  TInterpreter::CallFuncIFacePtr_t::Generic_t> gClingFunctions = std::unordered_map<TString,  TInterpreter::CallFuncIFacePtr_t::Generic_t>();
 static std::unordered_map<std::string,  void *> gClingFunctions = std::unordered_map<std::string,  void * >();
 
+// code of the formulas created while the compilation is deferred, keyed like gClingFunctions
+// (see TFormula::SetDeferredCompilation)
+struct TFormulaPendingCode {
+   TString fClingName;
+   TString fClingInput;
+   bool fHasParameters;
+   bool fHasVariables;
+   bool fVectorized;
+};
+static std::unordered_map<std::string, TFormulaPendingCode> gPendingFormulas;
+static std::atomic<bool> gDeferredCompilation{false};
+
 static void R__v5TFormulaUpdater(Int_t nobjects, TObject **from, TObject **to)
 {
    auto **fromv5 = (ROOT::v5::TFormula **)from;
@@ -704,6 +716,7 @@ void TFormula::Copy(TObject &obj) const
    fnew.fGradMethod.reset(gm);
 
    fnew.fFuncPtr = fFuncPtr;
+   fnew.fBatchFuncPtr = fBatchFuncPtr.load();
    fnew.fGradGenerationInput = fGradGenerationInput;
    fnew.fGradFuncPtr = fGradFuncPtr;
 
@@ -723,6 +736,7 @@ void TFormula::Clear(Option_t * )
 
    fMethod.reset();
    fGradMethod.reset();
+   fBatchFuncPtr = nullptr;
 
    fClingVariables.clear();
    fClingParameters.clear();
@@ -817,6 +831,127 @@ bool TFormula::PrepareEvalMethod()
    return fFuncPtr;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Defer the compilation of the formulas created from now on.
+///
+/// Creating a formula normally compiles its expression with Cling right away,
+/// which dominates the time needed to create many functions. When the
+/// compilation is deferred, the formulas are still parsed when created but
+/// their code is only compiled when one of them is first evaluated, in a single
+/// Cling transaction for all the pending formulas (see CompilePendingFormulas()).
+/// Identical expressions are compiled once.
+///
+/// Note that the errors in an expression are then only reported when the
+/// formulas are compiled.
+
+void TFormula::SetDeferredCompilation(Bool_t on)
+{
+   gDeferredCompilation = on;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return whether the compilation of the new formulas is deferred.
+
+Bool_t TFormula::IsDeferredCompilation()
+{
+   return gDeferredCompilation;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Code of a function calling the compiled formula with the generic signature of
+/// the interpreter function pointers (TInterpreter::CallFuncIFacePtr_t::Generic_t),
+/// i.e. the function used by DoEval() and DoEvalVec().
+
+static TString genericWrapperCode(const TFormulaPendingCode &pendingCode)
+{
+   const char *argType = pendingCode.fVectorized ? "ROOT::Double_v" : "Double_t";
+   TString call;
+   if (pendingCode.fHasParameters)
+      call = TString::Format("%s(*(%s **)args[0], *(Double_t **)args[1])", pendingCode.fClingName.Data(), argType);
+   else if (pendingCode.fHasVariables)
+      call = TString::Format("%s(*(%s **)args[0])", pendingCode.fClingName.Data(), argType);
+   else
+      call = TString::Format("%s()", pendingCode.fClingName.Data());
+   return TString::Format("void %s_generic(void *, int, void **args, void *ret) { *(%s *)ret = %s; }",
+                          pendingCode.fClingName.Data(), argType, call.Data());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compile the code of all the formulas created while the compilation was
+/// deferred. Returns the number of expressions compiled successfully.
+///
+/// The expressions are declared to Cling together, with a function returning
+/// the pointers to all of them at once; if this fails because one of them is
+/// invalid, they are declared one by one instead.
+
+Int_t TFormula::CompilePendingFormulas()
+{
+   R__LOCKGUARD(gROOTMutex);
+   if (gPendingFormulas.empty())
+      return 0;
+   std::unordered_map<std::string, TFormulaPendingCode> pending;
+   pending.swap(gPendingFormulas);
+
+   // make sure the interpreter is initialized
+   ROOT::GetROOT();
+   R__ASSERT(gCling);
+
+   // the formulas created meanwhile with the compilation not deferred are already compiled
+   std::vector<std::pair<const std::string, TFormulaPendingCode> *> toCompile;
+   for (auto &entry : pending) {
+      if (gClingFunctions.find(entry.first) == gClingFunctions.end())
+         toCompile.push_back(&entry);
+   }
+   if (toCompile.empty())
+      return 0;
+
+   // Trigger autoloading / autoparsing (ROOT-9840), see InputFormulaIntoCling
+   static Long64_t nBatches = 0;
+   const TString fillName = TString::Format("%s_pending%lld", gNamePrefix.Data(), nBatches++);
+   TString triggerAutoparsing = "namespace ROOT_TFormula_triggerAutoParse {\n";
+   TString code = "#pragma cling optimize(2)\n";
+   TString fillCode = "void " + fillName + "(void **table) {\n";
+   for (std::size_t i = 0; i < toCompile.size(); ++i) {
+      const TFormulaPendingCode &pendingCode = toCompile[i]->second;
+      triggerAutoparsing += pendingCode.fClingInput + "\n";
+      code += pendingCode.fClingInput + "\n" + genericWrapperCode(pendingCode) + "\n";
+      fillCode += TString::Format("   table[%zu] = (void *)&%s_generic;\n", i, pendingCode.fClingName.Data());
+   }
+   triggerAutoparsing += "}";
+   fillCode += "}";
+   gCling->ProcessLine(triggerAutoparsing);
+
+   std::vector<void *> table(toCompile.size(), nullptr);
+   const bool declared = gCling->Declare(code + fillCode);
+   if (declared) {
+      TMethodCall method;
+      method.InitWithPrototype(fillName, "void**");
+      if (auto fillPtr = method.IsValid() ? prepareFuncPtr(&method) : nullptr) {
+         void **tablePtr = table.data();
+         void *args[1] = {&tablePtr};
+         (*fillPtr)(nullptr, 1, args, nullptr);
+      }
+   }
+
+   Int_t ncompiled = 0;
+   for (std::size_t i = 0; i < toCompile.size(); ++i) {
+      const TFormulaPendingCode &pendingCode = toCompile[i]->second;
+      void *funcPtr = table[i];
+      if (!declared) {
+         if (!gCling->Declare(TString("#pragma cling optimize(2)\n") + pendingCode.fClingInput))
+            continue;
+         auto method = prepareMethod(pendingCode.fHasParameters, pendingCode.fHasVariables, pendingCode.fClingName,
+                                     pendingCode.fVectorized);
+         funcPtr = (void *)prepareFuncPtr(method.get());
+      }
+      if (funcPtr) {
+         gClingFunctions.insert(std::make_pair(toCompile[i]->first, funcPtr));
+         ++ncompiled;
+      }
+   }
+   return ncompiled;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///    Inputs formula, transfered to C++ code into Cling
 
@@ -2294,6 +2429,7 @@ void TFormula::ProcessFormula(TString &formula)
          // set the cling name using hash of the static formulae map
          auto hasher = gClingFunctions.hash_function();
          fClingName = TString::Format("%s__id%zu", gNamePrefix.Data(), hasher(inputFormulaVecFlag));
+         fBatchFuncPtr = nullptr;
 
          fClingInput = TString::Format("%s %s(%s){ return %s ; }", argType.Data(), fClingName.Data(),
                                        argumentsPrototype.Data(), inputFormula.c_str());
@@ -2316,6 +2452,14 @@ void TFormula::ProcessFormula(TString &formula)
          // }
 
          if (inputIntoCling) {
+            if (!fLazyInitialization && gDeferredCompilation) {
+               // compile it later, together with the other pending formulas; identical expressions are
+               // compiled only once
+               R__LOCKGUARD(gROOTMutex);
+               gPendingFormulas.emplace(inputFormulaVecFlag, TFormulaPendingCode{fClingName, fClingInput, hasParameters,
+                                                                                 hasVariables, fVectorized});
+               fLazyInitialization = true;
+            }
             if (!fLazyInitialization) {
                InputFormulaIntoCling();
                if (fClingInitialized) {
@@ -3129,6 +3273,95 @@ Double_t TFormula::EvalPar(const Double_t *x,const Double_t *params) const
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula at n points, storing the results in out.
+///
+/// The coordinates of point i start at x[i * stride]; stride is usually the
+/// number of dimensions. The same parameters are used for all the points; if
+/// params is nullptr, the parameters stored in the formula are used.
+///
+/// The formula is compiled a second time as a loop over the points, which
+/// avoids a call through the interpreter for each point and lets the compiler
+/// vectorize the loop. Lambda expressions and vectorized formulas are evaluated
+/// point by point instead.
+
+void TFormula::EvalParBatch(const Double_t *x, size_t n, size_t stride, const Double_t *params, Double_t *out) const
+{
+   if (n == 0)
+      return;
+   CallFuncSignature batchFuncPtr = PrepareBatchEvalMethod();
+   if (!batchFuncPtr) {
+      for (size_t i = 0; i < n; ++i)
+         out[i] = EvalPar(x ? x + i * stride : nullptr, params);
+      return;
+   }
+
+   // __attribute__((used)) extern "C" void __cf_0(void* obj, int nargs, void** args, void* ret)
+   // {
+   //    ((void (&)(double*, double*, double*, Long64_t, Long64_t))TFormula____id_batch)(*(double**)args[0],
+   //       *(double**)args[1], *(double**)args[2], *(Long64_t*)args[3], *(Long64_t*)args[4]);
+   //    return;
+   // }
+   double *vars = x ? const_cast<double *>(x) : const_cast<double *>(fClingVariables.data());
+   double *pars = params ? const_cast<double *>(params) : const_cast<double *>(fClingParameters.data());
+   Long64_t npoints = n;
+   Long64_t step = x ? stride : 0;
+   void *args[5] = {&vars, &pars, &out, &npoints, &step};
+   (*batchFuncPtr)(0, 5, args, /*ret*/ nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compile the function used by EvalParBatch(), a loop over the points around
+/// the expression of the formula. Functions already compiled for an identical
+/// formula are reused. Returns nullptr if the formula cannot be evaluated that
+/// way, e.g. if it is not initialized yet.
+
+TFormula::CallFuncSignature TFormula::PrepareBatchEvalMethod() const
+{
+   if (CallFuncSignature ptr = fBatchFuncPtr)
+      return ptr;
+   if (!fReadyToExecute || !fClingInitialized || fVectorized || TestBit(TFormula::kLambda))
+      return nullptr;
+
+   R__LOCKGUARD(gROOTMutex);
+   const std::string batchName = std::string(fClingName.Data()) + "_batch";
+   auto funcit = gClingFunctions.find(batchName);
+   if (funcit != gClingFunctions.end()) {
+      fBatchFuncPtr = (CallFuncSignature)funcit->second;
+      return fBatchFuncPtr;
+   }
+
+   // fClingInput is "[#pragma ...] Double_t name(args){ return <expression> ; }"
+   void *ptr = nullptr;
+   const Ssiz_t begin = fClingInput.Index("{ return ");
+   const Ssiz_t end = fClingInput.Last(';');
+   if (begin != kNPOS && end > begin) {
+      TString expression = fClingInput(begin + 9, end - begin - 9);
+      TString code = TString::Format("#pragma cling optimize(2)\n"
+                                     "void %s(Double_t *xs, Double_t *p, Double_t *out, Long64_t n, Long64_t stride) {\n"
+                                     "   for (Long64_t i = 0; i < n; ++i) {\n"
+                                     "      Double_t *x = xs + i * stride;\n"
+                                     "      out[i] = %s;\n"
+                                     "   }\n"
+                                     "}",
+                                     batchName.c_str(), expression.Data());
+      if (gInterpreter->Declare(code)) {
+         TMethodCall method;
+         method.InitWithPrototype(batchName.c_str(), "Double_t*,Double_t*,Double_t*,Long64_t,Long64_t");
+         if (method.IsValid())
+            ptr = (void *)prepareFuncPtr(&method);
+      }
+   }
+   if (!ptr)
+      Warning("EvalParBatch", "Cannot compile a loop for the formula %s, it is evaluated point by point",
+              GetExpFormula().Data());
+
+   // Also remember failures, in order not to compile the loop again.
+   gClingFunctions.insert(std::make_pair(batchName, ptr));
+   fBatchFuncPtr = (CallFuncSignature)ptr;
+   return fBatchFuncPtr;
+}
+
 bool TFormula::fIsCladRuntimeIncluded = false;
 
 static bool functionExists(const string &Name) {
@@ -3436,6 +3669,9 @@ void TFormula::ReInitializeEvalMethod() {
    if (!fLazyInitialization)   Warning("ReInitializeEvalMethod", "Formula is NOT properly initialized - try calling again TFormula::PrepareEvalMethod");
    //else  Info("ReInitializeEvalMethod", "Compile now the formula expression using Cling");
 
+   // compile the formulas whose compilation was deferred, including this one
+   CompilePendingFormulas();
+
    // check first if formula exists in the global map
    {
 
@@ -51,6 +51,7 @@
 #include "Math/QuantFuncMathCore.h"
 
 #include "TH1Merger.h"
+#include "HistFillN.h"
 
 /** \addtogroup Hist
 @{
@@ -3470,9 +3471,17 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
    DoFillN(ntimes, x, w, stride);
 }
 
+using ROOT::Internal::kFillNChunk;
+using ROOT::Internal::kFillNLanes;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Internal method to fill histogram content from a vector
 /// called directly by TH1::BufferEmpty
+///
+/// The bins of the entries are looked up by chunks with TAxis::FindFixBins and
+/// the statistics are accumulated in independent partial sums, which lets the
+/// compiler vectorize both loops. The statistics can therefore differ from the
+/// ones of successive calls to Fill by rounding errors.
 
 void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
 {
@@ -3481,22 +3490,75 @@ void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stri
    fEntries += ntimes;
    Double_t ww = 1;
    Int_t nbins   = fXaxis.GetNbins();
-   ntimes *= stride;
-   for (i=0;i<ntimes;i+=stride) {
-      bin =fXaxis.FindBin(x[i]);
-      if (bin <0) continue;
-      if (w) ww = w[i];
-      if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
-      if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
-      AddBinContent(bin, ww);
-      if (bin == 0 || bin > nbins) {
-         if (!GetStatOverflowsBehaviour()) continue;
-      }
-      Double_t z= ww;
-      fTsumw   += z;
-      fTsumw2  += z*z;
-      fTsumwx  += z*x[i];
-      fTsumwx2 += z*x[i]*x[i];
+
+   // an axis which can be extended may change at each entry
+   if (fXaxis.CanExtend() && !fXaxis.IsAlphanumeric()) {
+      ntimes *= stride;
+      for (i=0;i<ntimes;i+=stride) {
+         bin =fXaxis.FindBin(x[i]);
+         if (bin <0) continue;
+         if (w) ww = w[i];
+         if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin, ww);
+         if (bin == 0 || bin > nbins) {
+            if (!GetStatOverflowsBehaviour()) continue;
+         }
+         Double_t z= ww;
+         fTsumw   += z;
+         fTsumw2  += z*z;
+         fTsumwx  += z*x[i];
+         fTsumwx2 += z*x[i]*x[i];
+      }
+      return;
+   }
+
+   // Sumw2 must be called before filling the first weight different from 1
+   if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i=0;i<ntimes;i++) {
+         if (w[(Long64_t)i*stride] != 1.0) {
+            Sumw2();
+            break;
+         }
+      }
+   }
+
+   const Bool_t statOverflows = GetStatOverflowsBehaviour();
+   Int_t bins[kFillNChunk];
+   Double_t zw[kFillNChunk], zx[kFillNChunk];
+   Double_t sumw[kFillNLanes] = {}, sumw2[kFillNLanes] = {}, sumwx[kFillNLanes] = {}, sumwx2[kFillNLanes] = {};
+   for (Int_t first = 0; first < ntimes; first += kFillNChunk) {
+      const Int_t n = TMath::Min(kFillNChunk, ntimes - first);
+      const Double_t *xc = x + (Long64_t)first*stride;
+      const Double_t *wc = w ? w + (Long64_t)first*stride : nullptr;
+      fXaxis.FindFixBins(n, xc, bins, stride);
+      for (i=0;i<n;i++) {
+         if (wc) ww = wc[(Long64_t)i*stride];
+         if (fSumw2.fN) fSumw2.fArray[bins[i]] += ww*ww;
+         AddBinContent(bins[i], ww);
+         // entries in the underflow and overflow bins do not contribute to the statistics
+         const Bool_t inStats = statOverflows || (bins[i] > 0 && bins[i] <= nbins);
+         zw[i] = inStats ? ww : 0.;
+         zx[i] = inStats ? xc[(Long64_t)i*stride] : 0.;
+      }
+      const Int_t nlanes = (n + kFillNLanes - 1) / kFillNLanes * kFillNLanes;
+      for (i=n;i<nlanes;i++) zw[i] = zx[i] = 0.;
+      for (i=0;i<nlanes;i+=kFillNLanes) {
+         for (Int_t l=0;l<kFillNLanes;l++) {
+            const Double_t z = zw[i+l];
+            const Double_t zxl = z*zx[i+l];
+            sumw[l]   += z;
+            sumw2[l]  += z*z;
+            sumwx[l]  += zxl;
+            sumwx2[l] += zxl*zx[i+l];
+         }
+      }
+   }
+   for (Int_t l=0;l<kFillNLanes;l++) {
+      fTsumw   += sumw[l];
+      fTsumw2  += sumw2[l];
+      fTsumwx  += sumwx[l];
+      fTsumwx2 += sumwx2[l];
    }
 }
 
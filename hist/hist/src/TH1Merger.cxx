@@ -8,9 +8,11 @@
 #include "TError.h"
 #include "THashList.h"
 #include "TClass.h"
+#include "HistAddKernels.h"
 #include <iostream>
 #include <limits>
 #include <utility>
+#include <vector>
 
 #define PRINTRANGE(a, b, bn)                                                                                          \
    Printf(" base: %f %f %d, %s: %f %f %d", a->GetXmin(), a->GetXmax(), a->GetNbins(), bn, b->GetXmin(), b->GetXmax(), \
@@ -23,6 +25,52 @@ Bool_t TH1Merger::AxesHaveLimits(const TH1 * h) {
    return hasLimits;
 }
 
+namespace {
+
+/// Add the bins [first, last) of 'from' to those of 'to', both storing their
+/// content in a floating point ARRAY.
+template <class ARRAY>
+void AddContent(TH1 *to, const TH1 *from, Int_t first, Int_t last)
+{
+   ROOT::Internal::AddBinArrays(dynamic_cast<ARRAY *>(to)->fArray + first,
+                                dynamic_cast<const ARRAY *>(from)->fArray + first, last - first);
+}
+
+/// Add the bins [first, last) of 'from' to those of 'to', both storing their
+/// content in an integer ARRAY, saturating like AddBinContent().
+template <class ARRAY>
+void AddSaturatedContent(TH1 *to, const TH1 *from, Int_t first, Int_t last)
+{
+   ROOT::Internal::AddBinArraysSaturated(dynamic_cast<ARRAY *>(to)->fArray + first,
+                                         dynamic_cast<const ARRAY *>(from)->fArray + first, last - first);
+}
+
+/// Add the content of the bins [first, last) of 'from' to 'sumw2', for a
+/// histogram without sum of squares of weights.
+template <class ARRAY>
+void AddContentToSumw2(Double_t *sumw2, const TH1 *from, Int_t first, Int_t last)
+{
+   ROOT::Internal::AddBinArrays(sumw2 + first, dynamic_cast<const ARRAY *>(from)->fArray + first, last - first);
+}
+
+} // anonymous namespace
+
+/// Find the type of the bin content array of the histogram classes whose
+/// AddBinContent() is a plain (possibly saturating) addition.
+TH1Merger::EBinStorage TH1Merger::GetBinStorage(const TClass *classType) {
+   if (classType == TH1D::Class() || classType == TH2D::Class() || classType == TH3D::Class())
+      return kDoubleStorage;
+   if (classType == TH1F::Class() || classType == TH2F::Class() || classType == TH3F::Class())
+      return kFloatStorage;
+   if (classType == TH1I::Class() || classType == TH2I::Class() || classType == TH3I::Class())
+      return kIntStorage;
+   if (classType == TH1S::Class() || classType == TH2S::Class() || classType == TH3S::Class())
+      return kShortStorage;
+   if (classType == TH1C::Class() || classType == TH2C::Class() || classType == TH3C::Class())
+      return kCharStorage;
+   return kOtherStorage;
+}
+
 /// Function performing the actual merge
 Bool_t TH1Merger::operator() () {
 
@@ -793,6 +841,8 @@ Bool_t TH1Merger::SameAxesMerge() {
    fH0->GetStats(totstats);
    Double_t nentries = fH0->GetEntries();
 
+   std::vector<const TH1 *> inputs;
+   Bool_t sameClass = fIsProfileMerge || fBinStorage != kOtherStorage;
    TIter next(&fInputList);
    while (TH1* hist=(TH1*)next()) {
       // process only if the histogram has limits; otherwise it was processed before
@@ -810,10 +860,25 @@ Bool_t TH1Merger::SameAxesMerge() {
          totstats[i] += stats[i];
       nentries += hist->GetEntries();
 
-         //Int_t nx = hist->GetXaxis()->GetNbins();
+      inputs.push_back(hist);
+      sameClass &= hist->IsA() == fH0->IsA();
+   }
+
+   // The axes were checked for all inputs by ExamineHistograms(). If the inputs
+   // have the class of fH0, add their bin arrays directly; ranges of bins are
+   // merged over all inputs in turn, in parallel if implicit MT is enabled.
+   if (sameClass) {
+      const Long64_t ncells = fH0->fNcells;
+      ROOT::Internal::ForEachBinRange(ncells, ncells * (Long64_t)inputs.size(), [&](Long64_t first, Long64_t last) {
+         for (const TH1 *hist : inputs)
+            MergeBins(hist, first, last);
+      });
+   } else {
+      for (const TH1 *hist : inputs) {
          // loop on bins of the histogram and do the merge
-      for (Int_t ibin = 0; ibin < hist->fNcells; ibin++) {
-         MergeBin(hist, ibin, ibin);
+         for (Int_t ibin = 0; ibin < hist->fNcells; ibin++) {
+            MergeBin(hist, ibin, ibin);
+         }
       }
    }
    //copy merged stats
@@ -1152,6 +1217,63 @@ void TH1Merger::MergeBin(const TH1 *hist, Int_t ibin, Int_t cbin)
    return;
 }
 
+// merge the bins [first, last) of hist, which has the same axes and class as this histogram
+void TH1Merger::MergeBins(const TH1 *hist, Int_t first, Int_t last)
+{
+   if (fIsProfile1D)
+      return MergeProfileBins(static_cast<const TProfile *>(hist), first, last);
+   if (fIsProfile2D)
+      return MergeProfileBins(static_cast<const TProfile2D *>(hist), first, last);
+   if (fIsProfile3D)
+      return MergeProfileBins(static_cast<const TProfile3D *>(hist), first, last);
+
+   // the sum of squares of weights needs the content of hist before it is added
+   if (fH0->fSumw2.fN) {
+      Double_t *sumw2 = fH0->fSumw2.fArray;
+      if (hist->fSumw2.fN)
+         ROOT::Internal::AddBinArrays(sumw2 + first, hist->fSumw2.fArray + first, last - first);
+      else if (fBinStorage == kDoubleStorage)
+         AddContentToSumw2<TArrayD>(sumw2, hist, first, last);
+      else if (fBinStorage == kFloatStorage)
+         AddContentToSumw2<TArrayF>(sumw2, hist, first, last);
+      else if (fBinStorage == kIntStorage)
+         AddContentToSumw2<TArrayI>(sumw2, hist, first, last);
+      else if (fBinStorage == kShortStorage)
+         AddContentToSumw2<TArrayS>(sumw2, hist, first, last);
+      else if (fBinStorage == kCharStorage)
+         AddContentToSumw2<TArrayC>(sumw2, hist, first, last);
+   }
+
+   switch (fBinStorage) {
+   case kDoubleStorage: AddContent<TArrayD>(fH0, hist, first, last); break;
+   case kFloatStorage: AddContent<TArrayF>(fH0, hist, first, last); break;
+   case kIntStorage: AddSaturatedContent<TArrayI>(fH0, hist, first, last); break;
+   case kShortStorage: AddSaturatedContent<TArrayS>(fH0, hist, first, last); break;
+   case kCharStorage: AddSaturatedContent<TArrayC>(fH0, hist, first, last); break;
+   default:
+      for (Int_t ibin = first; ibin < last; ++ibin)
+         MergeBin(hist, ibin, ibin);
+   }
+}
+
+// merge the bins [first, last) of profile h into the same bins of this profile
+template<class TProfileType>
+void TH1Merger::MergeProfileBins(const TProfileType *h, Int_t first, Int_t last)
+{
+   using ROOT::Internal::AddBinArrays;
+   TProfileType *p = static_cast<TProfileType *>(fH0);
+   const Int_t n = last - first;
+   AddBinArrays(p->fArray + first, h->fArray + first, n);
+   AddBinArrays(p->fSumw2.fArray + first, h->fSumw2.fArray + first, n);
+   AddBinArrays(p->fBinEntries.fArray + first, h->fBinEntries.fArray + first, n);
+   if (p->fBinSumw2.fN) {
+      if (h->fBinSumw2.fN)
+         AddBinArrays(p->fBinSumw2.fArray + first, h->fBinSumw2.fArray + first, n);
+      else
+         AddBinArrays(p->fBinSumw2.fArray + first, h->fArray + first, n);
+   }
+}
+
 // merge profile input bin (ibin) of histograms hist ibin into current bin cbin of this histogram
 template<class TProfileType>
 void TH1Merger::MergeProfileBin(const TProfileType *h, Int_t hbin, Int_t pbin)
@@ -30,6 +30,18 @@ public:
       kAutoP2NeedLimits = 5  // P2 algorithm: some histogram still need projections
    };
 
+   // Type of the bin content array of the histogram classes whose bins can be added array-wise
+   enum EBinStorage {
+      kOtherStorage = 0, // bins are added through AddBinContent
+      kCharStorage,
+      kShortStorage,
+      kIntStorage,
+      kFloatStorage,
+      kDoubleStorage
+   };
+
+   static EBinStorage GetBinStorage(const TClass *classType);
+
    static Bool_t AxesHaveLimits(const TH1 * h);
 
    static Int_t FindFixBinNumber(Int_t ibin, const TAxis & inAxis, const TAxis & outAxis) {
@@ -85,6 +97,7 @@ public:
          fIsProfileMerge = kTRUE;
          fIsProfile3D = kTRUE;
       }
+      fBinStorage = GetBinStorage(classType);
    }
 
    ~TH1Merger() {
@@ -125,6 +138,12 @@ private:
    // function doing the bin merge for histograms and profiles
    void MergeBin(const TH1 *hist, Int_t inbin, Int_t outbin);
 
+   template <class TProfileType>
+   void MergeProfileBins(const TProfileType *p, Int_t first, Int_t last);
+
+   // function adding the bins [first, last) of a histogram with the same axes and class
+   void MergeBins(const TH1 *hist, Int_t first, Int_t last);
+
    void MergeBin(const TProfile *hist, Int_t inbin, Int_t outbin) { MergeProfileBin<TProfile>(hist, inbin, outbin); }
    void MergeBin(const TProfile2D *hist, Int_t inbin, Int_t outbin) { MergeProfileBin<TProfile2D>(hist, inbin, outbin); }
    void MergeBin(const TProfile3D *hist, Int_t inbin, Int_t outbin) { MergeProfileBin<TProfile3D>(hist, inbin, outbin); }
@@ -135,6 +154,7 @@ private:
    Bool_t fIsProfile1D = kFALSE;
    Bool_t fIsProfile2D = kFALSE;
    Bool_t fIsProfile3D = kFALSE;
+   EBinStorage fBinStorage = kOtherStorage; // bin content type of fH0's class
    TH1 *fH0;                      //! histogram on which the list is merged
    TH1 *fHClone;                  //! copy of fH0 - managed by this class
    TList fInputList;              // input histogram List
@@ -28,6 +28,8 @@
 #include "TVirtualHistPainter.h"
 #include "snprintf.h"
 
+#include "HistFillN.h"
+
 ClassImp(TH2);
 
 /** \addtogroup Hist
@@ -526,6 +528,9 @@ Int_t TH2::Fill(Double_t x, const char *namey, Double_t w)
 }
 
 
+using ROOT::Internal::kFillNChunk;
+using ROOT::Internal::kFillNLanes;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill a 2-D histogram with an array of values and weights.
 ///
@@ -564,30 +569,102 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
    }
 
    Double_t ww = 1;
-   for (i=ifirst;i<ntimes;i+=stride) {
-      fEntries++;
-      binx = fXaxis.FindBin(x[i]);
-      biny = fYaxis.FindBin(y[i]);
-      if (binx <0 || biny <0) continue;
-      bin  = biny*(fXaxis.GetNbins()+2) + binx;
-      if (w) ww = w[i];
-      if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
-      if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
-      AddBinContent(bin,ww);
-      if (binx == 0 || binx > fXaxis.GetNbins()) {
-         if (!GetStatOverflowsBehaviour()) continue;
+   Int_t nbinsx = fXaxis.GetNbins();
+   Int_t nbinsy = fYaxis.GetNbins();
+
+   // an axis which can be extended may change at each entry
+   if ((fXaxis.CanExtend() && !fXaxis.IsAlphanumeric()) || (fYaxis.CanExtend() && !fYaxis.IsAlphanumeric())) {
+      for (i=ifirst;i<ntimes;i+=stride) {
+         fEntries++;
+         binx = fXaxis.FindBin(x[i]);
+         biny = fYaxis.FindBin(y[i]);
+         if (binx <0 || biny <0) continue;
+         bin  = biny*(fXaxis.GetNbins()+2) + binx;
+         if (w) ww = w[i];
+         if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
+         if (binx == 0 || binx > fXaxis.GetNbins()) {
+            if (!GetStatOverflowsBehaviour()) continue;
+         }
+         if (biny == 0 || biny > fYaxis.GetNbins()) {
+            if (!GetStatOverflowsBehaviour()) continue;
+         }
+         Double_t z= ww; //(ww > 0 ? ww : -ww);
+         fTsumw   += z;
+         fTsumw2  += z*z;
+         fTsumwx  += z*x[i];
+         fTsumwx2 += z*x[i]*x[i];
+         fTsumwy  += z*y[i];
+         fTsumwy2 += z*y[i]*y[i];
+         fTsumwxy += z*x[i]*y[i];
       }
-      if (biny == 0 || biny > fYaxis.GetNbins()) {
-         if (!GetStatOverflowsBehaviour()) continue;
+      return;
+   }
+
+   // look the bins up by chunks and accumulate the statistics in partial sums,
+   // see TH1::DoFillN
+   x += ifirst;
+   y += ifirst;
+   if (w) w += ifirst;
+   ntimes = (ntimes - ifirst) / stride;
+   fEntries += ntimes;
+
+   // Sumw2 must be called before filling the first weight different from 1
+   if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i=0;i<ntimes;i++) {
+         if (w[(Long64_t)i*stride] != 1.0) {
+            Sumw2();
+            break;
+         }
       }
-      Double_t z= ww; //(ww > 0 ? ww : -ww);
-      fTsumw   += z;
-      fTsumw2  += z*z;
-      fTsumwx  += z*x[i];
-      fTsumwx2 += z*x[i]*x[i];
-      fTsumwy  += z*y[i];
-      fTsumwy2 += z*y[i]*y[i];
-      fTsumwxy += z*x[i]*y[i];
+   }
+
+   const Bool_t statOverflows = GetStatOverflowsBehaviour();
+   Int_t binsx[kFillNChunk], binsy[kFillNChunk];
+   Double_t zw[kFillNChunk], zx[kFillNChunk], zy[kFillNChunk];
+   Double_t sums[7][kFillNLanes] = {};
+   for (Int_t first = 0; first < ntimes; first += kFillNChunk) {
+      const Int_t n = TMath::Min(kFillNChunk, ntimes - first);
+      const Long64_t offset = (Long64_t)first*stride;
+      const Double_t *wc = w ? w + offset : nullptr;
+      fXaxis.FindFixBins(n, x + offset, binsx, stride);
+      fYaxis.FindFixBins(n, y + offset, binsy, stride);
+      for (i=0;i<n;i++) {
+         if (wc) ww = wc[(Long64_t)i*stride];
+         bin  = binsy[i]*(nbinsx+2) + binsx[i];
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
+         const Bool_t inStats = statOverflows || (binsx[i] > 0 && binsx[i] <= nbinsx && binsy[i] > 0 && binsy[i] <= nbinsy);
+         zw[i] = inStats ? ww : 0.;
+         zx[i] = inStats ? x[offset + (Long64_t)i*stride] : 0.;
+         zy[i] = inStats ? y[offset + (Long64_t)i*stride] : 0.;
+      }
+      const Int_t nlanes = (n + kFillNLanes - 1) / kFillNLanes * kFillNLanes;
+      for (i=n;i<nlanes;i++) zw[i] = zx[i] = zy[i] = 0.;
+      for (i=0;i<nlanes;i+=kFillNLanes) {
+         for (Int_t l=0;l<kFillNLanes;l++) {
+            const Double_t z = zw[i+l];
+            const Double_t zxl = z*zx[i+l];
+            const Double_t zyl = z*zy[i+l];
+            sums[0][l] += z;
+            sums[1][l] += z*z;
+            sums[2][l] += zxl;
+            sums[3][l] += zxl*zx[i+l];
+            sums[4][l] += zyl;
+            sums[5][l] += zyl*zy[i+l];
+            sums[6][l] += zxl*zy[i+l];
+         }
+      }
+   }
+   for (Int_t l=0;l<kFillNLanes;l++) {
+      fTsumw   += sums[0][l];
+      fTsumw2  += sums[1][l];
+      fTsumwx  += sums[2][l];
+      fTsumwx2 += sums[3][l];
+      fTsumwy  += sums[4][l];
+      fTsumwy2 += sums[5][l];
+      fTsumwxy += sums[6][l];
    }
 }
 
@@ -25,6 +25,8 @@
 #include "TMath.h"
 #include "TObjString.h"
 
+#include "HistFillN.h"
+
 ClassImp(TH3);
 
 /** \addtogroup Hist
@@ -383,6 +385,143 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
 }
 
 
+using ROOT::Internal::kFillNChunk;
+using ROOT::Internal::kFillNLanes;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 3-D histogram with an array of values and weights.
+///
+///  - ntimes:  number of entries in arrays x, y, z and w (array size must be ntimes*stride)
+///  - x:       array of x values to be histogrammed
+///  - y:       array of y values to be histogrammed
+///  - z:       array of z values to be histogrammed
+///  - w:       array of weights
+///  - stride:  step size through arrays x, y, z and w
+///
+///   - If the weight is not equal to 1, the storage of the sum of squares of
+///     weights is automatically triggered and the sum of the squares of weights is incremented
+///     by w[i]^2 in the bin corresponding to x[i],y[i],z[i].
+///   - If w is NULL each entry is assumed a weight=1
+///
+/// The bins of the entries are looked up by chunks and the statistics are accumulated
+/// in partial sums, see TH1::DoFillN.
+///
+/// NB: function only valid for a TH3x object
+
+void TH3::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   Int_t binx, biny, binz, bin, i;
+   ntimes *= stride;
+   Int_t ifirst = 0;
+
+   //If a buffer is activated, fill buffer
+   if (fBuffer) {
+      for (i=0;i<ntimes;i+=stride) {
+         if (!fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         if (w) BufferFill(x[i],y[i],z[i],w[i]);
+         else BufferFill(x[i], y[i], z[i], 1.);
+      }
+      // fill the remaining entries if the buffer has been deleted
+      if (i < ntimes && fBuffer==0)
+         ifirst = i;
+      else
+         return;
+   }
+
+   // an axis which can be extended may change at each entry
+   if ((fXaxis.CanExtend() && !fXaxis.IsAlphanumeric()) || (fYaxis.CanExtend() && !fYaxis.IsAlphanumeric()) ||
+       (fZaxis.CanExtend() && !fZaxis.IsAlphanumeric())) {
+      for (i=ifirst;i<ntimes;i+=stride)
+         Fill(x[i], y[i], z[i], w ? w[i] : 1.);
+      return;
+   }
+
+   Double_t ww = 1;
+   Int_t nbinsx = fXaxis.GetNbins();
+   Int_t nbinsy = fYaxis.GetNbins();
+   Int_t nbinsz = fZaxis.GetNbins();
+   x += ifirst;
+   y += ifirst;
+   z += ifirst;
+   if (w) w += ifirst;
+   ntimes = (ntimes - ifirst) / stride;
+   fEntries += ntimes;
+
+   // Sumw2 must be called before filling the first weight different from 1
+   if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i=0;i<ntimes;i++) {
+         if (w[(Long64_t)i*stride] != 1.0) {
+            Sumw2();
+            break;
+         }
+      }
+   }
+
+   const Bool_t statOverflows = GetStatOverflowsBehaviour();
+   Int_t binsx[kFillNChunk], binsy[kFillNChunk], binsz[kFillNChunk];
+   Double_t zw[kFillNChunk], zx[kFillNChunk], zy[kFillNChunk], zz[kFillNChunk];
+   Double_t sums[11][kFillNLanes] = {};
+   for (Int_t first = 0; first < ntimes; first += kFillNChunk) {
+      const Int_t n = TMath::Min(kFillNChunk, ntimes - first);
+      const Long64_t offset = (Long64_t)first*stride;
+      const Double_t *wc = w ? w + offset : nullptr;
+      fXaxis.FindFixBins(n, x + offset, binsx, stride);
+      fYaxis.FindFixBins(n, y + offset, binsy, stride);
+      fZaxis.FindFixBins(n, z + offset, binsz, stride);
+      for (i=0;i<n;i++) {
+         binx = binsx[i];
+         biny = binsy[i];
+         binz = binsz[i];
+         if (wc) ww = wc[(Long64_t)i*stride];
+         bin  = binx + (nbinsx+2)*(biny + (nbinsy+2)*binz);
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
+         const Bool_t inStats = statOverflows || (binx > 0 && binx <= nbinsx && biny > 0 && biny <= nbinsy &&
+                                                  binz > 0 && binz <= nbinsz);
+         const Long64_t j = offset + (Long64_t)i*stride;
+         zw[i] = inStats ? ww : 0.;
+         zx[i] = inStats ? x[j] : 0.;
+         zy[i] = inStats ? y[j] : 0.;
+         zz[i] = inStats ? z[j] : 0.;
+      }
+      const Int_t nlanes = (n + kFillNLanes - 1) / kFillNLanes * kFillNLanes;
+      for (i=n;i<nlanes;i++) zw[i] = zx[i] = zy[i] = zz[i] = 0.;
+      for (i=0;i<nlanes;i+=kFillNLanes) {
+         for (Int_t l=0;l<kFillNLanes;l++) {
+            const Double_t wl = zw[i+l];
+            const Double_t wxl = wl*zx[i+l];
+            const Double_t wyl = wl*zy[i+l];
+            const Double_t wzl = wl*zz[i+l];
+            sums[0][l]  += wl;
+            sums[1][l]  += wl*wl;
+            sums[2][l]  += wxl;
+            sums[3][l]  += wxl*zx[i+l];
+            sums[4][l]  += wyl;
+            sums[5][l]  += wyl*zy[i+l];
+            sums[6][l]  += wxl*zy[i+l];
+            sums[7][l]  += wzl;
+            sums[8][l]  += wzl*zz[i+l];
+            sums[9][l]  += wxl*zz[i+l];
+            sums[10][l] += wyl*zz[i+l];
+         }
+      }
+   }
+   for (Int_t l=0;l<kFillNLanes;l++) {
+      fTsumw   += sums[0][l];
+      fTsumw2  += sums[1][l];
+      fTsumwx  += sums[2][l];
+      fTsumwx2 += sums[3][l];
+      fTsumwy  += sums[4][l];
+      fTsumwy2 += sums[5][l];
+      fTsumwxy += sums[6][l];
+      fTsumwz  += sums[7][l];
+      fTsumwz2 += sums[8][l];
+      fTsumwxz += sums[9][l];
+      fTsumwyz += sums[10][l];
+   }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Increment cell defined by namex,namey,namez by a weight w
 ///
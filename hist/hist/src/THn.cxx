@@ -11,6 +11,8 @@
 
 #include "THn.h"
 
+#include "HistAddKernels.h"
+
 namespace {
    //______________________________________________________________________________
    //
@@ -220,6 +222,66 @@ void THn::Sumw2() {
 }
 
 
+namespace {
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Add c times the bins of 'fromArr' to 'toArr' if both have the storage type
+   /// T; the sums of squared weights are added as c*c times 'fromSumw2', or the
+   /// content of 'fromArr' if it is nullptr. Returns false for other storage types.
+
+   template <typename T>
+   Bool_t AddBinsT(TNDArray& toArr, const TNDArray& fromArr, TNDArrayT<Double_t>* sumw2,
+                   const TNDArrayT<Double_t>* fromSumw2, Double_t c)
+   {
+      TNDArrayT<T>* to = dynamic_cast<TNDArrayT<T>*>(&toArr);
+      const TNDArrayT<T>* from = dynamic_cast<const TNDArrayT<T>*>(&fromArr);
+      if (!to || !from)
+         return kFALSE;
+
+      // Arrays without data have all bins at 0.
+      const T* src = from->GetData();
+      const Double_t* srcSumw2 = fromSumw2 ? fromSumw2->GetData() : 0;
+      if (!src && !srcSumw2)
+         return kTRUE;
+      T* dst = &to->At((ULong64_t)0);
+      Double_t* dstSumw2 = sumw2 ? &sumw2->At((ULong64_t)0) : 0;
+
+      const Long64_t nbins = to->GetNbins();
+      ROOT::Internal::ForEachBinRange(nbins, nbins, [&](Long64_t first, Long64_t last) {
+         if (dstSumw2 && fromSumw2 && srcSumw2)
+            ROOT::Internal::AddBinArrays(dstSumw2 + first, srcSumw2 + first, last - first, c * c);
+         else if (dstSumw2 && !fromSumw2 && src)
+            ROOT::Internal::AddBinArrays(dstSumw2 + first, src + first, last - first, c * c);
+         if (src)
+            ROOT::Internal::AddBinArrays(dst + first, src + first, last - first, c);
+      });
+      return kTRUE;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the bins of h scaled by c if h is a THn of the same class and number
+/// of bins: the bin arrays are added directly, in parallel for large
+/// histograms if implicit multi-threading is enabled.
+
+Bool_t THn::AddSameBinning(const THnBase* h, Double_t c)
+{
+   const THn* hn = dynamic_cast<const THn*>(h);
+   if (!hn || hn->IsA() != IsA() || hn->GetNbins() != GetNbins())
+      return kFALSE;
+
+   TNDArray& to = GetArray();
+   const TNDArray& from = hn->GetArray();
+   TNDArrayT<Double_t>* sumw2 = GetCalculateErrors() ? &fSumw2 : 0;
+   const TNDArrayT<Double_t>* fromSumw2 = hn->GetCalculateErrors() ? &hn->fSumw2 : 0;
+   return AddBinsT<Double_t>(to, from, sumw2, fromSumw2, c)
+      || AddBinsT<Float_t>(to, from, sumw2, fromSumw2, c)
+      || AddBinsT<Long64_t>(to, from, sumw2, fromSumw2, c)
+      || AddBinsT<Long_t>(to, from, sumw2, fromSumw2, c)
+      || AddBinsT<Int_t>(to, from, sumw2, fromSumw2, c)
+      || AddBinsT<Short_t>(to, from, sumw2, fromSumw2, c)
+      || AddBinsT<Char_t>(to, from, sumw2, fromSumw2, c);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create the coordinate buffer. Outlined to hide allocation
 /// from inlined functions.
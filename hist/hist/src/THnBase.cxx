@@ -643,6 +643,11 @@ void THnBase::AddInternal(const THnBase* h, Double_t c, Bool_t rebinned)
       Sumw2();
    Bool_t haveErrors = GetCalculateErrors();
 
+   if (!rebinned && AddSameBinning(h, c)) {
+      SetEntries(GetEntries() + c * h->GetEntries());
+      return;
+   }
+
    Double_t* x = 0;
    if (rebinned) {
       x = new Double_t[fNdimensions];
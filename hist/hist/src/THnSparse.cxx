@@ -15,8 +15,28 @@
 #include "TClass.h"
 #include "TDataMember.h"
 #include "TDataType.h"
+#include "TROOT.h"
+
+#include <memory>
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 namespace {
+   /// Minimal number of entries filled by each thread in THnSparse::FillN()
+   constexpr Long64_t kMinParallelFillEntries = 10000;
+
+   /// Slot of the bin index where the search for "hash" starts,
+   /// given the mask of the number of slots.
+   ULong64_t GetBinIndexSlot(ULong64_t hash, ULong64_t mask) {
+      // the compact coordinates of neighboring bins only differ in a few bits: mix them
+      hash ^= hash >> 33;
+      hash *= 0xff51afd7ed558ccdULL;
+      hash ^= hash >> 33;
+      return hash & mask;
+   }
+
 //______________________________________________________________________________
 //
 // THnSparseBinIter iterates over all filled bins of a THnSparse.
@@ -169,7 +189,7 @@ THnSparseCoordCompression::THnSparseCoordCompression(const THnSparseCoordCompres
    fNdimensions = other.fNdimensions;
    fCoordBufferSize = other.fCoordBufferSize;
    fBitOffsets = new Int_t[fNdimensions + 1];
-   memcpy(fBitOffsets, other.fBitOffsets, sizeof(Int_t) * fNdimensions);
+   memcpy(fBitOffsets, other.fBitOffsets, sizeof(Int_t) * (fNdimensions + 1));
 }
 
 
@@ -184,7 +204,7 @@ THnSparseCoordCompression& THnSparseCoordCompression::operator=(const THnSparseC
    fCoordBufferSize = other.fCoordBufferSize;
    delete [] fBitOffsets;
    fBitOffsets = new Int_t[fNdimensions + 1];
-   memcpy(fBitOffsets, other.fBitOffsets, sizeof(Int_t) * fNdimensions);
+   memcpy(fBitOffsets, other.fBitOffsets, sizeof(Int_t) * (fNdimensions + 1));
    return *this;
 }
 
@@ -205,6 +225,19 @@ THnSparseCoordCompression::~THnSparseCoordCompression()
 void THnSparseCoordCompression::SetCoordFromBuffer(const Char_t* buf_in,
                                                   Int_t* coord_out) const
 {
+   if (fCoordBufferSize <= 8) {
+      // all coordinates fit into a ULong64_t: shift and mask each of them out
+      const UChar_t* pbuf = (const UChar_t*) buf_in;
+      ULong64_t l64buf = 0;
+      for (Int_t b = 0; b < fCoordBufferSize; ++b)
+         l64buf |= ((ULong64_t) pbuf[b]) << (8 * b);
+      for (Int_t i = 0; i < fNdimensions; ++i) {
+         const Int_t nbits = fBitOffsets[i + 1] - fBitOffsets[i];
+         coord_out[i] = (Int_t) ((l64buf >> fBitOffsets[i]) & ((1ULL << nbits) - 1));
+      }
+      return;
+   }
+
    for (Int_t i = 0; i < fNdimensions; ++i) {
       const Int_t offset = fBitOffsets[i] / 8;
       Int_t shift = fBitOffsets[i] % 8;
@@ -570,14 +603,19 @@ Translation from an n-dimensional bin coordinate to the linear index within
 the chunks is done by GetBin(). It creates a hash from the compacted bin
 coordinates (the hash of a bin coordinate is the compacted coordinate itself
 if it takes less than 8 bytes, the size of a Long64_t.
-This hash is used to lookup the linear index in the TExMap member fBins;
-the coordinates of the entry fBins points to is compared to the coordinates
-passed to GetBin(). If they do not match, these two coordinates have the same
-hash - which is extremely unlikely but (for the case where the compact bin
-coordinates are larger than 4 bytes) possible. In this case, fBinsContinued
-contains a chain of linear indexes with the same hash. Iterating through this
-chain and comparing each bin coordinates with the one passed to GetBin() will
-retrieve the matching bin.
+This hash is used to lookup the linear index in the open addressing table
+fBinIndex, a flat array of (hash, linear index + 1) pairs kept at most half
+full. The search starts at a slot given by the hash and goes through the
+following slots until an empty one is found; the coordinates of each entry with
+the same hash are compared to the coordinates passed to GetBin(). Two different
+coordinates only have the same hash if the compact bin coordinates are larger
+than 8 bytes, which is extremely unlikely. The table is not stored: it is
+rebuilt from the chunks when the histogram is read back.
+
+## Filling in Parallel
+THnSparse::FillN() fills an array of entries. With implicit multi-threading
+enabled (see ROOT::EnableImplicitMT()), each thread fills a part of the
+entries into its own empty copy of the histogram; the copies are then added.
 */
 
 
@@ -650,49 +688,158 @@ void THnSparse::InitStorage(Int_t* nbins, Int_t chunkSize)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-///We have been streamed; set up fBins
+/// We have been streamed; set up fBinIndex
 
-void THnSparse::FillExMap()
+void THnSparse::FillBinIndex()
 {
-   TIter iChunk(&fBinContent);
-   THnSparseArrayChunk* chunk = 0;
-   THnSparseCoordCompression compactCoord(*GetCompactCoord());
-   Long64_t idx = 0;
-   if (2 * GetNbins() > fBins.Capacity())
-      fBins.Expand(3 * GetNbins());
-   while ((chunk = (THnSparseArrayChunk*) iChunk())) {
+   fBinIndex.clear();
+   ResizeBinIndex(GetNbins());
+   THnSparseCompactBinCoord* cc = GetCompactCoord();
+   for (Int_t iChunk = 0; iChunk < GetNChunks(); ++iChunk) {
+      THnSparseArrayChunk* chunk = GetChunk(iChunk);
       const Int_t chunkSize = chunk->GetEntries();
-      Char_t* buf = chunk->fCoordinates;
       const Int_t singleCoordSize = chunk->fSingleCoordinateSize;
-      const Char_t* endbuf = buf + singleCoordSize * chunkSize;
-      for (; buf < endbuf; buf += singleCoordSize, ++idx) {
-         Long64_t hash = compactCoord.GetHashFromBuffer(buf);
-         Long64_t linidx = fBins.GetValue(hash);
-         if (linidx) {
-            Long64_t nextidx = linidx;
-            while (nextidx) {
-               // must be a collision, so go to fBinsContinued.
-               linidx = nextidx;
-               nextidx = fBinsContinued.GetValue(linidx);
-            }
-            fBinsContinued.Add(linidx, idx + 1);
-         } else {
-            fBins.Add(hash, idx + 1);
-         }
+      for (Int_t i = 0; i < chunkSize; ++i) {
+         const Long64_t idx = (Long64_t) iChunk * fChunkSize + i;
+         AddToBinIndex(cc->GetHashFromBuffer(chunk->fCoordinates + i * singleCoordSize), idx);
       }
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Grow the bin index such that it holds nbins bins at most half full.
+
+void THnSparse::ResizeBinIndex(Long64_t nbins)
+{
+   ULong64_t nslots = fBinIndex.size() / 2;
+   if ((ULong64_t) nbins * 2 <= nslots)
+      return;
+   if (nslots < 16)
+      nslots = 16;
+   while (nslots < (ULong64_t) nbins * 2)
+      nslots *= 2;
+
+   std::vector<ULong64_t> oldIndex(2 * nslots, 0);
+   fBinIndex.swap(oldIndex);
+   for (size_t slot = 0; slot < oldIndex.size(); slot += 2) {
+      if (oldIndex[slot + 1])
+         AddToBinIndex(oldIndex[slot], oldIndex[slot + 1] - 1);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Insert the bin with linear index idx and hash "hash" into the bin index,
+/// which must have room for it.
+
+void THnSparse::AddToBinIndex(ULong64_t hash, Long64_t idx)
+{
+   const ULong64_t mask = fBinIndex.size() / 2 - 1;
+   ULong64_t slot = GetBinIndexSlot(hash, mask);
+   while (fBinIndex[2 * slot + 1])
+      slot = (slot + 1) & mask;
+   fBinIndex[2 * slot] = hash;
+   fBinIndex[2 * slot + 1] = idx + 1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Initialize storage for nbins
 
 void THnSparse::Reserve(Long64_t nbins) {
-   if (!fBins.GetSize() && fBinContent.GetSize()) {
-      FillExMap();
+   if (fBinIndex.empty() && GetNbins()) {
+      FillBinIndex();
    }
-   if (2 * nbins > fBins.Capacity()) {
-      fBins.Expand(3 * nbins);
+   ResizeBinIndex(nbins);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the n entries with coordinates x and weights w; x holds the
+/// GetNdimensions() coordinates of each entry, one entry after the other.
+/// If w is null all weights are 1.
+///
+/// With implicit multi-threading enabled (see ROOT::EnableImplicitMT()), the
+/// entries are split between the threads of the pool. Each thread fills its
+/// entries into an empty copy of this histogram, which needs as much memory as
+/// the bins it fills; the copies are added to this histogram at the end.
+/// The linear bin indexes then do not follow the order of the entries.
+
+void THnSparse::FillN(Long64_t n, const Double_t* x, const Double_t* w /*= nullptr*/)
+{
+#ifdef R__USE_IMT
+   const UInt_t nshards = ROOT::IsImplicitMTEnabled() ? ROOT::GetThreadPoolSize() : 0;
+   if (nshards > 1 && n >= kMinParallelFillEntries * nshards) {
+      std::vector<std::unique_ptr<THnSparse>> shards(nshards);
+      for (auto &shard : shards) {
+         shard.reset((THnSparse*) CloneEmpty(GetName(), GetTitle(), &fAxes, kTRUE /*keepTargetAxis*/));
+         if (GetCalculateErrors())
+            shard->Sumw2();
+      }
+
+      auto fillShard = [&](UInt_t ishard) {
+         THnSparse* shard = shards[ishard].get();
+         const Long64_t last = n * (ishard + 1) / nshards;
+         for (Long64_t i = n * ishard / nshards; i < last; ++i)
+            shard->Fill(x + i * fNdimensions, w ? w[i] : 1.);
+      };
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(fillShard, ROOT::TSeqU(nshards));
+
+      for (auto &shard : shards) {
+         AddSameBinning(shard.get(), 1.);
+         fEntries += shard->fEntries;
+         if (GetCalculateErrors()) {
+            fTsumw += shard->fTsumw;
+            fTsumw2 += shard->fTsumw2;
+            for (Int_t d = 0; d < fNdimensions; ++d) {
+               fTsumwx[d] += shard->fTsumwx[d];
+               fTsumwx2[d] += shard->fTsumwx2[d];
+            }
+         }
+         shard.reset();
+      }
+      fIntegralStatus = kInvalidInt;
+      return;
    }
+#endif
+
+   for (Long64_t i = 0; i < n; ++i)
+      Fill(x + i * fNdimensions, w ? w[i] : 1.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the bins of h scaled by c if h is a THnSparse with the same number of
+/// bins on each axis: its compact bin coordinates are looked up directly.
+
+Bool_t THnSparse::AddSameBinning(const THnBase* h, Double_t c)
+{
+   const THnSparse* hs = dynamic_cast<const THnSparse*>(h);
+   if (!hs || hs->GetNdimensions() != fNdimensions)
+      return kFALSE;
+   for (Int_t d = 0; d < fNdimensions; ++d)
+      if (hs->GetAxis(d)->GetNbins() != GetAxis(d)->GetNbins())
+         return kFALSE;
+
+   Bool_t haveErrors = GetCalculateErrors();
+   Reserve(GetNbins() + hs->GetNbins());
+   THnSparseCompactBinCoord* cc = GetCompactCoord();
+   const Int_t nchunks = hs->GetNChunks();
+   for (Int_t iChunk = 0; iChunk < nchunks; ++iChunk) {
+      const THnSparseArrayChunk* from = hs->GetChunk(iChunk);
+      const Int_t nentries = from->GetEntries();
+      const Int_t singleCoordSize = from->fSingleCoordinateSize;
+      for (Int_t i = 0; i < nentries; ++i) {
+         cc->SetBuffer(from->fCoordinates + i * singleCoordSize);
+         const Long64_t idx = GetBinIndexForCurrentBin(kTRUE /*allocate*/);
+         THnSparseArrayChunk* to = GetChunk(idx / fChunkSize);
+         const Int_t toIdx = idx % fChunkSize;
+         const Double_t v = from->fContent->GetAt(i);
+         if (haveErrors) {
+            const Double_t err2 = from->fSumw2 ? from->fSumw2->GetAt(i) : v;
+            (*to->fSumw2)[toIdx] += err2 * c * c;
+         }
+         to->fContent->SetAt(to->fContent->GetAt(toIdx) + c * v, toIdx);
+      }
+   }
+   return kTRUE;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -790,19 +937,18 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
 {
    THnSparseCompactBinCoord* cc = GetCompactCoord();
    ULong64_t hash = cc->GetHash();
-   if (fBinContent.GetSize() && !fBins.GetSize())
-      FillExMap();
-   Long64_t linidx = (Long64_t) fBins.GetValue(hash);
-   while (linidx) {
-      // fBins stores index + 1!
-      THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
-      if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
-         return linidx - 1; // we store idx+1, 0 is "TExMap: not found"
-
-      Long64_t nextlinidx = fBinsContinued.GetValue(linidx);
-      if (!nextlinidx) break;
-
-      linidx = nextlinidx;
+   if (fBinIndex.empty() && GetNbins())
+      FillBinIndex();
+   if (!fBinIndex.empty()) {
+      const ULong64_t mask = fBinIndex.size() / 2 - 1;
+      for (ULong64_t slot = GetBinIndexSlot(hash, mask); fBinIndex[2 * slot + 1]; slot = (slot + 1) & mask) {
+         if (fBinIndex[2 * slot] != hash) continue;
+         // fBinIndex stores index + 1, 0 marks an empty slot
+         const Long64_t linidx = fBinIndex[2 * slot + 1] - 1;
+         THnSparseArrayChunk* chunk = GetChunk(linidx / fChunkSize);
+         if (chunk->Matches(linidx % fChunkSize, cc->GetBuffer()))
+            return linidx;
+      }
    }
    if (!allocate) return -1;
 
@@ -819,16 +965,8 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
 
    // store translation between hash and bin
    newidx += (fBinContent.GetEntriesFast() - 1) * fChunkSize;
-   if (!linidx) {
-      // fBins didn't find it
-      if (2 * GetNbins() > fBins.Capacity())
-         fBins.Expand(3 * GetNbins());
-      fBins.Add(hash, newidx + 1);
-   } else {
-      // fBins contains one, but it's the wrong one;
-      // add entry to fBinsContinued.
-      fBinsContinued.Add(linidx, newidx + 1);
-   }
+   ResizeBinIndex(GetNbins());
+   AddToBinIndex(hash, newidx);
    return newidx;
 }
 
@@ -880,7 +1018,7 @@ Double_t THnSparse::GetSparseFractionMem() const {
 
    Double_t size = 0.;
    size += fBinContent.GetEntries() * (GetChunkSize() * sizePerChunkElement + sizeof(THnSparseArrayChunk));
-   size += + 3 * sizeof(Long64_t) * fBins.GetSize() /* TExMap */;
+   size += sizeof(ULong64_t) * fBinIndex.size() /* fBinIndex */;
 
    Double_t nbinsTotal = 1.;
    for (Int_t d = 0; d < fNdimensions; ++d)
@@ -962,8 +1100,7 @@ void THnSparse::Sumw2()
 void THnSparse::Reset(Option_t *option /*= ""*/)
 {
    fFilledBins = 0;
-   fBins.Delete();
-   fBinsContinued.Clear();
+   std::vector<ULong64_t>().swap(fBinIndex);
    fBinContent.Delete();
    ResetBase(option);
 }
@@ -22,6 +22,16 @@
  
  The algorithm is briefly described in (4). A binned version is also implemented to address the 
  performance issue due to its data size dependance.
+
+ The density is by default evaluated by summing the kernels of all the events (or bins), option
+ "Evaluation:Direct". For large data sets two faster evaluations can be chosen:
+ - "Evaluation:FFT" computes the fixed bandwidth density on a regular grid, convoluting the data
+   binned on the grid with the kernel using a FFT, and interpolates it linearly. In the adaptive
+   case only the pilot (fixed bandwidth) estimate is computed in this way.
+ - "Evaluation:Tree" in addition sums the adaptive kernels with a KD-tree of the events in the
+   (position, bandwidth) plane, approximating the contribution of groups of events when the bounds
+   of their kernels are close enough.
+ The relative accuracy of both is controlled with SetEvaluationTolerance().
  */
 
 
@@ -29,6 +39,7 @@
 #include <algorithm>
 #include <numeric>
 #include <limits>
+#include <memory>
 #include <cassert>
 
 #include "Math/Error.h"
@@ -41,6 +52,8 @@
 #include "TF1.h"
 #include "TH1.h"
 #include "TVirtualPad.h"
+#include "TVirtualFFT.h"
+#include "TKDTree.h"
 #include "TKDE.h"
 
 
@@ -50,9 +63,26 @@ class TKDE::TKernel {
    TKDE* fKDE;
    UInt_t fNWeights; // Number of kernel weights (bandwidth as vectorized for binning)
    std::vector<Double_t> fWeights; // Kernel weights (bandwidth)
+   Bool_t fAdaptive; // Whether the weights were computed adaptively
+   Double_t fGridMin;  // Position of the first grid point for the FFT evaluation
+   Double_t fGridStep; // Distance between the grid points
+   std::vector<Double_t> fGrid; // Fixed bandwidth kernel sum at the grid points
+   std::unique_ptr<TKDTreeID> fTree; // KD-tree of the events in the (position, bandwidth) plane for the tree evaluation
+   std::vector<Double_t> fTreeX, fTreeH, fTreeW; // Position, bandwidth and count of the events in the tree
+   Double_t* fTreeData[2]; // Columns of the tree data
+   Double_t* fBoundaries; // Node boundaries owned by the tree
+   std::vector<Double_t> fNodeCount; // Sum of the counts of the events of each node
+   Double_t fSumCount; // Sum of the counts of the events in the tree
+   Double_t DirectSum(Double_t x) const;
+   Double_t GridSum(Double_t x) const;
+   Double_t TreeSum(Double_t x) const;
+   void AddTreeNode(Int_t node, Double_t x, Double_t kmin, Double_t kmax, Double_t& result, Double_t& lower) const;
+   void GetKernelBounds(Int_t node, Double_t x, Double_t& kmin, Double_t& kmax) const;
 public:
    TKernel(Double_t weight, TKDE* kde);
    void ComputeAdaptiveWeights();
+   void MakeGrid();
+   void MakeTree();
    Double_t operator()(Double_t x) const;
    Double_t GetWeight(Double_t x) const;
    Double_t GetFixedWeight() const;
@@ -77,11 +107,12 @@ TKDE::TKDE() :
    fLowerPDF(nullptr),
    fApproximateBias(nullptr),
    fGraph(nullptr),
+   fEvaluation(kDirect),
    fUseMirroring(false), fMirrorLeft(false), fMirrorRight(false), fAsymLeft(false), fAsymRight(false),
    fUseBins(false), fNewData(false), fUseMinMaxFromData(false),
    fNBins(0), fNEvents(0), fSumOfCounts(0), fUseBinsNEvents(0),
    fMean(0.),fSigma(0.), fSigmaRob(0.), fXMin(0.), fXMax(0.),
-   fRho(0.), fAdaptiveBandwidthFactor(0.), fWeightSize(0)
+   fRho(0.), fAdaptiveBandwidthFactor(0.), fWeightSize(0), fEvalTolerance(1.E-4)
 {
 }
 
@@ -123,9 +154,10 @@ void TKDE::Instantiate(KernelFunction_Ptr kernfunc, UInt_t events, const Double_
    fAdaptiveBandwidthFactor = 1.;
    fRho = rho;
    fWeightSize = 0;
+   fEvalTolerance = 1.E-4;
    fCanonicalBandwidths = std::vector<Double_t>(kTotalKernels, 0.0);
    fKernelSigmas2 = std::vector<Double_t>(kTotalKernels, -1.0);
-   fSettedOptions = std::vector<Bool_t>(4, kFALSE);
+   fSettedOptions = std::vector<Bool_t>(5, kFALSE);
    SetOptions(option, rho);
    CheckOptions(kTRUE);
    SetMirror();
@@ -140,7 +172,7 @@ void TKDE::SetOptions(const Option_t* option, Double_t rho) {
    TString opt = option;
    opt.ToLower();
    std::string options = opt.Data();
-   size_t numOpt = 4;
+   size_t numOpt = 5;
    std::vector<std::string> voption(numOpt, "");
    for (std::vector<std::string>::iterator it = voption.begin(); it != voption.end() && !options.empty(); ++it) {
       size_t pos = options.find_last_of(';');
@@ -269,6 +301,18 @@ void TKDE::GetOptions(std::string optionType, std::string option) {
          this->Warning("GetOptions", "Unknown binning option: setting to RelaxedBinning");
          fBinning = kRelaxedBinning;
       }
+   } else if (optionType.compare("evaluation") == 0) {
+      fSettedOptions[4] = kTRUE;
+      if (option.compare("direct") == 0) {
+         fEvaluation = kDirect;
+      } else if (option.compare("fft") == 0) {
+         fEvaluation = kFFT;
+      } else if (option.compare("tree") == 0) {
+         fEvaluation = kTree;
+      } else {
+         this->Warning("GetOptions", "Unknown evaluation option: setting to Direct");
+         fEvaluation = kDirect;
+      }
    }
 }
 
@@ -286,6 +330,9 @@ void TKDE::AssureOptions() {
    if (!fSettedOptions[3]) {
       fBinning = kRelaxedBinning;
    }
+   if (!fSettedOptions[4]) {
+      fEvaluation = kDirect;
+   }
 }
 
 void TKDE::CheckOptions(Bool_t isUserDefinedKernel) {
@@ -305,6 +352,10 @@ void TKDE::CheckOptions(Bool_t isUserDefinedKernel) {
       Warning("CheckOptions", "Illegal user binning type input - use default value !");
       fBinning = kRelaxedBinning;
    }
+   if (!(fEvaluation >= kDirect && fEvaluation <= kTree)) {
+      Warning("CheckOptions", "Illegal user evaluation type input - use default value !");
+      fEvaluation = kDirect;
+   }
    if (fRho <= 0.0) {
       Warning("CheckOptions", "Tuning factor rho cannot be non-positive - use default value !");
       fRho = 1.0;
@@ -374,6 +425,26 @@ void TKDE::SetUseBinsNEvents(UInt_t nEvents) {
    SetUseBins();
 }
 
+void TKDE::SetEvaluation(EEvaluation eval) {
+   // Sets User option for the evaluation of the density: kDirect sums the kernels of all the events (or bins),
+   // kFFT computes the fixed bandwidth density on a grid with a FFT convolution and kTree in addition sums
+   // the adaptive bandwidth kernels with a KD-tree
+   fEvaluation = eval;
+   CheckOptions();
+   SetKernel();
+}
+
+void TKDE::SetEvaluationTolerance(Double_t tol) {
+   // Sets the relative tolerance of the FFT and tree evaluations (default is 1.E-4).
+   // The time and memory needed by the FFT evaluation grow as 1/sqrt(tol)
+   if (tol <= 0. || tol >= 1.) {
+      Error("SetEvaluationTolerance", "The tolerance must be between 0 and 1. Present tolerance %g remains the same.", fEvalTolerance);
+      return;
+   }
+   fEvalTolerance = tol;
+   SetKernel();
+}
+
 void TKDE::SetTuneFactor(Double_t rho) {
    // Factor which can be used to tune the smoothing.
    // It is used as multiplicative factor for the fixed and adaptive bandwidth.
@@ -570,8 +641,15 @@ void TKDE::SetKernel() {
    weight *= fRho * fCanonicalBandwidths[fKernelType] / fCanonicalBandwidths[kGaussian];
    if (fKernel) delete fKernel;
    fKernel = new TKernel(weight, this);
+   // the fixed bandwidth estimate is also the pilot estimate of the adaptive one
+   if (fEvaluation != kDirect && fKernelFunction) {
+      fKernel->MakeGrid();
+   }
    if (fIteration == kAdaptive) {
       fKernel->ComputeAdaptiveWeights();
+      if (fEvaluation == kTree && fKernelFunction) {
+         fKernel->MakeTree();
+      }
    }
    //std::cout << "setting the kernel - n = " << n << " weight is " << weight << "  " << fRho << "  " << fSigmaRob << "   " << fSigma << "   " << fMean << "  " << fCanonicalBandwidths[kGaussian] <<  std::endl;
 }
@@ -721,7 +799,13 @@ TKDE::TKernel::TKernel(Double_t weight, TKDE* kde) :
 // Internal class constructor
 fKDE(kde),
 fNWeights(kde->fData.size()),
-fWeights(fNWeights, weight)
+fWeights(fNWeights, weight),
+fAdaptive(kFALSE),
+fGridMin(0.),
+fGridStep(0.),
+fTreeData{nullptr, nullptr},
+fBoundaries(nullptr),
+fSumCount(0.)
 {}
 
 void TKDE::TKernel::ComputeAdaptiveWeights() {
@@ -747,6 +831,9 @@ void TKDE::TKernel::ComputeAdaptiveWeights() {
    fKDE->fAdaptiveBandwidthFactor = fKDE->fUseMirroring ? kAPPROX_GEO_MEAN / fKDE->fSigmaRob : std::sqrt(std::exp(fKDE->fAdaptiveBandwidthFactor / fKDE->fData.size()));
    transform(weights.begin(), weights.end(), fWeights.begin(),
              std::bind(std::multiplies<Double_t>(), std::placeholders::_1, fKDE->fAdaptiveBandwidthFactor));
+   // the grid of the pilot estimate is not needed anymore
+   fAdaptive = kTRUE;
+   std::vector<Double_t>().swap(fGrid);
    //printf("adaptive bandwidth factor % f weight 0 %f , %f \n",fKDE->fAdaptiveBandwidthFactor, weights[0],fWeights[0] );
 }
 
@@ -932,11 +1019,30 @@ const std::vector<Double_t> & TKDE::TKernel::GetAdaptiveWeights() const {
 
 Double_t TKDE::TKernel::operator()(Double_t x) const {
    // The internal class's unary function: returns the kernel density estimate
-   Double_t result(0.0);
    UInt_t n = fKDE->fData.size();
    // case of bins or weighted data 
    Bool_t useBins = (fKDE->fBinCount.size() == n);
    Double_t nSum = (useBins) ? fKDE->fSumOfCounts : fKDE->fNEvents;
+   Double_t result;
+   if (!fAdaptive && !fGrid.empty()) {
+      result = GridSum(x);
+   } else if (fAdaptive && fTree) {
+      result = TreeSum(x);
+   } else {
+      result = DirectSum(x);
+   }
+   if ( TMath::IsNaN(result) ) {
+      fKDE->Warning("operator()","Result is NaN for  x %f \n",x);
+    //xmin % f , %f, %f \n",result,x,xmin,bmin,wmin );
+   }
+   return result / nSum;
+}
+
+Double_t TKDE::TKernel::DirectSum(Double_t x) const {
+   // Returns the sum of the kernels of all the events (or bins) at x
+   Double_t result(0.0);
+   UInt_t n = fKDE->fData.size();
+   Bool_t useBins = (fKDE->fBinCount.size() == n);
    // double dmin = 1.E10;
    // double xmin,bmin,wmin; 
    for (UInt_t i = 0; i < n; ++i) {
@@ -963,11 +1069,221 @@ Double_t TKDE::TKernel::operator()(Double_t x) const {
       // if (i < fKDE->fEvents.size() )
       // printf("data point %i  %f  %f  count %f weight % f result % f\n",i,fKDE->fData[i],fKDE->fEvents[i],binCount,fWeights[i], result);
    }
-   if ( TMath::IsNaN(result) ) {
-      fKDE->Warning("operator()","Result is NaN for  x %f \n",x);
-    //xmin % f , %f, %f \n",result,x,xmin,bmin,wmin );
+   return result;
+}
+
+Double_t TKDE::TKernel::GridSum(Double_t x) const {
+   // Returns the fixed bandwidth kernel sum at x, interpolated linearly between the grid points
+   Double_t t = (x - fGridMin) / fGridStep;
+   if (t < 0. || t >= fGrid.size() - 1) return 0.;
+   UInt_t j = UInt_t(t);
+   Double_t frac = t - j;
+   return (1. - frac) * fGrid[j] + frac * fGrid[j + 1];
+}
+
+void TKDE::TKernel::MakeGrid() {
+   // Computes the fixed bandwidth kernel sum on a regular grid, convoluting the data binned on the grid with the
+   // sampled kernel by FFT. The binning and the interpolation between the grid points give relative errors
+   // scaling as (step / bandwidth)**2, the step is chosen from the evaluation tolerance
+   const UInt_t kMaxGridPoints = 1 << 22;
+   const std::vector<Double_t> &data = fKDE->fData;
+   UInt_t n = data.size();
+   Bool_t useBins = (fKDE->fBinCount.size() == n);
+   Double_t h = fWeights[0];
+   Double_t support = fKDE->ComputeKernelSupport() * h;
+
+   // the asymmetric mirroring subtracts the kernels of the events reflected at the boundaries
+   std::vector<Double_t> pos, count;
+   pos.reserve(n);
+   count.reserve(n);
+   for (UInt_t i = 0; i < n; ++i) {
+      Double_t binCount = (useBins) ? fKDE->fBinCount[i] : 1.0;
+      if (binCount == 0) continue;
+      pos.push_back(data[i]);
+      count.push_back(binCount);
+      if (fKDE->fAsymLeft) {
+         pos.push_back(2. * fKDE->fXMin - data[i]);
+         count.push_back(-binCount);
+      }
+      if (fKDE->fAsymRight) {
+         pos.push_back(2. * fKDE->fXMax - data[i]);
+         count.push_back(-binCount);
+      }
    }
-   return result / nSum;
+   if (pos.empty()) return;
+
+   auto range = std::minmax_element(pos.begin(), pos.end());
+   fGridMin = *range.first - support;
+   Double_t width = *range.second + support - fGridMin;
+   fGridStep = h * std::sqrt(fKDE->fEvalTolerance);
+   if (width / fGridStep > kMaxGridPoints) {
+      fGridStep = width / kMaxGridPoints;
+      fKDE->Warning("MakeGrid", "The range of the data is too large for the evaluation tolerance, the grid is limited to %u points", kMaxGridPoints);
+   }
+   Int_t nGrid = Int_t(width / fGridStep) + 2;
+   Int_t nKernel = Int_t(std::ceil(support / fGridStep));
+
+   // each count is shared between the two nearest grid points
+   std::vector<Double_t> binned(nGrid, 0.);
+   for (UInt_t i = 0; i < pos.size(); ++i) {
+      Double_t t = (pos[i] - fGridMin) / fGridStep;
+      Int_t j = std::min(Int_t(t), nGrid - 2);
+      Double_t frac = t - j;
+      binned[j] += (1. - frac) * count[i];
+      binned[j + 1] += frac * count[i];
+   }
+   // kernel at the distances -nKernel .. nKernel grid steps
+   std::vector<Double_t> kernel(2 * nKernel + 1);
+   for (Int_t l = -nKernel; l <= nKernel; ++l) {
+      kernel[l + nKernel] = (*fKDE->fKernelFunction)(l * fGridStep / h) / h;
+   }
+
+   fGrid.assign(nGrid, 0.);
+   // zero padding avoids the wrapping of the circular convolution
+   Int_t nFFT = 1;
+   while (nFFT < nGrid + 2 * nKernel) nFFT *= 2;
+   TVirtualFFT *fftData = TVirtualFFT::FFT(1, &nFFT, "R2C K");
+   TVirtualFFT *fftKernel = TVirtualFFT::FFT(1, &nFFT, "R2C K");
+   TVirtualFFT *fftInverse = TVirtualFFT::FFT(1, &nFFT, "C2R K");
+   if (fftData && fftKernel && fftInverse) {
+      for (Int_t i = 0; i < nFFT; ++i) {
+         fftData->SetPoint(i, (i < nGrid) ? binned[i] : 0.);
+         // negative distances are stored at the end
+         Int_t l = (i <= nKernel) ? i : i - nFFT;
+         fftKernel->SetPoint(i, (l >= -nKernel) ? kernel[l + nKernel] : 0.);
+      }
+      fftData->Transform();
+      fftKernel->Transform();
+      Double_t re1, im1, re2, im2;
+      for (Int_t i = 0; i <= nFFT / 2; ++i) {
+         fftData->GetPointComplex(i, re1, im1);
+         fftKernel->GetPointComplex(i, re2, im2);
+         fftInverse->SetPoint(i, re1 * re2 - im1 * im2, re1 * im2 + re2 * im1);
+      }
+      fftInverse->Transform();
+      for (Int_t j = 0; j < nGrid; ++j) {
+         fGrid[j] = fftInverse->GetPointReal(j) / nFFT;
+      }
+   } else {
+      fKDE->Warning("MakeGrid", "Cannot use FFT, probably FFTW package is not available. Convolute directly on the grid");
+      for (Int_t j = 0; j < nGrid; ++j) {
+         Int_t first = std::max(j - nKernel, 0);
+         Int_t last = std::min(j + nKernel, nGrid - 1);
+         for (Int_t m = first; m <= last; ++m) {
+            fGrid[j] += binned[m] * kernel[j - m + nKernel];
+         }
+      }
+   }
+   delete fftData;
+   delete fftKernel;
+   delete fftInverse;
+}
+
+void TKDE::TKernel::MakeTree() {
+   // Builds the KD-tree of the events in the (position, bandwidth) plane for the tree evaluation
+   // and the sum of the counts of the events of each node
+   const UInt_t kBucketSize = 16;
+   if (fKDE->fKernelType == kUserDefined || fKDE->fAsymLeft || fKDE->fAsymRight) {
+      fKDE->Warning("MakeTree", "The tree evaluation is not possible with user defined kernels or asymmetric mirroring. Use the direct evaluation");
+      return;
+   }
+   const std::vector<Double_t> &data = fKDE->fData;
+   UInt_t n = data.size();
+   Bool_t useBins = (fKDE->fBinCount.size() == n);
+   fSumCount = 0;
+   for (UInt_t i = 0; i < n; ++i) {
+      Double_t binCount = (useBins) ? fKDE->fBinCount[i] : 1.0;
+      if (binCount < 0) {
+         fKDE->Warning("MakeTree", "The tree evaluation is not possible with negative weights. Use the direct evaluation");
+         return;
+      }
+      if (binCount == 0) continue;
+      fTreeX.push_back(data[i]);
+      fTreeH.push_back(fWeights[i]);
+      fTreeW.push_back(binCount);
+      fSumCount += binCount;
+   }
+   // the direct sum is as fast for a few buckets
+   if (fTreeX.size() <= 4 * kBucketSize) return;
+
+   fTreeData[0] = fTreeX.data();
+   fTreeData[1] = fTreeH.data();
+   fTree.reset(new TKDTreeID(fTreeX.size(), 2, kBucketSize, fTreeData));
+   fTree->Build();
+   fBoundaries = fTree->GetBoundariesExact();
+   Int_t nNodes = fTree->GetNNodes();
+   Int_t nTotal = fTree->GetTotalNodes();
+   fNodeCount.assign(nTotal, 0.);
+   for (Int_t node = nNodes; node < nTotal; ++node) {
+      Int_t *points = fTree->GetPointsIndexes(node);
+      Int_t npoints = fTree->GetNPointsNode(node);
+      for (Int_t i = 0; i < npoints; ++i) {
+         fNodeCount[node] += fTreeW[points[i]];
+      }
+   }
+   for (Int_t node = nNodes - 1; node >= 0; --node) {
+      fNodeCount[node] = fNodeCount[fTree->GetLeft(node)] + fNodeCount[fTree->GetRight(node)];
+   }
+}
+
+void TKDE::TKernel::GetKernelBounds(Int_t node, Double_t x, Double_t& kmin, Double_t& kmax) const {
+   // Returns the bounds of the kernels of the events of a node at x, using that the kernel decreases
+   // with the distance and that its normalization 1 / h decreases with the bandwidth h
+   const Double_t *b = fBoundaries + 4 * node; // position and bandwidth ranges
+   Double_t dmin = std::max(0., std::max(b[0] - x, x - b[1]));
+   Double_t dmax = std::max(x - b[0], b[1] - x);
+   kmax = (*fKDE->fKernelFunction)(dmin / b[3]) / b[2];
+   kmin = (*fKDE->fKernelFunction)(dmax / b[2]) / b[3];
+}
+
+Double_t TKDE::TKernel::TreeSum(Double_t x) const {
+   // Returns the sum of the adaptive kernels at x descending the tree of the events
+   Double_t kmin, kmax;
+   GetKernelBounds(0, x, kmin, kmax);
+   Double_t result = 0.;
+   Double_t lower = fNodeCount[0] * kmin;
+   AddTreeNode(0, x, kmin, kmax, result, lower);
+   return result;
+}
+
+void TKDE::TKernel::AddTreeNode(Int_t node, Double_t x, Double_t kmin, Double_t kmax, Double_t& result, Double_t& lower) const {
+   // Adds the kernels of the events of a node to result. lower is a lower bound of the total sum which
+   // includes the bound count * kmin of the node. The node sum is approximated by the mean of its bounds
+   // when the error is below the tolerance times the lower bound, weighted by the node fraction of the counts
+   if (kmax <= 0.) return;
+   Double_t count = fNodeCount[node];
+   if ((kmax - kmin) * fSumCount <= 2. * fKDE->fEvalTolerance * lower) {
+      Double_t value = 0.5 * count * (kmin + kmax);
+      result += value;
+      lower += value - count * kmin;
+      return;
+   }
+   if (fTree->IsTerminal(node)) {
+      Int_t *points = fTree->GetPointsIndexes(node);
+      Int_t npoints = fTree->GetNPointsNode(node);
+      Double_t value = 0.;
+      for (Int_t i = 0; i < npoints; ++i) {
+         Int_t k = points[i];
+         value += fTreeW[k] / fTreeH[k] * (*fKDE->fKernelFunction)((x - fTreeX[k]) / fTreeH[k]);
+      }
+      result += value;
+      lower += value - count * kmin;
+      return;
+   }
+   Int_t node1 = fTree->GetLeft(node);
+   Int_t node2 = fTree->GetRight(node);
+   Double_t kmin1, kmax1, kmin2, kmax2;
+   GetKernelBounds(node1, x, kmin1, kmax1);
+   GetKernelBounds(node2, x, kmin2, kmax2);
+   lower += fNodeCount[node1] * kmin1 + fNodeCount[node2] * kmin2 - count * kmin;
+   // the daughter with the larger contribution first, to raise the lower bound early
+   if (fNodeCount[node2] * kmax2 > fNodeCount[node1] * kmax1) {
+      std::swap(node1, node2);
+      std::swap(kmin1, kmin2);
+      std::swap(kmax1, kmax2);
+   }
+   AddTreeNode(node1, x, kmin1, kmax1, result, lower);
+   AddTreeNode(node2, x, kmin2, kmax2, result, lower);
 }
 
 UInt_t TKDE::Index(Double_t x) const {
@@ -1082,6 +1398,28 @@ Double_t TKDE::ComputeKernelIntegral() const {
    return result;
 }
 
+Double_t TKDE::ComputeKernelSupport() const {
+   // Computes the half-width of the region outside which the kernel is zero or negligible
+   switch (fKernelType) {
+      case kGaussian :
+         return 9.;
+      case kEpanechnikov :
+      case kBiweight :
+      case kCosineArch :
+         return 1.;
+      default:
+         break;
+   }
+   const Double_t kNegligible = 1.E-12;
+   Double_t kmax = std::abs((*fKernelFunction)(0.));
+   Double_t u = 1.;
+   while (u < 1024. && (std::abs((*fKernelFunction)(u)) > kNegligible * kmax ||
+                        std::abs((*fKernelFunction)(-u)) > kNegligible * kmax)) {
+      u *= 2.;
+   }
+   return u;
+}
+
 void TKDE::ComputeDataStats() {
    /// in case of weights use
    if (!fEventWeights.empty() ) {
@@ -21,6 +21,9 @@
 #include <TFormula.h>
 #include <TF1.h>
 #include <TFitResult.h>
+#include <TH1D.h>
+#include <TRandom3.h>
+#include <Math/MinimizerOptions.h>
 
 TEST(TFormulaGradientPar, Sanity)
 {
@@ -129,6 +132,35 @@ TEST(TFormulaGradientPar, BreitWignerCrossCheckAccuracyDemo)
    EXPECT_NEAR(0, result_num[2], /*abs_error*/1e-13);
 }
 
+TEST(TFormulaGradientPar, FitWithAnalyticGradient)
+{
+   TH1D h("h", "h", 50, -5, 5);
+   h.SetDirectory(nullptr);
+   TRandom3 rndm(4357);
+   for (int i = 0; i < 10000; ++i)
+      h.Fill(rndm.Gaus(0.5, 1.5));
+
+   ROOT::Math::MinimizerOptions::SetDefaultMinimizer("Minuit2");
+   TF1 f1("f1", "gaus", -5, 5);
+   f1.SetParameters(100, 0, 1);
+   TFitResultPtr numerical = h.Fit(&f1, "S Q N");
+   ASSERT_EQ(0, numerical->Status());
+
+   // Option G uses the parameter gradient generated by clad.
+   TF1 f2("f2", "gaus", -5, 5);
+   f2.SetParameters(100, 0, 1);
+   TFitResultPtr analytic = h.Fit(&f2, "S Q N G");
+   ASSERT_EQ(0, analytic->Status());
+   EXPECT_TRUE(f2.GetFormula()->HasGeneratedGradient());
+   // With the analytic gradient the minimizer does not evaluate the objective function for
+   // the finite differences, hence the lower number of calls.
+   EXPECT_LT(analytic->NCalls(), numerical->NCalls());
+   for (int i = 0; i < 3; ++i) {
+      EXPECT_NEAR(numerical->Parameter(i), analytic->Parameter(i), 1e-3 * numerical->ParError(i));
+      EXPECT_NEAR(numerical->ParError(i), analytic->ParError(i), 1e-2 * numerical->ParError(i));
+   }
+}
+
 // FIXME: Add more: crystalball, cheb3, bigaus?
 
 // FIXME: Disable because of a known failure in -Druntime_cxxmodules=On.
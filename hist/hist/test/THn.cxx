@@ -1,8 +1,15 @@
 #include "gtest/gtest.h"
 
 #include "THn.h"
+#include "THnSparse.h"
+#include "TList.h"
 #include "TH1.h"
 #include "TH2.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+
+#include <cmath>
+#include <vector>
 
 // Filling THn
 TEST(THn, Fill) {
@@ -111,3 +118,148 @@ TEST(THn, Projection) {
    }
 
 }
+
+
+// Compare the filled bins of two THnSparse, whose linear bin indexes can differ
+static void ExpectSameBins(const THnSparse &hn, const THnSparse &expected)
+{
+   ASSERT_EQ(expected.GetNbins(), hn.GetNbins());
+   std::vector<Int_t> coord(hn.GetNdimensions());
+   for (Long64_t i = 0; i < expected.GetNbins(); ++i) {
+      const Double_t v = expected.GetBinContent(i, coord.data());
+      const Long64_t bin = hn.GetBin(coord.data());
+      ASSERT_GE(bin, 0);
+      EXPECT_NEAR(v, hn.GetBinContent(bin), 1e-12 * std::abs(v));
+      EXPECT_NEAR(expected.GetBinError2(i), hn.GetBinError2(bin), 1e-12 * expected.GetBinError2(i));
+   }
+}
+
+// Entries spread over many bins of 12 axes, with compact coordinates below
+// and above 8 bytes
+static std::vector<Double_t> GenerateSparseEntries(Long64_t n, Int_t ndim, std::vector<Double_t> &w)
+{
+   TRandom3 rng(17);
+   std::vector<Double_t> x(n * ndim);
+   for (auto &xi : x)
+      xi = rng.Gaus(0., 0.4);
+   w.resize(n);
+   for (auto &wi : w)
+      wi = rng.Uniform(0.5, 1.5);
+   return x;
+}
+
+TEST(THnSparse, FillN) {
+   const Int_t ndim = 12;
+   const Long64_t n = 50000;
+   std::vector<Double_t> w;
+   std::vector<Double_t> x = GenerateSparseEntries(n, ndim, w);
+
+   for (Int_t nbins : {6, 200}) {
+      std::vector<Int_t> bins(ndim, nbins);
+      std::vector<Double_t> xmin(ndim, -1.), xmax(ndim, 1.);
+      THnSparseD hFill("hFill", "hFill", ndim, bins.data(), xmin.data(), xmax.data());
+      THnSparseD hFillN("hFillN", "hFillN", ndim, bins.data(), xmin.data(), xmax.data(), 1024);
+      hFill.Sumw2();
+      hFillN.Sumw2();
+
+      for (Long64_t i = 0; i < n; ++i)
+         hFill.Fill(&x[i * ndim], w[i]);
+#ifdef R__USE_IMT
+      ROOT::EnableImplicitMT(4);
+#endif
+      hFillN.FillN(n, x.data(), w.data());
+#ifdef R__USE_IMT
+      ROOT::DisableImplicitMT();
+#endif
+
+      ExpectSameBins(hFillN, hFill);
+      EXPECT_DOUBLE_EQ(hFill.GetEntries(), hFillN.GetEntries());
+      EXPECT_NEAR(hFill.GetSumw(), hFillN.GetSumw(), 1e-9);
+      EXPECT_NEAR(hFill.GetSumw2(), hFillN.GetSumw2(), 1e-9);
+      for (Int_t d = 0; d < ndim; ++d)
+         EXPECT_NEAR(hFill.GetSumwx(d), hFillN.GetSumwx(d), 1e-9);
+   }
+}
+
+TEST(THnSparse, Add) {
+   const Int_t ndim = 12;
+   const Long64_t n = 20000;
+   std::vector<Double_t> w;
+   std::vector<Double_t> x = GenerateSparseEntries(n, ndim, w);
+
+   std::vector<Int_t> bins(ndim, 200);
+   std::vector<Double_t> xmin(ndim, -1.), xmax(ndim, 1.);
+   THnSparseF h1("h1", "h1", ndim, bins.data(), xmin.data(), xmax.data());
+   THnSparseF h2("h2", "h2", ndim, bins.data(), xmin.data(), xmax.data());
+   THnSparseF hAll("hAll", "hAll", ndim, bins.data(), xmin.data(), xmax.data());
+   h2.Sumw2();
+   hAll.Sumw2();
+   for (Long64_t i = 0; i < n; ++i) {
+      // the first half of the entries also goes into h2, to have common bins
+      if (i % 2 || i < n / 2)
+         h1.Fill(&x[i * ndim]);
+      if (i % 2 == 0)
+         h2.Fill(&x[i * ndim], 2.);
+      if (i % 2 || i < n / 2)
+         hAll.Fill(&x[i * ndim]);
+      if (i % 2 == 0)
+         hAll.Fill(&x[i * ndim], 2. * 2.);
+   }
+
+   h1.Add(&h2, 2.);
+   EXPECT_TRUE(h1.GetCalculateErrors());
+   ExpectSameBins(h1, hAll);
+
+   // the filled bins of h1 are found again after a Reset()
+   h1.Reset();
+   EXPECT_EQ(0, h1.GetNbins());
+   h1.Add(&h2);
+   EXPECT_EQ(h2.GetNbins(), h1.GetNbins());
+   ExpectSameBins(h1, h2);
+}
+
+// Merging THn with the same binning adds the bin arrays
+TEST(THn, Merge) {
+   const Int_t ndim = 3, nparts = 3;
+   const Long64_t n = 5000;
+   Int_t bins[ndim] = {20, 30, 10};
+   Double_t xmin[ndim] = {-1., -1., -1.};
+   Double_t xmax[ndim] = {1., 1., 1.};
+   std::vector<Double_t> w;
+   std::vector<Double_t> x = GenerateSparseEntries(nparts * n, ndim, w);
+
+   THnD hAll("hAll", "hAll", ndim, bins, xmin, xmax);
+   THnD merged("merged", "merged", ndim, bins, xmin, xmax);
+   THnI iAll("iAll", "iAll", ndim, bins, xmin, xmax);
+   THnI iMerged("iMerged", "iMerged", ndim, bins, xmin, xmax);
+   hAll.Sumw2();
+   TList parts, iParts;
+   parts.SetOwner();
+   iParts.SetOwner();
+   for (Int_t part = 0; part < nparts; ++part) {
+      THnD *h = new THnD(TString::Format("h%d", part), "", ndim, bins, xmin, xmax);
+      THnI *hi = new THnI(TString::Format("i%d", part), "", ndim, bins, xmin, xmax);
+      // only some parts have errors, the others use their content
+      if (part != 1)
+         h->Sumw2();
+      for (Long64_t i = part * n; i < (part + 1) * n; ++i) {
+         h->Fill(&x[i * ndim], part == 1 ? 1. : w[i]);
+         hAll.Fill(&x[i * ndim], part == 1 ? 1. : w[i]);
+         hi->Fill(&x[i * ndim]);
+         iAll.Fill(&x[i * ndim]);
+      }
+      parts.Add(h);
+      iParts.Add(hi);
+   }
+
+   merged.Merge(&parts);
+   iMerged.Merge(&iParts);
+   EXPECT_DOUBLE_EQ(hAll.GetEntries(), merged.GetEntries());
+   EXPECT_TRUE(merged.GetCalculateErrors());
+   ASSERT_EQ(hAll.GetNbins(), merged.GetNbins());
+   for (Long64_t bin = 0; bin < hAll.GetNbins(); ++bin) {
+      EXPECT_NEAR(hAll.GetBinContent(bin), merged.GetBinContent(bin), 1e-12 * std::abs(hAll.GetBinContent(bin)));
+      EXPECT_NEAR(hAll.GetBinError2(bin), merged.GetBinError2(bin), 1e-12 * hAll.GetBinError2(bin));
+      EXPECT_EQ(iAll.GetBinContent(bin), iMerged.GetBinContent(bin));
+   }
+}
@@ -2,8 +2,77 @@
 
 #include "TFormula.h"
 
+#include <cmath>
+#include <vector>
+
 // Test that autoloading works (ROOT-9840)
 TEST(TFormula, Interp)
 {
   TFormula f("func", "TGeoBBox::DeclFileLine()");
 }
+
+TEST(TFormula, EvalParBatch)
+{
+  TFormula f("batch", "[0]*exp(-0.5*((x-[1])/[2])^2) + [3]*y");
+  const double params[] = {2., 0.5, 1.5, -0.25};
+  f.SetParameters(params);
+
+  // two dimensional points with one padding value
+  const size_t n = 10, stride = 3;
+  std::vector<double> xs(n * stride);
+  for (size_t i = 0; i < n; ++i) {
+    xs[i * stride] = 0.3 * i - 1.;
+    xs[i * stride + 1] = 0.1 * i;
+    xs[i * stride + 2] = -999.;
+  }
+
+  std::vector<double> out(n);
+  f.EvalParBatch(xs.data(), n, stride, params, out.data());
+  for (size_t i = 0; i < n; ++i)
+    EXPECT_DOUBLE_EQ(out[i], f.EvalPar(&xs[i * stride], params)) << "point " << i;
+
+  // the parameters of the formula are used by default
+  const double other[] = {1., 0., 1., 0.};
+  f.SetParameters(other);
+  f.EvalParBatch(xs.data(), n, stride, nullptr, out.data());
+  for (size_t i = 0; i < n; ++i)
+    EXPECT_DOUBLE_EQ(out[i], f.EvalPar(&xs[i * stride], nullptr)) << "point " << i;
+}
+
+TEST(TFormula, DeferredCompilation)
+{
+  TFormula::SetDeferredCompilation();
+  EXPECT_TRUE(TFormula::IsDeferredCompilation());
+  TFormula f1("deferred1", "x*[0] + 0.125", false);
+  TFormula f2("deferred2", "x*[0] + 0.125", false);
+  TFormula f3("deferred3", "sin(x)*[0] - 0.375", false);
+  TFormula::SetDeferredCompilation(false);
+
+  f1.SetParameter(0, 2.);
+  f2.SetParameter(0, 3.);
+  f3.SetParameter(0, 4.);
+  // the identical expressions are compiled once, with the first evaluation
+  EXPECT_DOUBLE_EQ(f1.Eval(1.5), 3.125);
+  EXPECT_EQ(TFormula::CompilePendingFormulas(), 0);
+  EXPECT_DOUBLE_EQ(f2.Eval(1.5), 4.625);
+  EXPECT_DOUBLE_EQ(f3.Eval(1.5), 4. * std::sin(1.5) - 0.375);
+  EXPECT_TRUE(f3.IsValid());
+}
+
+TEST(TFormula, DeferredCompilationAlreadyCompiled)
+{
+  TFormula::SetDeferredCompilation();
+  TFormula f1("deferred4", "x*[0] + 0.625", false);
+  TFormula f2("deferred5", "[0]*2.5 - 1", false);
+  TFormula::SetDeferredCompilation(false);
+  // the identical expression is compiled right away, it must not be compiled again
+  TFormula f3("deferred6", "x*[0] + 0.625", false);
+
+  EXPECT_EQ(TFormula::CompilePendingFormulas(), 1);
+  f1.SetParameter(0, 2.);
+  f2.SetParameter(0, 3.);
+  f3.SetParameter(0, 4.);
+  EXPECT_DOUBLE_EQ(f1.Eval(1.5), 3.625);
+  EXPECT_DOUBLE_EQ(f2.Eval(0.), 6.5);
+  EXPECT_DOUBLE_EQ(f3.Eval(1.5), 6.625);
+}
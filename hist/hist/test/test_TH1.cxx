@@ -2,6 +2,15 @@
 
 #include "TH1.h"
 #include "TH1F.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TList.h"
+#include "TProfile.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+
+#include <cmath>
+#include <vector>
 
 // StatOverflows TH1
 TEST(TH1, StatOverflows)
@@ -30,3 +39,138 @@ TEST(TH1, StatOverflows)
    EXPECT_EQ(TH1::EStatOverflows::kConsider, h1.GetStatOverflows());
    EXPECT_EQ(TH1::EStatOverflows::kNeutral,  h2.GetStatOverflows());
 }
+
+// Compare the contents and statistics of a histogram filled with FillN to one filled with Fill
+static void ExpectSameFill(const TH1 &fillN, const TH1 &fill)
+{
+   EXPECT_EQ(fillN.GetEntries(), fill.GetEntries());
+   ASSERT_EQ(fillN.GetNcells(), fill.GetNcells());
+   for (Int_t bin = 0; bin < fill.GetNcells(); ++bin) {
+      EXPECT_DOUBLE_EQ(fillN.GetBinContent(bin), fill.GetBinContent(bin)) << "bin " << bin;
+      EXPECT_DOUBLE_EQ(fillN.GetBinError(bin), fill.GetBinError(bin)) << "bin " << bin;
+   }
+   Double_t statsN[TH1::kNstat], stats[TH1::kNstat];
+   fillN.GetStats(statsN);
+   fill.GetStats(stats);
+   for (Int_t i = 0; i < TH1::kNstat; ++i)
+      EXPECT_NEAR(statsN[i], stats[i], 1e-10 * std::abs(stats[i])) << "statistic " << i;
+}
+
+// FillN of TH1, TH2 and TH3 with fixed and variable bins
+TEST(TH1, FillN)
+{
+   const Int_t n = 3000;
+   TRandom3 rng(42);
+   std::vector<Double_t> x(n), y(n), z(n), w(n);
+   for (Int_t i = 0; i < n; ++i) {
+      x[i] = rng.Gaus(0, 2);
+      y[i] = rng.Uniform(-1, 11);
+      z[i] = rng.Exp(3);
+      w[i] = (i % 7 == 0) ? 1. : rng.Uniform(0.5, 2);
+   }
+   x[10] = 5.;   // on the upper edge
+   y[11] = 4.;   // on a variable bin edge
+   const Double_t edges[] = {0., 1., 1.5, 4., 4., 7., 10.};
+
+   TH1D h1N("h1N", "", 50, -5, 5), h1("h1", "", 50, -5, 5);
+   TH1D v1N("v1N", "", 6, edges), v1("v1", "", 6, edges);
+   h1N.FillN(n, x.data(), w.data());
+   v1N.FillN(n, y.data(), nullptr);
+   for (Int_t i = 0; i < n; ++i) {
+      h1.Fill(x[i], w[i]);
+      v1.Fill(y[i]);
+   }
+   ExpectSameFill(h1N, h1);
+   ExpectSameFill(v1N, v1);
+
+   TH2D h2N("h2N", "", 20, -5, 5, 6, edges), h2("h2", "", 20, -5, 5, 6, edges);
+   h2N.FillN(n, x.data(), y.data(), w.data());
+   for (Int_t i = 0; i < n; ++i)
+      h2.Fill(x[i], y[i], w[i]);
+   ExpectSameFill(h2N, h2);
+
+   TH3D h3N("h3N", "", 10, -5, 5, 12, -1, 11, 8, 0, 8), h3("h3", "", 10, -5, 5, 12, -1, 11, 8, 0, 8);
+   h3N.FillN(n, x.data(), y.data(), z.data(), w.data());
+   for (Int_t i = 0; i < n; ++i)
+      h3.Fill(x[i], y[i], z[i], w[i]);
+   ExpectSameFill(h3N, h3);
+
+   // entries interleaved in one array, with the overflows in the statistics
+   std::vector<Double_t> xyz(3 * n);
+   for (Int_t i = 0; i < n; ++i) {
+      xyz[3 * i] = x[i];
+      xyz[3 * i + 1] = y[i];
+      xyz[3 * i + 2] = z[i];
+   }
+   TH3D s3N("s3N", "", 10, -5, 5, 12, -1, 11, 8, 0, 8), s3("s3", "", 10, -5, 5, 12, -1, 11, 8, 0, 8);
+   s3N.SetStatOverflows(TH1::EStatOverflows::kConsider);
+   s3.SetStatOverflows(TH1::EStatOverflows::kConsider);
+   s3N.FillN(n, &xyz[0], &xyz[1], &xyz[2], nullptr, 3);
+   for (Int_t i = 0; i < n; ++i)
+      s3.Fill(x[i], y[i], z[i]);
+   ExpectSameFill(s3N, s3);
+}
+
+// Merge histograms and profiles with the same axes, whose bin arrays are added directly
+TEST(TH1, MergeSameAxes)
+{
+   const Int_t n = 20000, nparts = 4;
+   TRandom3 rng(7);
+   // a large histogram, such that the merge runs on several threads with implicit MT
+   TH2D h2("h2", "", 1000, -5, 5, 600, -1, 11);
+   TProfile p1("p1", "", 40, -5, 5);
+   TList parts2, partsP;
+   parts2.SetOwner();
+   partsP.SetOwner();
+   for (Int_t part = 0; part < nparts; ++part) {
+      TH2D *h = new TH2D(TString::Format("h2_%d", part), "", 1000, -5, 5, 600, -1, 11);
+      TProfile *p = new TProfile(TString::Format("p1_%d", part), "", 40, -5, 5);
+      if (part % 2)
+         h->Sumw2();
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t x = rng.Gaus(0, 2), y = rng.Uniform(-1, 11);
+         // weights that are summed exactly in any order
+         const Double_t w = 0.5 * (1 + i % 4);
+         h->Fill(x, y, w);
+         h2.Fill(x, y, w);
+         p->Fill(x, y, w);
+         p1.Fill(x, y, w);
+      }
+      parts2.Add(h);
+      partsP.Add(p);
+   }
+   h2.Sumw2();
+
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT(4);
+#endif
+   TH2D m2("m2", "", 1000, -5, 5, 600, -1, 11);
+   TProfile mP("mP", "", 40, -5, 5);
+   m2.Merge(&parts2);
+   mP.Merge(&partsP);
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+
+   ExpectSameFill(m2, h2);
+   EXPECT_EQ(mP.GetEntries(), p1.GetEntries());
+   for (Int_t bin = 0; bin < p1.GetNcells(); ++bin) {
+      EXPECT_DOUBLE_EQ(mP.GetBinEntries(bin), p1.GetBinEntries(bin)) << "bin " << bin;
+      // the sums of w*y are added in another order
+      EXPECT_NEAR(mP.GetBinContent(bin), p1.GetBinContent(bin), 1e-10 * std::abs(p1.GetBinContent(bin))) << "bin " << bin;
+      EXPECT_NEAR(mP.GetBinError(bin), p1.GetBinError(bin), 1e-8 * p1.GetBinError(bin)) << "bin " << bin;
+   }
+
+   // integer bins saturate like AddBinContent()
+   TH1I i1("i1", "", 2, 0, 2), i2("i2", "", 2, 0, 2), i3("i3", "", 2, 0, 2);
+   i2.SetBinContent(1, 2000000000);
+   i3.SetBinContent(1, 2000000000);
+   i2.SetBinContent(2, -5);
+   i3.SetBinContent(2, 3);
+   TList partsI;
+   partsI.Add(&i2);
+   partsI.Add(&i3);
+   i1.Merge(&partsI);
+   EXPECT_EQ(2147483647, i1.GetBinContent(1));
+   EXPECT_EQ(-2, i1.GetBinContent(2));
+}
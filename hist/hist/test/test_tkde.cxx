@@ -209,3 +209,34 @@ TEST(TKDE, tkde_io_binned)
    }
 }
 
+
+/// Evaluation tests
+/// In this test we compare the FFT and tree evaluations with the direct sum of the kernels
+TEST(TKDE, tkde_evaluation)
+{
+   TRandom rndm(4357);
+   std::vector<double> v(5000);
+   for (auto &x : v) x = (rndm.Rndm() < 0.2) ? rndm.Gaus(10, 1) : rndm.Gaus(10, 4);
+
+   const char *fftOptions[] = {"Iteration:Fixed;Binning:Unbinned", "Iteration:Fixed;Binning:ForcedBinning",
+                               "Iteration:Fixed;Mirror:MirrorAsymBoth;Binning:Unbinned",
+                               "KernelType:Epanechnikov;Iteration:Fixed;Binning:Unbinned"};
+   const char *treeOptions[] = {"Iteration:Adaptive;Binning:Unbinned", "Iteration:Adaptive;Binning:ForcedBinning",
+                                "KernelType:Biweight;Iteration:Adaptive;Binning:Unbinned"};
+
+   for (auto options : fftOptions) {
+      TKDE direct(v.size(), v.data(), 0., 20., TString(options) + ";Evaluation:Direct", 1);
+      TKDE fft(v.size(), v.data(), 0., 20., TString(options) + ";Evaluation:FFT", 1);
+      double maxValue = 0;
+      for (double x = 0; x <= 20; x += 0.25) maxValue = std::max(maxValue, direct(x));
+      // the error of the grid evaluation is relative to the peak of the kernels
+      for (double x = 0; x <= 20; x += 0.25)
+         EXPECT_NEAR(direct(x), fft(x), 1.E-3 * maxValue) << options << " at " << x;
+   }
+   for (auto options : treeOptions) {
+      TKDE direct(v.size(), v.data(), 0., 20., TString(options) + ";Evaluation:Direct", 1);
+      TKDE tree(v.size(), v.data(), 0., 20., TString(options) + ";Evaluation:Tree", 1);
+      for (double x = 0; x <= 20; x += 0.25)
+         EXPECT_NEAR(direct(x), tree(x), 1.E-3 * direct(x)) << options << " at " << x;
+   }
+}
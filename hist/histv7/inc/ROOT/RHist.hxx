@@ -163,6 +163,16 @@ public:
 
    const_iterator end() const { return const_iterator(*fImpl, fImpl->GetNBinsNoOver() + 1); }
 
+   /// Create a histogram with the same title and axes, but without any
+   /// content.
+   RHist CloneEmpty() const
+   {
+      RHist ret;
+      ret.fImpl = fImpl->CloneEmpty();
+      ret.fFillFunc = fFillFunc;
+      return ret;
+   }
+
    /// Swap *this and other.
    ///
    /// Very efficient; swaps the `fImpl` pointers.
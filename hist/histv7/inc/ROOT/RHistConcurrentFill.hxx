@@ -19,7 +19,9 @@
 #include "ROOT/RSpan.hxx"
 #include "ROOT/RHistBufferedFill.hxx"
 
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace ROOT {
 namespace Experimental {
@@ -36,12 +38,15 @@ class RHistConcurrentFillManager;
 template <class HIST, int SIZE>
 class RHistConcurrentFiller: public Internal::RHistBufferedFillBase<RHistConcurrentFiller<HIST, SIZE>, HIST, SIZE> {
    RHistConcurrentFillManager<HIST, SIZE> &fManager;
+   HIST *fPartial; ///< Partial histogram owned by the manager, or nullptr if flushing into the shared one.
 
 public:
    using CoordArray_t = typename HIST::CoordArray_t;
    using Weight_t = typename HIST::Weight_t;
 
-   RHistConcurrentFiller(RHistConcurrentFillManager<HIST, SIZE> &manager): fManager(manager) {}
+   RHistConcurrentFiller(RHistConcurrentFillManager<HIST, SIZE> &manager, HIST *partial = nullptr)
+      : fManager(manager), fPartial(partial)
+   {}
 
    /// Thread-specific HIST::Fill().
    using Internal::RHistBufferedFillBase<RHistConcurrentFiller<HIST, SIZE>, HIST, SIZE>::Fill;
@@ -49,17 +54,26 @@ public:
    /// Thread-specific HIST::FillN().
    void FillN(const std::span<const CoordArray_t> xN, const std::span<const Weight_t> weightN)
    {
-      fManager.FillN(xN, weightN);
+      if (fPartial)
+         fPartial->FillN(xN, weightN);
+      else
+         fManager.FillN(xN, weightN);
    }
 
    /// Thread-specific HIST::FillN().
-   void FillN(const std::span<const CoordArray_t> xN) { fManager.FillN(xN); }
+   void FillN(const std::span<const CoordArray_t> xN)
+   {
+      if (fPartial)
+         fPartial->FillN(xN);
+      else
+         fManager.FillN(xN);
+   }
 
    static constexpr int GetNDim() { return HIST::GetNDim(); }
 
 private:
    friend class Internal::RHistBufferedFillBase<RHistConcurrentFiller<HIST, SIZE>, HIST, SIZE>;
-   void FlushImpl() { fManager.FillN(this->GetCoords(), this->GetWeights()); }
+   void FlushImpl() { FillN(this->GetCoords(), this->GetWeights()); }
 };
 
 /**
@@ -71,6 +85,15 @@ private:
  buffer calls to Fill() until the buffer is full, and then swap the buffer
  with that of the RHistConcurrentFillManager. The manager than fills the
  histogram.
+
+ How the buffers reach the histogram is chosen at construction:
+  - EFillMode::kLocked: the fillers flush into the histogram, serialized by a
+    lock. The histogram is up to date after each flush, but the threads contend
+    for the lock.
+  - EFillMode::kPartialHists: each filler flushes into its own, empty copy of
+    the histogram, without any locking. The partial histograms are added to the
+    histogram by Merge(), which is called by the destructor. The axes must not
+    grow while filling, as histograms with different binning cannot be added.
  **/
 
 template <class HIST, int SIZE = 1024>
@@ -82,14 +105,51 @@ public:
    using CoordArray_t = typename HIST::CoordArray_t;
    using Weight_t = typename HIST::Weight_t;
 
+   /// How the fillers synchronize with the histogram.
+   enum class EFillMode {
+      kLocked,      ///< Fill the histogram under a lock at each flush.
+      kPartialHists ///< Fill per-filler partial histograms, added to the histogram by Merge().
+   };
+
 private:
    HIST &fHist;
+   EFillMode fMode;
    std::mutex fFillMutex; // should become a spin lock
+   std::vector<std::unique_ptr<HIST>> fPartials; ///< Partial histograms handed out to the fillers.
 
 public:
-   RHistConcurrentFillManager(HIST &hist): fHist(hist) {}
+   RHistConcurrentFillManager(HIST &hist, EFillMode mode = EFillMode::kLocked): fHist(hist), fMode(mode) {}
+
+   /// Adds the partial histograms to the histogram; the fillers must not be
+   /// used anymore.
+   ~RHistConcurrentFillManager() { Merge(); }
+
+   EFillMode GetFillMode() const { return fMode; }
 
-   RHistConcurrentFiller<HIST, SIZE> MakeFiller() { return RHistConcurrentFiller<HIST, SIZE>{*this}; }
+   /// Create a filler for one thread. In EFillMode::kPartialHists mode, the
+   /// filler and its copies share one partial histogram, so each thread needs
+   /// its own call to MakeFiller().
+   RHistConcurrentFiller<HIST, SIZE> MakeFiller()
+   {
+      if (fMode == EFillMode::kLocked)
+         return RHistConcurrentFiller<HIST, SIZE>{*this};
+      std::lock_guard<std::mutex> lockGuard(fFillMutex);
+      fPartials.emplace_back(new HIST(fHist.CloneEmpty()));
+      return RHistConcurrentFiller<HIST, SIZE>{*this, fPartials.back().get()};
+   }
+
+   /// Add the content of the partial histograms to the histogram, and empty
+   /// them. The fillers need to be flushed before, and must not fill
+   /// concurrently. Does nothing in EFillMode::kLocked mode.
+   void Merge()
+   {
+      std::lock_guard<std::mutex> lockGuard(fFillMutex);
+      for (auto &partial : fPartials) {
+         Add(fHist, *partial);
+         HIST empty = partial->CloneEmpty();
+         partial->swap(empty);
+      }
+   }
 
    /// Thread-specific HIST::FillN().
    void FillN(const std::span<const CoordArray_t> xN, const std::span<const Weight_t> weightN)
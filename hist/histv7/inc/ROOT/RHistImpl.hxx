@@ -178,6 +178,10 @@ public:
 
    virtual std::unique_ptr<RHistImplBase> Clone() const = 0;
 
+   /// Create a histogram implementation with the same title and axes, but
+   /// without any content.
+   virtual std::unique_ptr<RHistImplBase> CloneEmpty() const = 0;
+
    /// Interface function to fill a vector or array of coordinates with
    /// corresponding weights.
    /// \note the size of `xN` and `weightN` must be the same!
@@ -745,6 +749,12 @@ public:
       return std::unique_ptr<ImplBase_t>(new RHistImpl(*this));
    }
 
+   std::unique_ptr<ImplBase_t> CloneEmpty() const override {
+      return std::apply([this](const AXISCONFIG &... axes) {
+         return std::unique_ptr<ImplBase_t>(new RHistImpl(this->GetTitle(), axes...));
+      }, fAxes);
+   }
+
    /// Retrieve the fill function for this histogram implementation, to prevent
    /// the virtual function call for high-frequency fills.
    FillFunc_t GetFillFunc() const final { 
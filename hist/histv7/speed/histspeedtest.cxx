@@ -8,6 +8,8 @@
 #include <vector>
 #include <chrono>
 #include <iostream>
+#include <thread>
+#include <algorithm>
 
 #include "TH1.h"
 #include "TH2.h"
@@ -15,6 +17,7 @@
 
 #include "ROOT/RHist.hxx"
 #include "ROOT/RHistBufferedFill.hxx"
+#include "ROOT/RHistConcurrentFill.hxx"
 
 using namespace ROOT;
 using namespace std;
@@ -736,6 +739,51 @@ void speedtest<float, 1>(size_t count)
    R6::Dim<DataType_t, kNDim>::II::Execute<R6::Dim<DataType_t, kNDim>::fill>(input, minVal, maxVal);
 }
 
+/// Fill a 2D histogram from an increasing number of threads, each filling its
+/// share of the input, once per mode of RHistConcurrentFillManager.
+void mtspeedtest(size_t count = (size_t)(1e6))
+{
+   using ExpTH2 = Experimental::RHist<2, double, STATCLASSES>;
+   using FillMgr_t = Experimental::RHistConcurrentFillManager<ExpTH2>;
+
+   std::vector<double> input;
+   input.resize(count);
+
+   double minVal = -5.0;
+   double maxVal = +5.0;
+   GenerateInput(input, minVal, maxVal, 0);
+
+   cout << '\n';
+
+   const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+   const std::pair<FillMgr_t::EFillMode, const char *> modes[] = {{FillMgr_t::EFillMode::kLocked, "locked"},
+                                                                  {FillMgr_t::EFillMode::kPartialHists, "partial hists"}};
+   for (auto mode : modes) {
+      for (unsigned nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+         ExpTH2 hist({100, minVal, maxVal}, {5, minVal, maxVal});
+         std::string title = std::string(R7::gVersion) + " 2D fills (" + mode.second + ", " +
+                             std::to_string(nThreads) + " threads)";
+         Timer t(title.c_str(), input.size() / 2);
+         FillMgr_t fillMgr(hist, mode.first);
+         std::vector<std::thread> threads;
+         const size_t nPerThread = input.size() / 2 / nThreads;
+         for (unsigned iThread = 0; iThread < nThreads; ++iThread) {
+            threads.emplace_back(
+               [&input, nPerThread, iThread](Experimental::RHistConcurrentFiller<ExpTH2, 1024> filler) {
+                  const size_t end = 2 * nPerThread * (iThread + 1);
+                  for (size_t i = 2 * nPerThread * iThread; i < end; i += 2)
+                     filler.Fill({input[i], input[i + 1]});
+               },
+               fillMgr.MakeFiller());
+         }
+         for (auto &thread : threads)
+            thread.join();
+         fillMgr.Merge();
+      }
+      cout << '\n';
+   }
+}
+
 void histspeedtest(size_t iter = 1e6, int what = 255)
 {
    if (what & 1)
@@ -746,13 +794,15 @@ void histspeedtest(size_t iter = 1e6, int what = 255)
       speedtest<double, 1>(iter);
    if (what & 8)
       speedtest<float, 1>(iter);
+   if (what & 16)
+      mtspeedtest(iter);
 }
 
 int main(int argc, char **argv)
 {
 
    size_t iter = 1e7;
-   int what = 1 | 2 | 4 | 8;
+   int what = 1 | 2 | 4 | 8 | 16;
    if (argc > 1)
       iter = atof(argv[1]);
    if (argc > 2)
@@ -3,6 +3,7 @@
 #include "ROOT/RHistConcurrentFill.hxx"
 
 #include <iostream>
+#include <cmath>
 #include <future>
 
 using namespace ROOT;
@@ -143,3 +144,41 @@ TEST(ConcurrentFillTest, FillFlush)
    EXPECT_EQ(0, (int)Filler_1.GetCoords().size());
    EXPECT_EQ(0, (int)Filler_2.GetCoords().size());
 }
+
+// Test filling per-thread partial histograms, merged by the manager
+TEST(ConcurrentFillTest, PartialHists)
+{
+   using FillMgr_t = Experimental::RHistConcurrentFillManager<Experimental::RH2D>;
+   Experimental::RH2D hist{{100, 0., 1.}, {{0., 1., 2., 3., 10.}}};
+
+   {
+      FillMgr_t fillMgr(hist, FillMgr_t::EFillMode::kPartialHists);
+      EXPECT_EQ(FillMgr_t::EFillMode::kPartialHists, fillMgr.GetFillMode());
+
+      std::array<std::thread, 4> threads;
+      for (auto &thr : threads)
+         thr = std::thread(fillWithoutWeight, fillMgr.MakeFiller());
+      for (auto &thr : threads)
+         thr.join();
+
+      // Nothing reaches the histogram before the merge.
+      EXPECT_EQ(0, hist.GetEntries());
+      fillMgr.Merge();
+      EXPECT_EQ(4 * 3000, hist.GetEntries());
+      EXPECT_FLOAT_EQ(4.f, hist.GetBinContent({(double)42 / 100, (double)42 / 10}));
+
+      // Merging again does not add the partial histograms twice.
+      fillMgr.Merge();
+      EXPECT_EQ(4 * 3000, hist.GetEntries());
+
+      for (auto &thr : threads)
+         thr = std::thread(fillWithWeights, fillMgr.MakeFiller());
+      for (auto &thr : threads)
+         thr.join();
+   }
+
+   // The destructor merged the second round.
+   EXPECT_EQ(2 * (4 * 3000), hist.GetEntries());
+   EXPECT_FLOAT_EQ(4 * (1.f + 42.f), hist.GetBinContent({(double)42 / 100, (double)42 / 10}));
+   EXPECT_FLOAT_EQ(std::sqrt(4 * (1.f + 42.f * 42.f)), hist.GetBinUncertainty({(double)42 / 100, (double)42 / 10}));
+}
@@ -0,0 +1,83 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2020, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RSharedPayloadCache
+#define ROOT_RSharedPayloadCache
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ROOT {
+namespace Internal {
+
+/**
+ * \class RSharedPayloadCache RSharedPayloadCache.hxx
+ * \ingroup IO
+ *
+ * The decompressed payloads of the keys and baskets of a file, shared between the processes of a
+ * node through a named POSIX shared memory segment. The segment holds a lookup table indexed by the
+ * position of the key in the file, followed by the payloads. Each payload is tagged with the date
+ * and cycle of its key (see MakeVersion()), so that a key rewritten at the same position by a
+ * process updating the file is not mistaken for the published one. The first process to decompress a
+ * payload publishes it; the others copy it from the segment instead of decompressing it again.
+ * Published payloads are never modified, a segment attached read-only is only looked up.
+ *
+ * The segments are not supported on Windows: Attach() returns nullptr.
+ */
+class RSharedPayloadCache {
+private:
+   struct RHeader;
+   struct RSlot;
+
+   std::string fName;       ///< Name of the shared memory segment
+   char *fBase = nullptr;   ///< Start of the mapped segment
+   std::size_t fSize = 0;   ///< Size of the mapped segment
+   bool fReadOnly = false;  ///< Whether payloads may be published
+
+   RSharedPayloadCache(const std::string &name, char *base, std::size_t size, bool readOnly)
+      : fName(name), fBase(base), fSize(size), fReadOnly(readOnly)
+   {
+   }
+
+   RHeader &GetHeader() const { return *reinterpret_cast<RHeader *>(fBase); }
+   RSlot *GetSlots() const;
+
+public:
+   RSharedPayloadCache(const RSharedPayloadCache &) = delete;
+   RSharedPayloadCache &operator=(const RSharedPayloadCache &) = delete;
+   ~RSharedPayloadCache();
+
+   /// Map the segment 'name', creating it with 'size' bytes if it does not exist yet.
+   static std::unique_ptr<RSharedPayloadCache> Attach(const std::string &name, std::size_t size, bool readOnly);
+   /// Remove the segment 'name'; the processes which attached it keep their mapping.
+   static bool Unlink(const std::string &name);
+
+   /// Identify the content of a key from its date (TDatime::Get()) and cycle.
+   static std::uint64_t MakeVersion(std::uint32_t datime, std::int16_t cycle)
+   {
+      return (std::uint64_t(datime) << 16) | std::uint16_t(cycle);
+   }
+
+   /// Return the payload of the key at 'seek' if it was published for 'version' with 'len' bytes, nullptr otherwise.
+   const char *Find(std::int64_t seek, std::uint64_t version, int len) const;
+   /// Publish the payload of the key at 'seek'; return false if it is already there or does not fit.
+   bool Insert(std::int64_t seek, std::uint64_t version, const char *payload, int len);
+
+   const std::string &GetName() const { return fName; }
+   std::size_t GetSize() const { return fSize; }
+   bool IsReadOnly() const { return fReadOnly; }
+};
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -15,6 +15,7 @@
 #include "TFileMerger.h"
 #include "TMemFile.h"
 
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -25,6 +26,24 @@ namespace Experimental {
 
 class TBufferMergerFile;
 
+/**
+ * \struct TBufferMergerStats TBufferMerger.hxx
+ * \ingroup IO
+ *
+ * Counters describing the activity of a TBufferMerger, see TBufferMerger::GetStats().
+ */
+
+struct TBufferMergerStats {
+   size_t fPeakQueueSize{0};   //< Largest number of buffers waiting in the queue
+   size_t fPeakQueuedBytes{0}; //< Largest number of bytes queued or being merged
+   size_t fMergedBuffers{0};   //< Number of buffers merged into the output file
+   size_t fMergedBytes{0};     //< Number of bytes merged into the output file
+   size_t fMerges{0};          //< Number of partial merges performed
+   double fMergeTime{0.};      //< Time spent merging, in seconds
+   size_t fBlockedWrites{0};   //< Number of TBufferMergerFile::Write calls that had to wait for the queue
+   double fBlockedTime{0.};    //< Time spent by writers waiting for the queue, in seconds
+};
+
 /**
  * \class TBufferMerger TBufferMerger.hxx
  * \ingroup IO
@@ -70,6 +89,18 @@ public:
    /** Returns the number of buffers currently in the queue. */
    size_t GetQueueSize() const;
 
+   /** Returns the number of bytes currently queued or being merged. */
+   size_t GetQueuedBytes() const;
+
+   /** Returns the current limit on the number of queued bytes (default = 0, no limit). */
+   size_t GetMaxQueuedBytes() const;
+
+   /** Returns a snapshot of the queue and merge statistics. */
+   TBufferMergerStats GetStats() const;
+
+   /** Returns whether trees are always merged by appending their compressed baskets. */
+   bool GetKeepCompression() const;
+
    /** Returns the current value of the auto save setting in bytes (default = 0). */
    size_t GetAutoSave() const;
 
@@ -86,6 +117,24 @@ public:
     */
    void SetAutoSave(size_t size);
 
+   /** Limits the memory held by the merge queue. When pushing a buffer would
+    *  take the bytes queued or being merged above size, TBufferMergerFile::Write
+    *  merges the queue itself, or blocks until the merge in progress is done.
+    *  A single buffer larger than the limit is still accepted when the queue is
+    *  empty. A value of 0 (the default) means no limit.
+    */
+   void SetMaxQueuedBytes(size_t size);
+
+   /** By default trees are merged by appending their compressed baskets to
+    *  the output (TTreeCloner fast cloning) only when the TBufferMergerFile has
+    *  the same compression settings as the output file; otherwise the entries
+    *  are read and recompressed. With keep = true the baskets are always
+    *  appended as they are, so that writers can for instance use a faster
+    *  compression than the output file without the merging thread having to
+    *  decompress anything.
+    */
+   void SetKeepCompression(bool keep);
+
    /** Sets the merge options. SetMergeOptions("fast") will disable
     * recompression of input data into the output if they have different
     * compression settings.
@@ -112,9 +161,15 @@ private:
 
    size_t fAutoSave{0};                                          //< AutoSave only every fAutoSave bytes
    size_t fBuffered{0};                                          //< Number of bytes currently buffered
+   size_t fMaxQueuedBytes{0};                                    //< Limit on fQueuedBytes, 0 for no limit
+   size_t fQueuedBytes{0};                                       //< Number of bytes queued or being merged
+   bool fMerging{false};                                         //< True while a thread is merging
+   bool fKeepCompression{false};                                 //< Always merge trees by appending their baskets
+   TBufferMergerStats fStats;                                    //< Queue and merge statistics
    TFileMerger fMerger{false, false};                            //< TFileMerger used to merge all buffers
    std::mutex fMergeMutex;                                       //< Mutex used to lock fMerger
-   std::mutex fQueueMutex;                                       //< Mutex used to lock fQueue
+   mutable std::mutex fQueueMutex;                               //< Mutex used to lock fQueue and the counters
+   std::condition_variable fQueueCondition;                      //< Signals the end of a merge to blocked writers
    std::queue<TBufferFile *> fQueue;                             //< Queue to which data is pushed and merged
    std::vector<std::weak_ptr<TBufferMergerFile>> fAttachedFiles; //< Attached files
 };
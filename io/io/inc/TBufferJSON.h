@@ -44,6 +44,7 @@ public:
      kZeroSuppression = 10,          ///< if array has much zeros in begin and/or end, they will be removed
      kSameSuppression = 20,          ///< zero suppression plus compress many similar values together
      kBase64          = 30,          ///< all binary arrays will be compressed with base64 coding, supported by JSROOT
+     kBinaryBlocks    = 40,          ///< arrays stored as raw blocks after JSON, see ConvertToBinaryJSON(), supported by JSROOT
 
      kSkipTypeInfo  = 100            // do not store typenames in JSON
    };
@@ -65,6 +66,13 @@ public:
    ConvertToJSON(const void *obj, const TClass *cl, Int_t compact = 0, const char *member_name = nullptr);
    static TString ConvertToJSON(const void *obj, TDataMember *member, Int_t compact = 0, Int_t arraylen = -1);
 
+   static std::string ConvertToBinaryJSON(const TObject *obj, Int_t compact = 0, const char *member_name = nullptr);
+   static std::string
+   ConvertToBinaryJSON(const void *obj, const TClass *cl, Int_t compact = 0, const char *member_name = nullptr);
+
+   /// Raw array blocks referenced by the JSON code in kBinaryBlocks mode
+   const std::vector<char> &GetBinaryBlocks() const { return fBinaryBlocks; }
+
    static Int_t ExportToFile(const char *filename, const TObject *obj, const char *option = nullptr);
    static Int_t ExportToFile(const char *filename, const void *obj, const TClass *cl, const char *option = nullptr);
 
@@ -298,6 +306,8 @@ protected:
 
    void JsonPushValue();
 
+   Long64_t JsonAppendBinaryBlock(const void *data, Long64_t nbytes);
+
    template <typename T>
    R__ALWAYS_INLINE void JsonWriteArrayCompress(const T *vname, Int_t arrsize, const char *typname);
 
@@ -324,6 +334,7 @@ protected:
    TString fSemicolon;                 ///<!  depending from compression level, " : " or ":"
    Int_t fArrayCompact{0};             ///<!  0 - no array compression, 1 - exclude leading/trailing zeros, 2 - check value repetition
    TString fArraySepar;                ///<!  depending from compression level, ", " or ","
+   std::vector<char> fBinaryBlocks;    ///<!  raw array blocks in kBinaryBlocks mode, 8-byte aligned
    TString fNumericLocale;             ///<!  stored value of setlocale(LC_NUMERIC), which should be recovered at the end
    TString fTypeNameTag;               ///<! JSON member used for storing class name, when empty - no class name will be stored
    TString fTypeVersionTag;            ///<! JSON member used to store class version, default empty
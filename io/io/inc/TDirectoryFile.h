@@ -29,8 +29,16 @@
 class TKey;
 class TFile;
 
+namespace ROOT {
+namespace Internal {
+class RKeyIndex;
+}
+}
+
 class TDirectoryFile : public TDirectory {
 
+   friend class TKey;
+
 protected:
    Bool_t      fModified{kFALSE};        ///< True if directory has been modified
    Bool_t      fWritable{kFALSE};        ///< True if directory is writable
@@ -44,8 +52,14 @@ protected:
    Long64_t    fSeekKeys{0};             ///< Location of Keys record on file
    TFile      *fFile{nullptr};           ///< Pointer to current file in memory
    TList      *fKeys{nullptr};           ///< Pointer to keys list in memory
+   mutable ROOT::Internal::RKeyIndex *fKeyIndex{nullptr}; ///<! Compact index of keys not yet loaded in fKeys
 
    void        CleanTargets();
+   void        DropKeyIndex();
+   TKey       *GetKeyFromIndex(const char *name, Short_t cycle, Bool_t exactCycle) const;
+   Int_t       GetNkeysOfClass(const char *classname) const;
+   void        LoadAllKeys() const;
+   void        RemoveKey(TKey *key);
    void        InitDirectoryFile(TClass *cl = nullptr);
    void        BuildDirectoryFile(TFile* motherFile, TDirectory* motherDir);
 
@@ -90,10 +104,10 @@ public:
    const TDatime      &GetCreationDate() const { return fDatimeC; }
            TFile      *GetFile() const override { return fFile; }
            TKey       *GetKey(const char *name, Short_t cycle=9999) const override;
-           TList      *GetListOfKeys() const override { return fKeys; }
+           TList      *GetListOfKeys() const override { if (fKeyIndex) LoadAllKeys(); return fKeys; }
    const TDatime      &GetModificationDate() const { return fDatimeM; }
            Int_t       GetNbytesKeys() const override { return fNbytesKeys; }
-           Int_t       GetNkeys() const override { return fKeys->GetSize(); }
+           Int_t       GetNkeys() const override;
            Long64_t    GetSeekDir() const override { return fSeekDir; }
            Long64_t    GetSeekParent() const override { return fSeekParent; }
            Long64_t    GetSeekKeys() const override { return fSeekKeys; }
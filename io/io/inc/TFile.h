@@ -51,9 +51,23 @@ class TProcessID;
 class TStopwatch;
 class TFilePrefetch;
 
+namespace ROOT {
+namespace Internal {
+class RSharedPayloadCache;
+class RZstdDictionary;
+struct RZstdFileDictionaries;
+struct RStreamerInfoRecordCache;
+struct RConcurrentReadState;
+/// Number of StreamerInfo records found already read when opening a file (used by the tests).
+Long64_t GetStreamerInfoRecordCacheHits();
+} // namespace Internal
+} // namespace ROOT
+
 class TFile : public TDirectoryFile {
   friend class TDirectoryFile;
   friend class TFilePrefetch;
+  friend class TFileCacheWrite;
+  friend Long64_t ROOT::Internal::GetStreamerInfoRecordCacheHits();
 // TODO: We need to make sure only one TBasket is being written at a time
 // if we are writing multiple baskets in parallel.
 #ifdef R__USE_IMT
@@ -112,11 +126,14 @@ protected:
 
    TList           *fInfoCache{nullptr};      ///<!Cached list of the streamer infos in this file
    TList           *fOpenPhases{nullptr};     ///<!Time info about open phases
+   ROOT::Internal::RZstdFileDictionaries *fZstdDictionaries{nullptr}; ///<!ZSTD dictionaries used by this file
+   ROOT::Internal::RSharedPayloadCache *fSharedPayloads{nullptr}; ///<!Decompressed payloads shared with other processes
+   ROOT::Internal::RConcurrentReadState *fConcurrentRead{nullptr}; ///<!Set if the file was opened with "READ_CONCURRENT"
 
 #ifdef R__USE_IMT
    std::mutex                                 fWriteMutex;  ///<!Lock for writing baskets / keys into the file.
-   static ROOT::Internal::RConcurrentHashColl fgTsSIHashes; ///<!TS Set of hashes built from read streamer infos
 #endif
+   static ROOT::Internal::RStreamerInfoRecordCache fgStreamerInfoRecords; ///<!TS StreamerInfo records already read, by hash of their content
 
    static TList    *fgAsyncOpenRequests; //List of handles for pending open requests
 
@@ -157,6 +174,7 @@ protected:
    virtual Int_t       SysOpen(const char *pathname, Int_t flags, UInt_t mode);
    virtual Int_t       SysClose(Int_t fd);
    virtual Int_t       SysRead(Int_t fd, void *buf, Int_t len);
+   virtual Int_t       SysReadAt(Int_t fd, void *buf, Int_t len, Long64_t offset);
    virtual Int_t       SysWrite(Int_t fd, const void *buf, Int_t len);
    virtual Long64_t    SysSeek(Int_t fd, Long64_t offset, Int_t whence);
    virtual Int_t       SysStat(Int_t fd, Long_t *id, Long64_t *size, Long_t *flags, Long_t *modtime);
@@ -197,6 +215,10 @@ public:
    TFile(const char *fname, Option_t *option="", const char *ftitle="", Int_t compress = ROOT::RCompressionSetting::EDefaults::kUseCompiledDefault);
    virtual ~TFile();
 
+           Int_t       AddZstdDictionary(const void *content, Int_t size, const char *classname = nullptr);
+           void        AddZstdDictionary(const ROOT::Internal::RZstdDictionary &dict, const char *classname = nullptr);
+           void        AddZstdDictionaries(const TFile &other);
+           Bool_t      AttachSharedMemory(Long64_t size = 0, Bool_t readOnly = kFALSE);
            void        Close(Option_t *option="") override; // *MENU*
            void        Copy(TObject &) const override { MayNotUse("Copy(TObject &)"); }
    virtual Bool_t      Cp(const char *dst, Bool_t progressbar = kTRUE,UInt_t buffersize = 1000000);
@@ -230,10 +252,10 @@ public:
    virtual Int_t       GetNfree() const { return fFree->GetSize(); }
    virtual Int_t       GetNProcessIDs() const { return fNProcessIDs; }
            Option_t   *GetOption() const override { return fOption.Data(); }
-   virtual Long64_t    GetBytesRead() const { return fBytesRead; }
+   virtual Long64_t    GetBytesRead() const;
    virtual Long64_t    GetBytesReadExtra() const { return fBytesReadExtra; }
    virtual Long64_t    GetBytesWritten() const;
-   virtual Int_t       GetReadCalls() const { return fReadCalls; }
+   virtual Int_t       GetReadCalls() const;
            Int_t       GetVersion() const { return fVersion; }
            Int_t       GetRecordHeader(char *buf, Long64_t first, Int_t maxbytes,
                                        Int_t &nbytes, Int_t &objlen, Int_t &keylen);
@@ -244,11 +266,14 @@ public:
    virtual Long64_t    GetSeekFree() const {return fSeekFree;}
    virtual Long64_t    GetSeekInfo() const {return fSeekInfo;}
    virtual Long64_t    GetSize() const;
+   ROOT::Internal::RSharedPayloadCache *GetSharedPayloads() const { return fSharedPayloads; }
+   const ROOT::Internal::RZstdDictionary *GetZstdDictionaryForKey(const char *classname, const char *buffer, Int_t size);
    virtual TList      *GetStreamerInfoList() final; // Note: to override behavior, please override GetStreamerInfoListImpl
    const   TList      *GetStreamerInfoCache();
    virtual void        IncrementProcessIDs() { fNProcessIDs++; }
    virtual Bool_t      IsArchive() const { return fIsArchive; }
            Bool_t      IsBinary() const { return TestBit(kBinaryFile); }
+           Bool_t      IsConcurrentRead() const { return fConcurrentRead != nullptr; }
            Bool_t      IsRaw() const { return !fIsRootFile; }
    virtual Bool_t      IsOpen() const;
            void        ls(Option_t *option="") const override;
@@ -280,9 +305,11 @@ public:
    virtual void        SetOffset(Long64_t offset, ERelativeTo pos = kBeg);
    virtual void        SetOption(Option_t *option=">") { fOption = option; }
    virtual void        SetReadCalls(Int_t readcalls = 0) { fReadCalls = readcalls; }
+           void        SetZstdDictionaryTraining(Int_t capacity = 16384);
    virtual void        ShowStreamerInfo();
            Int_t       Sizeof() const override;
            void        SumBuffer(Int_t bufsize);
+           Bool_t      UnlinkSharedMemory();
    virtual Bool_t      WriteBuffer(const char *buf, Int_t len);
            Int_t       Write(const char *name=nullptr, Int_t opt=0, Int_t bufsiz=0) override;
            Int_t       Write(const char *name=nullptr, Int_t opt=0, Int_t bufsiz=0) const override;
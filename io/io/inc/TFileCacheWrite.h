@@ -15,6 +15,15 @@
 #include "TObject.h"
 
 class TFile;
+class TFileCacheWrite;
+
+namespace ROOT {
+namespace Internal {
+class RFileWriteBehind;
+/// Hold back the writes of the write-behind thread of 'cache', or let them go on (used by the tests).
+void SuspendWriteBehind(TFileCacheWrite &cache, bool suspend);
+}
+} // namespace ROOT
 
 class TFileCacheWrite : public TObject {
 
@@ -25,11 +34,18 @@ protected:
    TFile        *fFile;           ///< Pointer to file
    char         *fBuffer;         ///< [fBufferSize] buffer of contiguous prefetched blocks
    Bool_t        fRecursive;      ///< flag to avoid recursive calls
+   ROOT::Internal::RFileWriteBehind *fWriteBehind; ///<! Background writer of the full buffers, if enabled
 
 private:
+   friend void ROOT::Internal::SuspendWriteBehind(TFileCacheWrite &, bool);
+
    TFileCacheWrite(const TFileCacheWrite &) = delete;            //cannot be copied
    TFileCacheWrite& operator=(const TFileCacheWrite &) = delete;
 
+   Bool_t        CheckWriteBehind(const char *where);
+   Bool_t        SubmitBuffer(Int_t nbytes);
+   Int_t         WriteBufferBehind(const char *buf, Long64_t pos, Int_t len);
+
 public:
    TFileCacheWrite();
    TFileCacheWrite(TFile *file, Int_t buffersize);
@@ -40,6 +56,9 @@ public:
    virtual Int_t       ReadBuffer(char *buf, Long64_t pos, Int_t len);
    virtual Int_t       WriteBuffer(const char *buf, Long64_t pos, Int_t len);
    virtual void        SetFile(TFile *file);
+           Bool_t      SetWriteBehind(Int_t maxInFlight = 4);
+           Bool_t      IsWriteBehind() const { return fWriteBehind != nullptr; }
+           Int_t       GetWriteBehindInFlight() const;
 
    ClassDef(TFileCacheWrite,1)  //TFile cache when writing
 };
@@ -52,8 +52,12 @@ protected:
    TString        fObjectNames;               ///< List of object names to be either merged exclusively or skipped
    TList          fMergeList;                 ///< list of TObjString containing the name of the files need to be merged
    TList          fExcessFiles;               ///<! List of TObjString containing the name of the files not yet added to fFileList due to user or system limitiation on the max number of files opened.
+   Bool_t         fParallelMerge{kFALSE};     ///<! True if objects are merged in parallel and the next input files are opened while merging (default is kFALSE)
 
+   Int_t          GetMaxFilesPerBatch() const;
    Bool_t         OpenExcessFiles();
+   Bool_t         OpenExcessFiles(TList &files);
+   void           AdoptExcessFiles(TList &files);
    virtual Bool_t AddFile(TFile *source, Bool_t own, Bool_t cpProgress);
    virtual Bool_t MergeRecursive(TDirectory *target, TList *sourcelist, Int_t type = kRegular | kAll);
 
@@ -84,6 +88,8 @@ public:
    TFile      *GetOutputFile() const { return fOutputFile; }
    Int_t       GetMaxOpenedFiles() const { return fMaxOpenedFiles; }
    void        SetMaxOpenedFiles(Int_t newmax);
+   Bool_t      GetParallelMerge() const { return fParallelMerge; }
+   void        SetParallelMerge(Bool_t enabled = kTRUE);
    const char *GetMsgPrefix() const { return fMsgPrefix; }
    void        SetMsgPrefix(const char *prefix);
    const char *GetMergeOptions() { return fMergeOptions; }
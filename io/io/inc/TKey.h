@@ -25,6 +25,12 @@ class TBrowser;
 class TDirectory;
 class TFile;
 
+namespace ROOT {
+namespace Internal {
+class RZstdDictionary;
+}
+} // namespace ROOT
+
 class TKey : public TNamed {
 
 private:
@@ -55,6 +61,9 @@ protected:
    virtual void     Create(Int_t nbytes, TFile* f = 0);
            void     Build(TDirectory* motherDir, const char* classname, Long64_t filepos);
            void     Reset(); // Currently only for the use of TBasket.
+   static  Int_t    GetZipThreads(Int_t nbytes);
+           Int_t    UnzipObject(UChar_t *compressed, char *objbuf);
+   const ROOT::Internal::RZstdDictionary *GetZstdDictionary(Int_t algorithm, const char *buffer, Int_t nbytes);
    virtual Int_t    WriteFileKeepBuffer(TFile *f = 0);
 
 
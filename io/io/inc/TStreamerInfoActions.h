@@ -12,12 +12,15 @@
 #ifndef ROOT_TStreamerInfoActions
 #define ROOT_TStreamerInfoActions
 
+#include <atomic>
 #include <vector>
 #include <ROOT/RMakeUnique.hxx>
 
 #include "TStreamerInfo.h"
 #include "TVirtualArray.h"
 
+class TBufferFile;
+
 /**
 \class TStreamerInfoActions::TConfiguration
 \ingroup IO
@@ -182,19 +185,44 @@ namespace TStreamerInfoActions {
 
       template <typename action_t>
       void AddAction( action_t action, TConfiguration *conf ) {
+         ResetJIT();
          fActions.push_back( TConfiguredAction(action, conf) );
       }
       void AddAction(const TConfiguredAction &action ) {
+         ResetJIT();
          fActions.push_back( action );
       }
 
+      /// Signature of the actions called back by a cling-compiled sequence.
+      using JITApply_t = Int_t (*)(TBuffer &buf, void *obj, const TActionSequence *sequence, Int_t index);
+      /// Signature of a cling-compiled sequence, see JITCompile.
+      using JITAction_t = void (*)(TBufferFile &buf, char *obj, const TActionSequence *sequence, JITApply_t apply);
+
+      enum EJITState { kJITNotTried, kJITNotUsed, kJITCompiled };
+
       TVirtualStreamerInfo *fStreamerInfo; ///< StreamerInfo used to derive these actions.
       TLoopConfiguration   *fLoopConfig;   ///< If this is a bundle of memberwise streaming action, this configures the looping
       ActionContainer_t     fActions;
+      std::atomic<JITAction_t> fJITAction{nullptr}; ///<! Cling-compiled version of fActions, if any.
+      std::atomic<Int_t>    fJITState{kJITNotTried}; ///<! Whether JITCompile was already called (EJITState).
 
       void AddToOffset(Int_t delta);
       void SetMissing();
 
+      Bool_t JITCompile();
+      /// Drop the compiled version of the sequence, must be called whenever fActions is modified.
+      void ResetJIT()
+      {
+         if (fJITState != kJITNotTried) {
+            fJITAction = nullptr;
+            fJITState = kJITNotTried;
+         }
+      }
+      static Int_t JITApplyAction(TBuffer &buf, void *obj, const TActionSequence *sequence, Int_t index);
+      static Bool_t IsJITEnabled(const TVirtualStreamerInfo *info);
+      static Bool_t IsJITEnabledForAny();
+      static void SetJITClasses(const char *classes);
+
       TActionSequence *CreateCopy();
       static TActionSequence *CreateReadMemberWiseActions(TVirtualStreamerInfo *info, TVirtualCollectionProxy &proxy);
       static TActionSequence *CreateWriteMemberWiseActions(TVirtualStreamerInfo *info, TVirtualCollectionProxy &proxy);
@@ -253,8 +281,9 @@ namespace TStreamerInfoActions {
          return {seq, kFALSE};
       }
       static SequencePtr ReadMemberWiseActionsCollectionCreator(TStreamerInfo *info, TVirtualCollectionProxy *collectionProxy, TClass * /* originalClass */) {
-         auto seq = TStreamerInfoActions::TActionSequence::CreateReadMemberWiseActions(info,*collectionProxy);
-         return {seq, kTRUE};
+         // Shared through the StreamerInfo, the loop configuration refers to a copy of collectionProxy.
+         auto seq = info->GetCollectionMemberWiseActions(*collectionProxy, kTRUE);
+         return {seq, kFALSE};
       }
       // Creator5() = Creator1;
       static SequencePtr ReadMemberWiseActionsGetter(TStreamerInfo *info, TVirtualCollectionProxy * /* collectionProxy */, TClass * /* originalClass */) {
@@ -271,8 +300,9 @@ namespace TStreamerInfoActions {
          return {seq, kFALSE};
       }
       static SequencePtr WriteMemberWiseActionsCollectionCreator(TStreamerInfo *info, TVirtualCollectionProxy *collectionProxy, TClass * /* originalClass */) {
-         auto seq = TStreamerInfoActions::TActionSequence::CreateWriteMemberWiseActions(info,*collectionProxy);
-         return {seq, kTRUE};
+         // Shared through the StreamerInfo, the loop configuration refers to a copy of collectionProxy.
+         auto seq = info->GetCollectionMemberWiseActions(*collectionProxy, kFALSE);
+         return {seq, kFALSE};
       }
       // Creator5() = Creator1;
       static SequencePtr WriteMemberWiseActionsGetter(TStreamerInfo *info, TVirtualCollectionProxy * /* collectionProxy */, TClass * /* originalClass */) {
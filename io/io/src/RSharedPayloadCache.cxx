@@ -0,0 +1,225 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2020, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/RConfig.hxx"
+#include "ROOT/RSharedPayloadCache.hxx"
+
+#include "TError.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifndef R__WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr char kMagic[8] = {'R', 'O', 'O', 'T', 'S', 'P', 'C', '2'};
+constexpr std::size_t kHeaderSize = 64;   // The lookup table starts on its own cache line
+constexpr std::uint32_t kMaxProbes = 64;  // Give up on an insertion or a lookup after that many slots
+constexpr int kAttachTimeout = 5000;      // Milliseconds to wait for the creator to initialize the segment
+enum : std::uint32_t { kSlotFilling = 0, kSlotReady = 1, kSlotAbandoned = 2 };
+
+std::uint32_t HashKey(std::uint64_t key)
+{
+   return static_cast<std::uint32_t>((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+} // anonymous namespace
+
+/// Layout of the beginning of the segment. The segment is zero-initialized by the system
+/// and is only used through atomic operations by the processes sharing it.
+struct ROOT::Internal::RSharedPayloadCache::RHeader {
+   char fMagic[8];
+   std::atomic<std::uint32_t> fReady;    ///< Set once the creator initialized the header
+   std::uint32_t fNSlots;                ///< Size of the lookup table, a power of two
+   std::uint64_t fDataBegin;             ///< Offset of the payloads in the segment
+   std::atomic<std::uint64_t> fDataUsed; ///< Bytes of the payload area handed out so far
+};
+
+/// Entry of the lookup table; fLen, fOffset and fVersion are valid once fState is kSlotReady.
+struct ROOT::Internal::RSharedPayloadCache::RSlot {
+   std::atomic<std::uint64_t> fKey;   ///< Position of the key in the file plus one, 0 if the slot is free
+   std::atomic<std::uint32_t> fState; ///< kSlotFilling, kSlotReady or kSlotAbandoned
+   std::uint32_t fLen;                ///< Length of the payload
+   std::uint64_t fOffset;             ///< Position of the payload in the payload area
+   std::uint64_t fVersion;            ///< Date and cycle of the key, see MakeVersion()
+};
+
+ROOT::Internal::RSharedPayloadCache::RSlot *ROOT::Internal::RSharedPayloadCache::GetSlots() const
+{
+   static_assert(sizeof(RHeader) <= kHeaderSize, "The header overlaps the lookup table");
+   return reinterpret_cast<RSlot *>(fBase + kHeaderSize);
+}
+
+ROOT::Internal::RSharedPayloadCache::~RSharedPayloadCache()
+{
+#ifndef R__WIN32
+   munmap(fBase, fSize);
+#endif
+}
+
+std::unique_ptr<ROOT::Internal::RSharedPayloadCache>
+ROOT::Internal::RSharedPayloadCache::Attach(const std::string &name, std::size_t size, bool readOnly)
+{
+#ifdef R__WIN32
+   (void)name;
+   (void)size;
+   (void)readOnly;
+   return nullptr;
+#else
+   // Use a slot for every 4 kB of payloads.
+   std::uint32_t nslots = 64;
+   while (nslots < size / 4096 && nslots < (1u << 30))
+      nslots *= 2;
+   const std::size_t dataBegin = kHeaderSize + nslots * sizeof(RSlot);
+
+   bool create = false;
+   int fd = -1;
+   if (!readOnly) {
+      if (size < 2 * dataBegin) {
+         Error("RSharedPayloadCache::Attach", "%zu bytes are too few for the shared memory segment %s", size,
+               name.c_str());
+         return nullptr;
+      }
+      fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+      create = fd >= 0;
+   }
+   if (fd < 0)
+      fd = shm_open(name.c_str(), readOnly ? O_RDONLY : O_RDWR, 0);
+   if (fd < 0) {
+      Error("RSharedPayloadCache::Attach", "cannot open the shared memory segment %s: %s", name.c_str(),
+            strerror(errno));
+      return nullptr;
+   }
+
+   struct stat info;
+   if (create) {
+      if (ftruncate(fd, size) != 0) {
+         Error("RSharedPayloadCache::Attach", "cannot size the shared memory segment %s: %s", name.c_str(),
+               strerror(errno));
+         close(fd);
+         shm_unlink(name.c_str());
+         return nullptr;
+      }
+   } else {
+      // The creator might not have sized the segment yet.
+      for (int waited = 0; fstat(fd, &info) == 0 && info.st_size < (off_t)kHeaderSize; ++waited) {
+         if (waited == kAttachTimeout) {
+            Error("RSharedPayloadCache::Attach", "the shared memory segment %s is not initialized", name.c_str());
+            close(fd);
+            return nullptr;
+         }
+         usleep(1000);
+      }
+      size = info.st_size;
+   }
+
+   void *base = mmap(nullptr, size, readOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   close(fd);
+   if (base == MAP_FAILED) {
+      Error("RSharedPayloadCache::Attach", "cannot map the shared memory segment %s: %s", name.c_str(),
+            strerror(errno));
+      return nullptr;
+   }
+   std::unique_ptr<RSharedPayloadCache> cache(new RSharedPayloadCache(name, (char *)base, size, readOnly));
+
+   RHeader &header = cache->GetHeader();
+   if (create) {
+      memcpy(header.fMagic, kMagic, sizeof(kMagic));
+      header.fNSlots = nslots;
+      header.fDataBegin = dataBegin;
+      header.fReady.store(1, std::memory_order_release);
+      return cache;
+   }
+
+   for (int waited = 0; header.fReady.load(std::memory_order_acquire) == 0; ++waited) {
+      if (waited == kAttachTimeout) {
+         Error("RSharedPayloadCache::Attach", "the shared memory segment %s is not initialized", name.c_str());
+         return nullptr;
+      }
+      usleep(1000);
+   }
+   if (memcmp(header.fMagic, kMagic, sizeof(kMagic)) != 0 || header.fDataBegin > size ||
+       kHeaderSize + header.fNSlots * sizeof(RSlot) > header.fDataBegin) {
+      Error("RSharedPayloadCache::Attach", "%s is not a shared memory segment of decompressed payloads",
+            name.c_str());
+      return nullptr;
+   }
+   return cache;
+#endif
+}
+
+bool ROOT::Internal::RSharedPayloadCache::Unlink(const std::string &name)
+{
+#ifdef R__WIN32
+   (void)name;
+   return false;
+#else
+   return shm_unlink(name.c_str()) == 0;
+#endif
+}
+
+const char *ROOT::Internal::RSharedPayloadCache::Find(std::int64_t seek, std::uint64_t version, int len) const
+{
+   const RHeader &header = GetHeader();
+   const std::uint64_t key = seek + 1;
+   const std::uint32_t mask = header.fNSlots - 1;
+   RSlot *slots = GetSlots();
+   std::uint32_t pos = HashKey(key) & mask;
+   for (std::uint32_t i = 0; i < kMaxProbes; ++i, pos = (pos + 1) & mask) {
+      const std::uint64_t slotKey = slots[pos].fKey.load(std::memory_order_acquire);
+      if (slotKey == 0)
+         return nullptr;
+      if (slotKey != key)
+         continue;
+      if (slots[pos].fState.load(std::memory_order_acquire) != kSlotReady || slots[pos].fLen != (std::uint32_t)len ||
+          slots[pos].fVersion != version)
+         return nullptr;
+      return fBase + header.fDataBegin + slots[pos].fOffset;
+   }
+   return nullptr;
+}
+
+bool ROOT::Internal::RSharedPayloadCache::Insert(std::int64_t seek, std::uint64_t version, const char *payload, int len)
+{
+   if (fReadOnly || len <= 0)
+      return false;
+
+   RHeader &header = GetHeader();
+   const std::uint64_t key = seek + 1;
+   const std::uint32_t mask = header.fNSlots - 1;
+   RSlot *slots = GetSlots();
+   std::uint32_t pos = HashKey(key) & mask;
+   for (std::uint32_t i = 0; i < kMaxProbes; ++i, pos = (pos + 1) & mask) {
+      RSlot &slot = slots[pos];
+      std::uint64_t slotKey = slot.fKey.load(std::memory_order_acquire);
+      if (slotKey == 0 && slot.fKey.compare_exchange_strong(slotKey, key)) {
+         // The slot is ours: reserve room for the payload, other processes see it once ready.
+         const std::uint64_t offset = header.fDataUsed.fetch_add((len + 7) & ~7);
+         if (header.fDataBegin + offset + len > fSize) {
+            slot.fState.store(kSlotAbandoned, std::memory_order_release);
+            return false;
+         }
+         memcpy(fBase + header.fDataBegin + offset, payload, len);
+         slot.fLen = len;
+         slot.fOffset = offset;
+         slot.fVersion = version;
+         slot.fState.store(kSlotReady, std::memory_order_release);
+         return true;
+      }
+      if (slotKey == key)
+         return false;
+   }
+   return false;
+}
@@ -35,15 +35,6 @@ The concrete implementation of TBuffer for writing/reading to/from a ROOT file o
 #include "TInterpreter.h"
 #include "TVirtualMutex.h"
 
-#if (defined(__linux) || defined(__APPLE__)) && defined(__i386__) && \
-     defined(__GNUC__)
-#define USE_BSWAPCPY
-#endif
-
-#ifdef USE_BSWAPCPY
-#include "Bswapcpy.h"
-#endif
-
 
 const UInt_t kNewClassTag       = 0xFFFFFFFF;
 const UInt_t kClassMask         = 0x80000000;  // OR the class index with this
@@ -68,6 +59,23 @@ static inline bool Class_Has_StreamerInfo(const TClass* cl)
    return cl->GetStreamerInfos()->GetLast()>1;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read n values of type In from the buffer in chunks, byte swapping each chunk
+/// with the vectorized frombuf, and store conv(value) into out.
+
+template <typename In, typename Out, typename Convert>
+static inline void ReadConvertedArray(char *&buf, Out *out, Int_t n, Convert conv)
+{
+   constexpr Int_t kChunk = 256;
+   In tmp[kChunk];
+   for (Int_t i = 0; i < n; i += kChunk) {
+      const Int_t m = (n - i < kChunk) ? n - i : kChunk;
+      frombuf(buf, tmp, m);
+      for (Int_t j = 0; j < m; ++j)
+         out[i + j] = conv(tmp[j]);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create an I/O buffer object. Mode should be either TBuffer::kRead or
 /// TBuffer::kWrite. By default the I/O buffer has a size of
@@ -760,18 +768,7 @@ Int_t TBufferFile::ReadArray(Short_t *&h)
 
    if (!h) h = new Short_t[n];
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy16(h, fBufCur, n);
-   fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &h[i]);
-# endif
-#else
-   memcpy(h, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, h, n);
 
    return n;
 }
@@ -793,18 +790,7 @@ Int_t TBufferFile::ReadArray(Int_t *&ii)
 
    if (!ii) ii = new Int_t[n];
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(ii, fBufCur, n);
-   fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ii[i]);
-# endif
-#else
-   memcpy(ii, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, ii, n);
 
    return n;
 }
@@ -852,13 +838,7 @@ Int_t TBufferFile::ReadArray(Long64_t *&ll)
 
    if (!ll) ll = new Long64_t[n];
 
-#ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ll[i]);
-#else
-   memcpy(ll, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, ll, n);
 
    return n;
 }
@@ -880,18 +860,7 @@ Int_t TBufferFile::ReadArray(Float_t *&f)
 
    if (!f) f = new Float_t[n];
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(f, fBufCur, n);
-   fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &f[i]);
-# endif
-#else
-   memcpy(f, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, f, n);
 
    return n;
 }
@@ -913,13 +882,7 @@ Int_t TBufferFile::ReadArray(Double_t *&d)
 
    if (!d) d = new Double_t[n];
 
-#ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &d[i]);
-#else
-   memcpy(d, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, d, n);
 
    return n;
 }
@@ -1033,18 +996,7 @@ Int_t TBufferFile::ReadStaticArray(Short_t *h)
 
    if (!h) return 0;
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy16(h, fBufCur, n);
-   fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &h[i]);
-# endif
-#else
-   memcpy(h, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, h, n);
 
    return n;
 }
@@ -1065,18 +1017,7 @@ Int_t TBufferFile::ReadStaticArray(Int_t *ii)
 
    if (!ii) return 0;
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(ii, fBufCur, n);
-   fBufCur += sizeof(Int_t)*n;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ii[i]);
-# endif
-#else
-   memcpy(ii, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, ii, n);
 
    return n;
 }
@@ -1122,13 +1063,7 @@ Int_t TBufferFile::ReadStaticArray(Long64_t *ll)
 
    if (!ll) return 0;
 
-#ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ll[i]);
-#else
-   memcpy(ll, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, ll, n);
 
    return n;
 }
@@ -1149,18 +1084,7 @@ Int_t TBufferFile::ReadStaticArray(Float_t *f)
 
    if (!f) return 0;
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(f, fBufCur, n);
-   fBufCur += sizeof(Float_t)*n;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &f[i]);
-# endif
-#else
-   memcpy(f, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, f, n);
 
    return n;
 }
@@ -1181,13 +1105,7 @@ Int_t TBufferFile::ReadStaticArray(Double_t *d)
 
    if (!d) return 0;
 
-#ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &d[i]);
-#else
-   memcpy(d, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, d, n);
 
    return n;
 }
@@ -1299,18 +1217,7 @@ void TBufferFile::ReadFastArray(Short_t *h, Int_t n)
    Int_t l = sizeof(Short_t)*n;
    if (n <= 0 || l > fBufSize) return;
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy16(h, fBufCur, n);
-   fBufCur += sizeof(Short_t)*n;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &h[i]);
-# endif
-#else
-   memcpy(h, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, h, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1321,18 +1228,7 @@ void TBufferFile::ReadFastArray(Int_t *ii, Int_t n)
    Int_t l = sizeof(Int_t)*n;
    if (l <= 0 || l > fBufSize) return;
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(ii, fBufCur, n);
-   fBufCur += sizeof(Int_t)*n;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ii[i]);
-# endif
-#else
-   memcpy(ii, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, ii, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1359,13 +1255,7 @@ void TBufferFile::ReadFastArray(Long64_t *ll, Int_t n)
    Int_t l = sizeof(Long64_t)*n;
    if (l <= 0 || l > fBufSize) return;
 
-#ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ll[i]);
-#else
-   memcpy(ll, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, ll, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1376,18 +1266,7 @@ void TBufferFile::ReadFastArray(Float_t *f, Int_t n)
    Int_t l = sizeof(Float_t)*n;
    if (l <= 0 || l > fBufSize) return;
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(f, fBufCur, n);
-   fBufCur += sizeof(Float_t)*n;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &f[i]);
-# endif
-#else
-   memcpy(f, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, f, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1398,13 +1277,7 @@ void TBufferFile::ReadFastArray(Double_t *d, Int_t n)
    Int_t l = sizeof(Double_t)*n;
    if (l <= 0 || l > fBufSize) return;
 
-#ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &d[i]);
-#else
-   memcpy(d, fBufCur, l);
-   fBufCur += l;
-#endif
+   frombuf(fBufCur, d, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1419,9 +1292,7 @@ void TBufferFile::ReadFastArrayFloat16(Float_t *f, Int_t n, TStreamerElement *el
       //a range was specified. We read an integer and convert it back to a float
       Double_t xmin = ele->GetXmin();
       Double_t factor = ele->GetFactor();
-      for (int j=0;j < n; j++) {
-         UInt_t aint; *this >> aint; f[j] = (Float_t)(aint/factor + xmin);
-      }
+      ReadConvertedArray<UInt_t>(fBufCur, f, n, [=](UInt_t aint) { return (Float_t)(aint/factor + xmin); });
    } else {
       Int_t i;
       Int_t nbits = 0;
@@ -1456,9 +1327,7 @@ void TBufferFile::ReadFastArrayWithFactor(Float_t *ptr, Int_t n, Double_t factor
    if (n <= 0 || 3*n > fBufSize) return;
 
    //a range was specified. We read an integer and convert it back to a float
-   for (int j=0;j < n; j++) {
-      UInt_t aint; *this >> aint; ptr[j] = (Float_t)(aint/factor + minvalue);
-   }
+   ReadConvertedArray<UInt_t>(fBufCur, ptr, n, [=](UInt_t aint) { return (Float_t)(aint/factor + minvalue); });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1501,20 +1370,14 @@ void TBufferFile::ReadFastArrayDouble32(Double_t *d, Int_t n, TStreamerElement *
       //a range was specified. We read an integer and convert it back to a double.
       Double_t xmin = ele->GetXmin();
       Double_t factor = ele->GetFactor();
-      for (int j=0;j < n; j++) {
-         UInt_t aint; *this >> aint; d[j] = (Double_t)(aint/factor + xmin);
-      }
+      ReadConvertedArray<UInt_t>(fBufCur, d, n, [=](UInt_t aint) { return (Double_t)(aint/factor + xmin); });
    } else {
       Int_t i;
       Int_t nbits = 0;
       if (ele) nbits = (Int_t)ele->GetXmin();
       if (!nbits) {
          //we read a float and convert it to double
-         Float_t afloat;
-         for (i = 0; i < n; i++) {
-            *this >> afloat;
-            d[i] = (Double_t)afloat;
-         }
+         ReadConvertedArray<Float_t>(fBufCur, d, n, [](Float_t afloat) { return (Double_t)afloat; });
       } else {
          //we read the exponent and the truncated mantissa of the float
          //and rebuild the double.
@@ -1546,9 +1409,7 @@ void TBufferFile::ReadFastArrayWithFactor(Double_t *d, Int_t n, Double_t factor,
    if (n <= 0 || 3*n > fBufSize) return;
 
    //a range was specified. We read an integer and convert it back to a double.
-   for (int j=0;j < n; j++) {
-      UInt_t aint; *this >> aint; d[j] = (Double_t)(aint/factor + minvalue);
-   }
+   ReadConvertedArray<UInt_t>(fBufCur, d, n, [=](UInt_t aint) { return (Double_t)(aint/factor + minvalue); });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1561,11 +1422,7 @@ void TBufferFile::ReadFastArrayWithNbits(Double_t *d, Int_t n, Int_t nbits)
 
    if (!nbits) {
       //we read a float and convert it to double
-      Float_t afloat;
-      for (Int_t i = 0; i < n; i++) {
-         *this >> afloat;
-         d[i] = (Double_t)afloat;
-      }
+      ReadConvertedArray<Float_t>(fBufCur, d, n, [](Float_t afloat) { return (Double_t)afloat; });
    } else {
       //we read the exponent and the truncated mantissa of the float
       //and rebuild the double.
@@ -1732,18 +1589,7 @@ void TBufferFile::WriteArray(const Short_t *h, Int_t n)
    Int_t l = sizeof(Short_t)*n;
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy16(fBufCur, h, n);
-   fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, h[i]);
-# endif
-#else
-   memcpy(fBufCur, h, l);
-   fBufCur += l;
-#endif
+   tobuf(fBufCur, h, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1762,18 +1608,7 @@ void TBufferFile::WriteArray(const Int_t *ii, Int_t n)
    Int_t l = sizeof(Int_t)*n;
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(fBufCur, ii, n);
-   fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, ii[i]);
-# endif
-#else
-   memcpy(fBufCur, ii, l);
-   fBufCur += l;
-#endif
+   tobuf(fBufCur, ii, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1830,13 +1665,7 @@ void TBufferFile::WriteArray(const Long64_t *ll, Int_t n)
    Int_t l = sizeof(Long64_t)*n;
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
-#ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, ll[i]);
-#else
-   memcpy(fBufCur, ll, l);
-   fBufCur += l;
-#endif
+   tobuf(fBufCur, ll, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1855,18 +1684,7 @@ void TBufferFile::WriteArray(const Float_t *f, Int_t n)
    Int_t l = sizeof(Float_t)*n;
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(fBufCur, f, n);
-   fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, f[i]);
-# endif
-#else
-   memcpy(fBufCur, f, l);
-   fBufCur += l;
-#endif
+   tobuf(fBufCur, f, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1885,13 +1703,7 @@ void TBufferFile::WriteArray(const Double_t *d, Int_t n)
    Int_t l = sizeof(Double_t)*n;
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
-#ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, d[i]);
-#else
-   memcpy(fBufCur, d, l);
-   fBufCur += l;
-#endif
+   tobuf(fBufCur, d, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1998,18 +1810,7 @@ void TBufferFile::WriteFastArray(const Short_t *h, Int_t n)
    Int_t l = sizeof(Short_t)*n;
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy16(fBufCur, h, n);
-   fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, h[i]);
-# endif
-#else
-   memcpy(fBufCur, h, l);
-   fBufCur += l;
-#endif
+   tobuf(fBufCur, h, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2022,18 +1823,7 @@ void TBufferFile::WriteFastArray(const Int_t *ii, Int_t n)
    Int_t l = sizeof(Int_t)*n;
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(fBufCur, ii, n);
-   fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, ii[i]);
-# endif
-#else
-   memcpy(fBufCur, ii, l);
-   fBufCur += l;
-#endif
+   tobuf(fBufCur, ii, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2074,13 +1864,7 @@ void TBufferFile::WriteFastArray(const Long64_t *ll, Int_t n)
    Int_t l = sizeof(Long64_t)*n;
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
-#ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, ll[i]);
-#else
-   memcpy(fBufCur, ll, l);
-   fBufCur += l;
-#endif
+   tobuf(fBufCur, ll, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2093,18 +1877,7 @@ void TBufferFile::WriteFastArray(const Float_t *f, Int_t n)
    Int_t l = sizeof(Float_t)*n;
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
-#ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(fBufCur, f, n);
-   fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, f[i]);
-# endif
-#else
-   memcpy(fBufCur, f, l);
-   fBufCur += l;
-#endif
+   tobuf(fBufCur, f, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2117,13 +1890,7 @@ void TBufferFile::WriteFastArray(const Double_t *d, Int_t n)
    Int_t l = sizeof(Double_t)*n;
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
-#ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, d[i]);
-#else
-   memcpy(fBufCur, d, l);
-   fBufCur += l;
-#endif
+   tobuf(fBufCur, d, n);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3555,6 +3322,17 @@ Int_t TBufferFile::ApplySequence(const TStreamerInfoActions::TActionSequence &se
       }
 
    } else {
+      // Use the cling-compiled version of the sequence if requested, see TActionSequence::JITCompile.
+      // It calls the TBufferFile functions directly, so it cannot be used by derived classes.
+      if (sequence.fJITState == TStreamerInfoActions::TActionSequence::kJITNotTried)
+         const_cast<TStreamerInfoActions::TActionSequence &>(sequence).JITCompile();
+      if (auto jitAction = sequence.fJITAction.load()) {
+         if (IsA() == TBufferFile::Class()) {
+            jitAction(*this, (char *)obj, &sequence, &TStreamerInfoActions::TActionSequence::JITApplyAction);
+            return 0;
+         }
+      }
+
       //loop on all active members
       TStreamerInfoActions::ActionContainer_t::const_iterator end = sequence.fActions.end();
       for(TStreamerInfoActions::ActionContainer_t::const_iterator iter = sequence.fActions.begin();
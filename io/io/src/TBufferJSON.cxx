@@ -549,6 +549,8 @@ TString TBufferJSON::ConvertToJSON(const TObject *obj, Int_t compact, const char
 ///  - 0 - no compression, standard JSON array
 ///  - kZeroSuppression = 10  - exclude leading and trailing zeros
 ///  - kSameSuppression = 20 - check values repetition and empty gaps
+///  - kBase64 = 30 - arrays coded with base64
+///  - kBinaryBlocks = 40 - arrays stored as raw blocks, see TBufferJSON::ConvertToBinaryJSON()
 ///
 /// Third digit defines usage of typeinfo
 ///  - kSkipTypeInfo = 100   - "_typename" field will be skipped, reading by ROOT or JSROOT may be impossible
@@ -631,6 +633,7 @@ Bool_t TBufferJSON::IsSkipClassInfo(const TClass *cl) const
 ///  - TBufferJSON::kZeroSuppression (10) - exclude leading and trailing zeros
 ///  - TBufferJSON::kSameSuppression (20) - check values repetition and empty gaps
 ///  - TBufferJSON::kBase64 (30) - arrays will be coded with base64 coding
+///  - TBufferJSON::kBinaryBlocks (40) - arrays stored as raw blocks, only with TBufferJSON::ConvertToBinaryJSON()
 /// Third digit of compact parameter defines typeinfo storage:
 ///  - TBufferJSON::kSkipTypeInfo (100) - "_typename" will be skipped, not always can be read back
 /// Maximal none-destructive compression can be achieved when
@@ -745,6 +748,88 @@ TString TBufferJSON::ConvertToJSON(const void *ptr, TDataMember *member, Int_t c
    return buf.JsonWriteMember(ptr, member, mcl, arraylen);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Converts object, inherited from TObject class, to binary JSON message
+/// See TBufferJSON::ConvertToBinaryJSON(const void *, const TClass *, Int_t, const char *) for details
+
+std::string TBufferJSON::ConvertToBinaryJSON(const TObject *obj, Int_t compact, const char *member_name)
+{
+   TClass *clActual = nullptr;
+   void *ptr = (void *)obj;
+
+   if (obj) {
+      clActual = TObject::Class()->GetActualClass(obj);
+      if (!clActual)
+         clActual = TObject::Class();
+      else if (clActual != TObject::Class())
+         ptr = (void *)((Long_t)obj - clActual->GetBaseClassOffset(TObject::Class()));
+   }
+
+   return ConvertToBinaryJSON(ptr, clActual, compact, member_name);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Converts any type of object to binary JSON message
+/// Object structure is stored as JSON code, but content of all arrays with 6 and more elements
+/// is not formatted as text - it is copied as raw block behind JSON code (TBufferJSON::kBinaryBlocks mode).
+/// In JSON such array looks like:
+///
+///     {"$arr":"Float64","len":1000,"o":80,"bin":4096,"nb":7200}
+///
+/// where "o" is byte offset of first stored element (leading zeros are skipped),
+/// "bin" is position of the raw block in the binary section and "nb" is its size in bytes.
+/// Trailing zeros are not stored, array with only zeros has no "bin" entry.
+/// Message layout is:
+///  - 4 bytes signature "RJB1"
+///  - 4 bytes length of JSON code, little endian
+///  - JSON code, padded with spaces to 8-bytes boundary
+///  - binary section, each block starts at 8-bytes boundary
+///
+/// Raw blocks have host byte order, same as base64-coded arrays in TBufferJSON::kBase64 mode.
+/// Array compression digit of compact parameter is ignored, other digits have same meaning as in
+/// TBufferJSON::ConvertToJSON(). When member_name specified, only this data member is converted
+/// and arrays are stored as plain JSON. Such message can be decoded with JSROOT.parse() and is
+/// provided by THttpServer for "root.jbin" requests. Reading of binary JSON back in ROOT is not supported.
+
+std::string TBufferJSON::ConvertToBinaryJSON(const void *obj, const TClass *cl, Int_t compact, const char *member_name)
+{
+   if (compact < 0)
+      compact = 0;
+   compact -= ((compact / 10) % 10) * 10;
+
+   TString json;
+   std::vector<char> blocks;
+
+   if (member_name) {
+      json = ConvertToJSON(obj, cl, compact, member_name);
+   } else {
+      TClass *clActual = obj ? cl->GetActualClass(obj) : nullptr;
+      const void *actualStart = obj;
+      if (clActual && (clActual != cl))
+         actualStart = (char *)obj - clActual->GetBaseClassOffset(cl);
+      else
+         clActual = const_cast<TClass *>(cl);
+
+      TBufferJSON buf;
+      buf.SetCompact(compact + kBinaryBlocks);
+      json = buf.StoreObject(actualStart, clActual);
+      blocks = std::move(buf.fBinaryBlocks);
+   }
+
+   const std::size_t jsonlen = json.Length(), blocksStart = (8 + jsonlen + 7) & ~((std::size_t)7);
+
+   std::string res;
+   res.reserve(blocksStart + blocks.size());
+   res.append("RJB1", 4);
+   for (int n = 0; n < 4; ++n)
+      res.push_back((char)((jsonlen >> (8 * n)) & 0xff));
+   res.append(json.Data(), jsonlen);
+   res.resize(blocksStart, ' ');
+   res.append(blocks.data(), blocks.size());
+
+   return res;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Convert object into JSON and store in text file
 /// Returns size of the produce file
@@ -2523,6 +2608,18 @@ void TBufferJSON::JsonPushValue()
       Stack()->PushValue(fValue);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Append raw block to binary section, used in kBinaryBlocks mode
+/// Returns position of the block, which is always aligned to 8 bytes
+
+Long64_t TBufferJSON::JsonAppendBinaryBlock(const void *data, Long64_t nbytes)
+{
+   Long64_t pos = (fBinaryBlocks.size() + 7) & ~7LL;
+   fBinaryBlocks.resize(pos);
+   fBinaryBlocks.insert(fBinaryBlocks.end(), (const char *)data, (const char *)data + nbytes);
+   return pos;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read array of Bool_t from buffer
 
@@ -2776,6 +2873,11 @@ R__ALWAYS_INLINE void TBufferJSON::JsonReadFastArray(T *arr, Int_t arrsize, bool
       for (int cnt = 0; cnt < arrsize; ++cnt)
          arr[cnt] = 0;
 
+      if (json->count("bin") == 1) {
+         Error("ReadFastArray", "Arrays stored as binary blocks can not be read back");
+         return;
+      }
+
       if (json->count("b") == 1) {
          auto base64 = json->at("b").get<std::string>();
 
@@ -3029,9 +3131,10 @@ void TBufferJSON::ReadFastArray(void **start, const TClass *cl, Int_t n, Bool_t
 template <typename T>
 R__ALWAYS_INLINE void TBufferJSON::JsonWriteArrayCompress(const T *vname, Int_t arrsize, const char *typname)
 {
-   bool is_base64 = Stack()->fBase64 || (fArrayCompact == kBase64);
+   bool is_binary = (fArrayCompact == kBinaryBlocks) && ((arrsize >= 6) || Stack()->fBase64);
+   bool is_base64 = !is_binary && (Stack()->fBase64 || (fArrayCompact == kBase64));
 
-   if (!is_base64 && ((fArrayCompact == 0) || (arrsize < 6))) {
+   if (!is_base64 && !is_binary && ((fArrayCompact == 0) || (arrsize < 6))) {
       fValue.Append("[");
       for (Int_t indx = 0; indx < arrsize; indx++) {
          if (indx > 0)
@@ -3039,7 +3142,7 @@ R__ALWAYS_INLINE void TBufferJSON::JsonWriteArrayCompress(const T *vname, Int_t
          JsonWriteBasic(vname[indx]);
       }
       fValue.Append("]");
-   } else if (is_base64 && !arrsize) {
+   } else if ((is_base64 || is_binary) && !arrsize) {
       fValue.Append("[]");
    } else {
       fValue.Append("{");
@@ -3050,14 +3153,23 @@ R__ALWAYS_INLINE void TBufferJSON::JsonWriteArrayCompress(const T *vname, Int_t
       while ((aindx < bindx) && (vname[bindx - 1] == 0))
          bindx--;
 
-      if (is_base64) {
+      if (is_base64 || is_binary) {
          // small initial offset makes no sense - JSON code is large then size gain
          if ((aindx * sizeof(T) < 5) && (aindx < bindx))
             aindx = 0;
 
          if ((aindx > 0) && (aindx < bindx))
             fValue.Append(TString::Format("%s\"o\":%ld", fArraySepar.Data(), (long) (aindx * (int) sizeof(T))));
+      }
 
+      if (is_binary) {
+         if (aindx < bindx) {
+            Long64_t nbytes = (bindx - aindx) * (Long64_t)sizeof(T);
+            Long64_t pos = JsonAppendBinaryBlock(vname + aindx, nbytes);
+            fValue.Append(TString::Format("%s\"bin\":%lld%s\"nb\":%lld", fArraySepar.Data(), (long long)pos,
+                                          fArraySepar.Data(), (long long)nbytes));
+         }
+      } else if (is_base64) {
          fValue.Append(fArraySepar);
          fValue.Append("\"b\":\"");
 
@@ -16,6 +16,8 @@
 #include "TROOT.h"
 #include "TVirtualMutex.h"
 
+#include <algorithm>
+#include <chrono>
 #include <utility>
 
 namespace ROOT {
@@ -65,12 +67,57 @@ size_t TBufferMerger::GetQueueSize() const
    return fQueue.size();
 }
 
+size_t TBufferMerger::GetQueuedBytes() const
+{
+   std::lock_guard<std::mutex> lock(fQueueMutex);
+   return fQueuedBytes;
+}
+
+size_t TBufferMerger::GetMaxQueuedBytes() const
+{
+   return fMaxQueuedBytes;
+}
+
+TBufferMergerStats TBufferMerger::GetStats() const
+{
+   std::lock_guard<std::mutex> lock(fQueueMutex);
+   return fStats;
+}
+
+bool TBufferMerger::GetKeepCompression() const
+{
+   return fKeepCompression;
+}
+
 void TBufferMerger::Push(TBufferFile *buffer)
 {
+   const size_t size = buffer->BufferSize();
    {
-      std::lock_guard<std::mutex> lock(fQueueMutex);
-      fBuffered += buffer->BufferSize();
+      std::unique_lock<std::mutex> lock(fQueueMutex);
+
+      // Wait for room in the queue. If nobody is merging, drain it ourselves.
+      bool blocked = false;
+      auto start = std::chrono::steady_clock::now();
+      while (fMaxQueuedBytes > 0 && fQueuedBytes > 0 && fQueuedBytes + size > fMaxQueuedBytes) {
+         blocked = true;
+         if (fMerging) {
+            fQueueCondition.wait(lock);
+         } else {
+            lock.unlock();
+            Merge();
+            lock.lock();
+         }
+      }
+      if (blocked) {
+         ++fStats.fBlockedWrites;
+         fStats.fBlockedTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }
+
+      fBuffered += size;
+      fQueuedBytes += size;
       fQueue.push(buffer);
+      fStats.fPeakQueueSize = std::max(fStats.fPeakQueueSize, fQueue.size());
+      fStats.fPeakQueuedBytes = std::max(fStats.fPeakQueuedBytes, fQueuedBytes);
    }
 
    if (fBuffered > fAutoSave)
@@ -93,6 +140,16 @@ void TBufferMerger::SetAutoSave(size_t size)
    fAutoSave = size;
 }
 
+void TBufferMerger::SetMaxQueuedBytes(size_t size)
+{
+   fMaxQueuedBytes = size;
+}
+
+void TBufferMerger::SetKeepCompression(bool keep)
+{
+   fKeepCompression = keep;
+}
+
 void TBufferMerger::SetMergeOptions(const TString& options)
 {
    fMerger.SetMergeOptions(options);
@@ -106,16 +163,35 @@ void TBufferMerger::Merge()
          std::lock_guard<std::mutex> q(fQueueMutex);
          std::swap(queue, fQueue);
          fBuffered = 0;
+         fMerging = true;
       }
 
+      auto start = std::chrono::steady_clock::now();
+      size_t nbuffers = queue.size();
+      size_t nbytes = 0;
       while (!queue.empty()) {
          std::unique_ptr<TBufferFile> buffer{queue.front()};
+         nbytes += buffer->BufferSize();
          fMerger.AddAdoptFile(new TMemFile(fMerger.GetOutputFileName(), std::move(buffer)));
          queue.pop();
       }
 
-      fMerger.PartialMerge();
+      Int_t type = TFileMerger::kAllIncremental;
+      if (fKeepCompression)
+         type |= TFileMerger::kKeepCompression;
+      fMerger.PartialMerge(type);
       fMerger.Reset();
+
+      {
+         std::lock_guard<std::mutex> q(fQueueMutex);
+         fQueuedBytes -= nbytes;
+         fMerging = false;
+         ++fStats.fMerges;
+         fStats.fMergedBuffers += nbuffers;
+         fStats.fMergedBytes += nbytes;
+         fStats.fMergeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }
+      fQueueCondition.notify_all();
       fMergeMutex.unlock();
    }
 }
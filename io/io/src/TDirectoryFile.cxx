@@ -48,10 +48,151 @@ End_Macro
 #include "TProcessUUID.h"
 #include "TVirtualMutex.h"
 #include "TEmulatedCollectionProxy.h"
+#include "TEnv.h"
+
+#include <memory>
+#include <vector>
 
 const UInt_t kIsBigFile = BIT(16);
 const Int_t  kMaxLen = 2048;
 
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compact index of the keys of a directory with many keys.
+///
+/// The keys record is kept as read from the file, with the location of each
+/// key header and key name in it and an open addressing hash table on the
+/// names. The TKey objects are created on demand (see TDirectoryFile::ReadKeys).
+
+class RKeyIndex {
+public:
+   struct REntry {
+      Int_t   fOffset;     ///< Offset of the key header in the keys record
+      Int_t   fNameOffset; ///< Offset of the key name in the keys record
+      Int_t   fNameLength; ///< Length of the key name
+      Short_t fCycle;      ///< Cycle number of the key
+      Bool_t  fRemoved;    ///< The key was deleted, see TDirectoryFile::RemoveKey
+   };
+
+   std::unique_ptr<char[]> fRecord; ///< Keys record as read from the file
+   std::vector<REntry>     fEntries; ///< One entry per key, in file order
+   std::vector<TKey *>     fLoaded;  ///< Keys already created, nullptr otherwise
+   std::vector<Int_t>      fSlots;   ///< Hash table of entry numbers, -1 for a free slot
+   Int_t                   fNRemoved{0}; ///< Number of removed entries
+
+   void BuildHashTable()
+   {
+      size_t nslots = 16;
+      while (nslots < 2 * fEntries.size())
+         nslots *= 2;
+      fSlots.assign(nslots, -1);
+      const size_t mask = nslots - 1;
+      for (Int_t i = 0; i < (Int_t)fEntries.size(); ++i) {
+         size_t slot = TString::Hash(fRecord.get() + fEntries[i].fNameOffset, fEntries[i].fNameLength) & mask;
+         while (fSlots[slot] != -1)
+            slot = (slot + 1) & mask;
+         fSlots[slot] = i;
+      }
+   }
+
+   /// Return the first entry, in file order, named 'name' and whose cycle is
+   /// accepted by 'accept', or -1. With linear probing, the entries sharing a
+   /// name are found in the order in which they were inserted.
+   template <typename Accept>
+   Int_t Find(const char *name, Accept accept) const
+   {
+      const Int_t len = strlen(name);
+      const size_t mask = fSlots.size() - 1;
+      for (size_t slot = TString::Hash(name, len) & mask; fSlots[slot] != -1; slot = (slot + 1) & mask) {
+         const REntry &entry = fEntries[fSlots[slot]];
+         if (!entry.fRemoved && entry.fNameLength == len &&
+             memcmp(fRecord.get() + entry.fNameOffset, name, len) == 0 && accept(entry.fCycle))
+            return fSlots[slot];
+      }
+      return -1;
+   }
+};
+
+} // namespace Internal
+} // namespace ROOT
+
+namespace {
+
+/// The fields of a key header used by the key index.
+struct RKeyHeader {
+   Short_t     fCycle{0};
+   Long64_t    fSeekKey{0};
+   Long64_t    fSeekPdir{0};
+   const char *fClassName{nullptr};
+   Int_t       fClassNameLength{0};
+   const char *fName{nullptr};
+   Int_t       fNameLength{0};
+};
+
+/// Locate a TString streamed at 'buffer' without copying it.
+Bool_t ReadStringInPlace(char *&buffer, const char *end, const char *&str, Int_t &len)
+{
+   if (end - buffer < 1)
+      return kFALSE;
+   UChar_t nwh;
+   frombuf(buffer, &nwh);
+   if (nwh == 255) {
+      if (end - buffer < (Long64_t)sizeof(Int_t))
+         return kFALSE;
+      frombuf(buffer, &len);
+   } else {
+      len = nwh;
+   }
+   if (len < 0 || end - buffer < len)
+      return kFALSE;
+   str = buffer;
+   buffer += len;
+   return kTRUE;
+}
+
+/// Decode the key header at 'buffer' (see TKey::ReadKeyBuffer) and move
+/// 'buffer' past it. Return false if the header does not fit before 'end'.
+Bool_t DecodeKeyHeader(char *&buffer, const char *end, RKeyHeader &header)
+{
+   // Fields common to all the key versions; the strings are checked by ReadStringInPlace.
+   if (end - buffer < 18)
+      return kFALSE;
+   Int_t nbytes, objlen;
+   Version_t version;
+   UInt_t datime;
+   Short_t keylen;
+   frombuf(buffer, &nbytes);
+   frombuf(buffer, &version);
+   frombuf(buffer, &objlen);
+   frombuf(buffer, &datime);
+   frombuf(buffer, &keylen);
+   frombuf(buffer, &header.fCycle);
+   if (end - buffer < (version > 1000 ? 16 : 8))
+      return kFALSE;
+   if (version > 1000) {
+      Long64_t pdir;
+      frombuf(buffer, &header.fSeekKey);
+      frombuf(buffer, &pdir);
+      // The 16 highest bits hold the pid offset, see TKey::ReadKeyBuffer.
+      header.fSeekPdir = pdir & 0xffffffffffffLL;
+   } else {
+      UInt_t seekkey, seekdir;
+      frombuf(buffer, &seekkey);
+      frombuf(buffer, &seekdir);
+      header.fSeekKey = seekkey;
+      header.fSeekPdir = seekdir;
+   }
+   const char *title;
+   Int_t titlelen;
+   return ReadStringInPlace(buffer, end, header.fClassName, header.fClassNameLength) &&
+          ReadStringInPlace(buffer, end, header.fName, header.fNameLength) &&
+          ReadStringInPlace(buffer, end, title, titlelen);
+}
+
+} // anonymous namespace
+
 ClassImp(TDirectoryFile);
 
 
@@ -177,6 +318,7 @@ void TDirectoryFile::InitDirectoryFile(TClass *cl)
 
 TDirectoryFile::~TDirectoryFile()
 {
+   DropKeyIndex();
    if (fKeys) {
       fKeys->Delete("slow");
       SafeDelete(fKeys);
@@ -230,6 +372,8 @@ Int_t TDirectoryFile::AppendKey(TKey *key)
       return 0;
    }
 
+   LoadAllKeys();
+
    fModified = kTRUE;
 
    key->SetMotherDir(this);
@@ -266,7 +410,7 @@ void TDirectoryFile::Browse(TBrowser *b)
       TObject *obj = nullptr;
       TIter nextin(fList);
       TKey *key = nullptr, *keyo = nullptr;
-      TIter next(fKeys);
+      TIter next(GetListOfKeys());
 
       cd();
 
@@ -575,6 +719,7 @@ void TDirectoryFile::Close(Option_t *option)
    }
 
    // Delete keys from key list (but don't delete the list header)
+   DropKeyIndex();
    if (fKeys) {
       fKeys->Delete("slow");
    }
@@ -717,6 +862,16 @@ void TDirectoryFile::Delete(const char *namecycle)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Discard the compact key index, if any. The keys already created from it
+/// are in the list of keys and are not affected.
+
+void TDirectoryFile::DropKeyIndex()
+{
+   delete fKeyIndex;
+   fKeyIndex = nullptr;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Encode directory header into output buffer
 
@@ -937,16 +1092,39 @@ TObject *TDirectoryFile::Get(const char *namecycle)
       } else if (cycle == 9999) {
          return idcur;
       } else {
-         if (idcur->InheritsFrom(TCollection::Class()))
-            idcur->Delete();  // delete also list elements
-         delete idcur;
+         // Other threads may use the object if the file is read concurrently.
+         if (!fFile || !fFile->IsConcurrentRead()) {
+            if (idcur->InheritsFrom(TCollection::Class()))
+               idcur->Delete();  // delete also list elements
+            delete idcur;
+         }
          idcur = nullptr;
       }
    }
 
 //*-*---------------------Case of Key---------------------
 //                        ===========
+   if (fKeyIndex) {
+      TKey *key = GetKeyFromIndex(namobj, cycle, kTRUE);
+      if (key) {
+         TDirectory::TContext ctxt(this);
+         idcur = key->ReadObj();
+      }
+      return idcur;
+   }
    TKey *key;
+   if (fFile && fFile->IsConcurrentRead()) {
+      // The keys do not change, look them up without locking. TKey::ReadObj()
+      // would use the buffers of the key, shared by the threads.
+      TIter next(((THashList *)GetListOfKeys())->GetListForObject(namobj));
+      while ((key = (TKey *)next())) {
+         if (!strcmp(namobj, key->GetName()) && ((cycle == 9999) || (cycle == key->GetCycle()))) {
+            TDirectory::TContext ctxt(this);
+            return (TObject *)key->ReadObjectAny(TObject::Class());
+         }
+      }
+      return nullptr;
+   }
    TIter nextkey(GetListOfKeys());
    while ((key = (TKey *) nextkey())) {
       if (strcmp(namobj,key->GetName()) == 0) {
@@ -1055,9 +1233,12 @@ void *TDirectoryFile::GetObjectChecked(const char *namecycle, const TClass* expe
             if (expectedClass && objcur->IsA()->GetBaseClassOffset(expectedClass) == -1) return nullptr;
             else return objcur;
          } else {
-            if (objcur->InheritsFrom(TCollection::Class()))
-               objcur->Delete();  // delete also list elements
-            delete objcur;
+            // Other threads may use the object if the file is read concurrently.
+            if (!fFile || !fFile->IsConcurrentRead()) {
+               if (objcur->InheritsFrom(TCollection::Class()))
+                  objcur->Delete();  // delete also list elements
+               delete objcur;
+            }
             objcur = nullptr;
          }
       }
@@ -1066,6 +1247,14 @@ void *TDirectoryFile::GetObjectChecked(const char *namecycle, const TClass* expe
 //*-*---------------------Case of Key---------------------
 //                        ===========
    void *idcur = nullptr;
+   if (fKeyIndex) {
+      TKey *key = GetKeyFromIndex(namobj, cycle, kTRUE);
+      if (key) {
+         TDirectory::TContext ctxt(this);
+         idcur = key->ReadObjectAny(expectedClass);
+      }
+      return idcur;
+   }
    TKey *key;
    TIter nextkey(GetListOfKeys());
    while ((key = (TKey *) nextkey())) {
@@ -1103,6 +1292,9 @@ TKey *TDirectoryFile::GetKey(const char *name, Short_t cycle) const
 {
    if (!fKeys) return nullptr;
 
+   if (fKeyIndex)
+      return GetKeyFromIndex(name, cycle, kFALSE);
+
    // TIter::TIter() already checks for null pointers
    TIter next( ((THashList *)(GetListOfKeys()))->GetListForObject(name) );
 
@@ -1117,6 +1309,124 @@ TKey *TDirectoryFile::GetKey(const char *name, Short_t cycle) const
    return nullptr;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the key with the given name and cycle from the compact key index,
+/// creating the TKey if needed. With exactCycle the cycle must match (as in
+/// Get), otherwise the first key with a cycle not above it is returned (as in
+/// GetKey). A cycle of 9999 selects the highest cycle.
+
+TKey *TDirectoryFile::GetKeyFromIndex(const char *name, Short_t cycle, Bool_t exactCycle) const
+{
+   ROOT::Internal::RKeyIndex &index = *fKeyIndex;
+   const Int_t i = index.Find(name, [=](Short_t keycycle) {
+      return (cycle == 9999) || (exactCycle ? cycle == keycycle : cycle >= keycycle);
+   });
+   if (i < 0)
+      return nullptr;
+
+   if (!index.fLoaded[i]) {
+      TKey *key = new TKey(const_cast<TDirectoryFile *>(this));
+      char *buffer = index.fRecord.get() + index.fEntries[i].fOffset;
+      key->ReadKeyBuffer(buffer);
+      fKeys->Add(key);
+      index.fLoaded[i] = key;
+   }
+   return index.fLoaded[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of keys in this directory, including those not yet
+/// created from the compact key index.
+
+Int_t TDirectoryFile::GetNkeys() const
+{
+   if (fKeyIndex)
+      return fKeyIndex->fEntries.size() - fKeyIndex->fNRemoved;
+   return fKeys->GetSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of keys of the given class, without creating the
+/// TKeys still in the compact key index.
+
+Int_t TDirectoryFile::GetNkeysOfClass(const char *classname) const
+{
+   Int_t n = 0;
+   if (fKeyIndex) {
+      const char *record = fKeyIndex->fRecord.get();
+      const Int_t len = strlen(classname);
+      for (const auto &entry : fKeyIndex->fEntries) {
+         if (entry.fRemoved)
+            continue;
+         char *buffer = const_cast<char *>(record) + entry.fOffset;
+         RKeyHeader header;
+         if (!DecodeKeyHeader(buffer, record + fNbytesKeys, header))
+            continue;
+         // Old directories are read as TDirectoryFile, see TKey::ReadKeyBuffer.
+         if (header.fClassNameLength == 10 && !strncmp(header.fClassName, "TDirectory", 10)) {
+            if (!strcmp(classname, "TDirectoryFile"))
+               ++n;
+         } else if (header.fClassNameLength == len && !strncmp(header.fClassName, classname, len)) {
+            ++n;
+         }
+      }
+      return n;
+   }
+   TIter next(fKeys);
+   TKey *key;
+   while ((key = (TKey *)next())) {
+      if (!strcmp(key->GetClassName(), classname))
+         ++n;
+   }
+   return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create all the keys still in the compact key index, add them to the list
+/// of keys in file order and discard the index.
+
+void TDirectoryFile::LoadAllKeys() const
+{
+   if (!fKeyIndex) return;
+
+   // Detach the index first, the TKeys may call back GetListOfKeys.
+   std::unique_ptr<ROOT::Internal::RKeyIndex> index(fKeyIndex);
+   fKeyIndex = nullptr;
+
+   fKeys->Clear("nodelete");
+   for (size_t i = 0; i < index->fEntries.size(); ++i) {
+      if (index->fEntries[i].fRemoved)
+         continue;
+      TKey *key = index->fLoaded[i];
+      if (!key) {
+         key = new TKey(const_cast<TDirectoryFile *>(this));
+         char *buffer = index->fRecord.get() + index->fEntries[i].fOffset;
+         key->ReadKeyBuffer(buffer);
+      }
+      fKeys->Add(key);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove 'key' from the keys of this directory (see TKey::Delete and
+/// ~TKey), without creating the keys still in the compact key index.
+
+void TDirectoryFile::RemoveKey(TKey *key)
+{
+   if (!fKeys) return;
+   if (fKeyIndex) {
+      ROOT::Internal::RKeyIndex &index = *fKeyIndex;
+      const Short_t cycle = key->GetCycle();
+      const Int_t i = index.Find(key->GetName(), [=](Short_t keycycle) { return keycycle == cycle; });
+      if (i >= 0 && index.fLoaded[i] == key) {
+         index.fEntries[i].fRemoved = kTRUE;
+         index.fLoaded[i] = nullptr;
+         ++index.fNRemoved;
+      }
+   }
+   fKeys->Remove(key);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// List Directory contents
 ///
@@ -1166,7 +1476,7 @@ void TDirectoryFile::ls(Option_t *option) const
 
    if (diskobj && fKeys) {
       //*-* Loop on all the keys
-      TObjLink *lnk = fKeys->FirstLink();
+      TObjLink *lnk = GetListOfKeys()->FirstLink();
       while (lnk) {
          TKey *key = (TKey*)lnk->GetObject();
          TString s = key->GetName();
@@ -1334,6 +1644,13 @@ void TDirectoryFile::ReadAll(Option_t* opt)
 /// This is an efficient way (without opening/closing files) to view
 /// the latest updates of a file being modified by another process
 /// as it is typically the case in a data acquisition system.
+///
+/// If the directory has at least `TFile.KeyIndexThreshold` keys (see
+/// system.rootrc, 10000 by default, 0 to disable), no TKey is created here:
+/// only a compact index of the key names is built and a TKey is created
+/// when it is looked up by GetKey, FindKey, Get or GetObjectChecked.
+/// All the keys are created the first time GetListOfKeys is called, for
+/// example to iterate over them, or when the directory is modified.
 
 Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
 {
@@ -1346,6 +1663,7 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
 
    char *buffer;
    if (forceRead) {
+      DropKeyIndex();
       fKeys->Delete();
       //In case directory was updated by another process, read new
       //position for the keys
@@ -1386,8 +1704,38 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
       buffer = headerkey->GetBuffer();
       headerkey->ReadKeyBuffer(buffer);
 
-      TKey *key;
       frombuf(buffer, &nkeys);
+
+      const Int_t indexThreshold = gEnv->GetValue("TFile.KeyIndexThreshold", 10000);
+      if (indexThreshold > 0 && nkeys >= indexThreshold && !fKeyIndex && !fKeys->GetSize()) {
+         // Many keys: only index their names, the TKeys are created when accessed.
+         auto index = std::make_unique<ROOT::Internal::RKeyIndex>();
+         index->fRecord.reset(new char[fNbytesKeys]);
+         memcpy(index->fRecord.get(), headerkey->GetBuffer(), fNbytesKeys);
+         char *record = index->fRecord.get();
+         char *cur = record + (buffer - headerkey->GetBuffer());
+         delete headerkey;
+
+         index->fEntries.reserve(nkeys);
+         RKeyHeader header;
+         for (Int_t i = 0; i < nkeys; i++) {
+            const Int_t offset = cur - record;
+            if (!DecodeKeyHeader(cur, record + fNbytesKeys, header) ||
+                header.fSeekKey < 64 || header.fSeekKey > fsize ||
+                header.fSeekPdir < 64 || header.fSeekPdir > fsize) {
+               Error("ReadKeys","reading illegal key, exiting after %d keys",i);
+               nkeys = i;
+               break;
+            }
+            index->fEntries.push_back({offset, Int_t(header.fName - record), header.fNameLength, header.fCycle, kFALSE});
+         }
+         index->fLoaded.assign(nkeys, nullptr);
+         index->BuildHashTable();
+         fKeyIndex = index.release();
+         return nkeys;
+      }
+
+      TKey *key;
       for (Int_t i = 0; i < nkeys; i++) {
          key = new TKey(this);
          key->ReadKeyBuffer(buffer);
@@ -1425,6 +1773,13 @@ Int_t TDirectoryFile::ReadTObject(TObject *obj, const char *keyname)
 {
    if (!fFile) { Error("Read","No file open"); return 0; }
    TKey *key = nullptr;
+   if (fKeyIndex) {
+      key = GetKeyFromIndex(keyname, 9999, kFALSE);
+      if (key)
+         return key->Read(obj);
+      Error("Read","Key not found");
+      return 0;
+   }
    TIter nextkey(GetListOfKeys());
    while ((key = (TKey *) nextkey())) {
       if (strcmp(keyname,key->GetName()) == 0) {
@@ -1458,7 +1813,7 @@ void TDirectoryFile::ResetAfterMerge(TFileMergeInfo *info)
    fSeekParent = 0; // updated by Init
    fSeekKeys = 0;   // updated by Init
    // Does not change: fFile
-   TKey *key = fKeys ? (TKey*)fKeys->FindObject(fName) : nullptr;
+   TKey *key = fKeys ? (TKey*)GetListOfKeys()->FindObject(fName) : nullptr;
    TClass *cl = IsA();
    if (key) {
       cl = TClass::GetClass(key->GetClassName());
@@ -2130,7 +2485,7 @@ void TDirectoryFile::WriteKeys()
       f->MakeFree(fSeekKeys, fSeekKeys + fNbytesKeys -1);
    }
 //*-* Write new keys record
-   TIter next(fKeys);
+   TIter next(GetListOfKeys());
    TKey *key;
    Int_t nkeys  = fKeys->GetSize();
    Int_t nbytes = sizeof nkeys;          //*-* Compute size of all keys
@@ -131,6 +131,8 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include "compiledata.h"
 #include <cmath>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <set>
 #include "TSchemaRule.h"
 #include "TSchemaRuleSet.h"
@@ -138,6 +140,12 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include "TGlobal.h"
 #include "ROOT/RMakeUnique.hxx"
 #include "ROOT/RConcurrentHashColl.hxx"
+#include "ROOT/RSharedPayloadCache.hxx"
+#include "ZipZSTD.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 using std::sqrt;
 
@@ -153,12 +161,79 @@ Bool_t   TFile::fgCacheFileForce = kFALSE;
 Bool_t   TFile::fgCacheFileDisconnected = kTRUE;
 UInt_t   TFile::fgOpenTimeout = TFile::kEternalTimeout;
 Bool_t   TFile::fgOnlyStaged = kFALSE;
-#ifdef R__USE_IMT
-ROOT::Internal::RConcurrentHashColl TFile::fgTsSIHashes;
-#endif
 
 const Int_t kBEGIN = 100;
 
+namespace ROOT {
+namespace Internal {
+/// The StreamerInfo records already read in this process, indexed by the hash of their
+/// content, with the numbers of the TStreamerInfo they are made of. A file carrying the
+/// same record as a previous one, as the files of a TChain typically do, only has to
+/// mark those in its class index instead of unpacking and checking the record again.
+struct RStreamerInfoRecordCache {
+   std::mutex fMutex;
+   std::map<RConcurrentHashColl::HashValue, std::vector<Int_t>> fRecords;
+   Long64_t fHits = 0;
+
+   bool Find(const RConcurrentHashColl::HashValue &hash)
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      if (!fRecords.count(hash))
+         return false;
+      ++fHits;
+      return true;
+   }
+
+   /// Mark the classes of the record in 'index', return false if the record is unknown.
+   bool MarkClasses(const RConcurrentHashColl::HashValue &hash, TArrayC &index)
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      auto it = fRecords.find(hash);
+      if (it == fRecords.end())
+         return false;
+      for (auto uid : it->second) {
+         if (uid >= index.GetSize())
+            index.Set(2 * (uid + 1));
+         index.fArray[uid] = 1;
+      }
+      return true;
+   }
+
+   void Insert(const RConcurrentHashColl::HashValue &hash, std::vector<Int_t> &&uids)
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fRecords.emplace(hash, std::move(uids));
+   }
+};
+/// The ZSTD dictionaries used in a file: all of them, to be stored with the StreamerInfo record,
+/// and the ones compressing the keys of a given class, supplied or trained from the first keys.
+struct RZstdFileDictionaries {
+   std::vector<const RZstdDictionary *> fDictionaries;
+   std::unordered_set<unsigned int> fIDs;
+   std::unordered_map<std::string, const RZstdDictionary *> fByClass;
+   std::unordered_map<std::string, std::unique_ptr<RZstdDictionaryTrainer>> fTrainers;
+   size_t fTrainingCapacity = 0;
+};
+/// The state of a file opened with "READ_CONCURRENT": its read statistics, updated
+/// by all the threads reading it.
+struct RConcurrentReadState {
+   std::atomic<Long64_t> fBytesRead{0};
+   std::atomic<Int_t> fReadCalls{0};
+#ifdef WIN32
+   std::mutex fSeekMutex; ///< No positional read: serialize the seek and read pairs
+#endif
+};
+} // namespace Internal
+} // namespace ROOT
+
+ROOT::Internal::RStreamerInfoRecordCache TFile::fgStreamerInfoRecords;
+
+Long64_t ROOT::Internal::GetStreamerInfoRecordCacheHits()
+{
+   std::lock_guard<std::mutex> lock(TFile::fgStreamerInfoRecords.fMutex);
+   return TFile::fgStreamerInfoRecords.fHits;
+}
+
 ClassImp(TFile);
 
 //*-*x17 macros/layout_file
@@ -206,10 +281,20 @@ TFile::TFile() : TDirectoryFile(), fCompress(ROOT::RCompressionSetting::EAlgorit
 /// RECREATE      | Create a new file, if the file already exists it will be overwritten.
 /// UPDATE        | Open an existing file for writing. If no file exists, it is created.
 /// READ          | Open an existing file for reading (default).
+/// READ_CONCURRENT | Open an existing file for reading from several threads at once, see below.
 /// NET           | Used by derived remote file access classes, not a user callable option.
 /// WEB           | Used by derived remote http access class, not a user callable option.
 ///
 /// If option = "" (default), READ is assumed.
+///
+/// A file opened with READ_CONCURRENT can be shared by several threads reading objects
+/// with Get() or Get<T>() once ROOT::EnableThreadSafety() was called. The directory tree,
+/// the keys and the TProcessIDs are all read when opening the file, so that looking up
+/// a key does not change the directories. The keys are read with positional reads
+/// (pread) without going through the read cache, and each thread decompresses into its
+/// own buffers. The objects read are not attached to their directory, whatever
+/// TH1::AddDirectoryStatus(): the caller owns them. Only these object reads are thread
+/// safe; in particular trees must still be read with a TFile per thread.
 /// The file can be specified as a URL of the form:
 ///
 ///     file:///user/rdm/bla.root or file:/user/rdm/bla.root
@@ -347,6 +432,10 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
 
    fOption.ToUpper();
 
+   const Bool_t concurrent = (fOption == "READ_CONCURRENT");
+   if (concurrent)
+      fOption = "READ";
+
    if (fIsRootFile && !fIsPcmFile && fOption != "NEW" && fOption != "CREATE"
        && fOption != "RECREATE") {
       // If !gPluginMgr then we are at startup and cannot handle plugins
@@ -488,6 +577,16 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    // calling virtual methods from constructor not a good idea, but it is how code was developed
    TFile::Init(create);                        // NOLINT: silence clang-tidy warnings
 
+   if (concurrent && !IsZombie()) {
+      // Read everything which is otherwise set up on first use (this also creates the
+      // keys still in a compact key index): the reading threads only look it up.
+      ReadAll("dirs*");
+      for (Int_t pidf = 0; pidf < fNProcessIDs; ++pidf)
+         if (TProcessID *pid = ReadProcessID(pidf))
+            pid->CheckInit();
+      fConcurrentRead = new ROOT::Internal::RConcurrentReadState;
+   }
+
    return;
 
 zombie:
@@ -527,6 +626,9 @@ TFile::~TFile()
    SafeDelete(fArchive);
    SafeDelete(fInfoCache);
    SafeDelete(fOpenPhases);
+   SafeDelete(fZstdDictionaries);
+   SafeDelete(fSharedPayloads);
+   SafeDelete(fConcurrentRead);
 
    {
       R__LOCKGUARD(gROOTMutex);
@@ -834,7 +936,7 @@ void TFile::Init(Bool_t create)
             }
          } else if (fVersion != gROOT->GetVersionInt() && fVersion > 30000) {
             // Don't complain about missing streamer info for empty files.
-            if (fKeys->GetSize()) {
+            if (GetNkeys()) {
                Warning("Init","no StreamerInfo found in %s therefore preventing schema evolution when reading this file."
                               " The file was produced with version %d.%02d/%02d of ROOT.",
                               GetName(),  fVersion / 10000, (fVersion / 100) % (100), fVersion  % 100);
@@ -845,11 +947,7 @@ void TFile::Init(Bool_t create)
 
    // Count number of TProcessIDs in this file
    {
-      TIter next(fKeys);
-      TKey *key;
-      while ((key = (TKey*)next())) {
-         if (!strcmp(key->GetClassName(),"TProcessID")) fNProcessIDs++;
-      }
+      fNProcessIDs += GetNkeysOfClass("TProcessID");
       fProcessIDs = new TObjArray(fNProcessIDs+1);
    }
    return;
@@ -1312,17 +1410,19 @@ TFile::InfoListRet TFile::GetStreamerInfoListImpl(bool lookupSICache)
          return {nullptr, 1, hash};
       }
 
-#ifdef R__USE_IMT
       if (lookupSICache) {
-         hash = fgTsSIHashes.Hash(buf, fNbytesInfo);
-         if (fgTsSIHashes.Find(hash)) {
+         // The key header holds the date and the location of the record, only hash its content.
+         char *pkeylen = buf + sizeof(Int_t) + sizeof(Version_t) + sizeof(Int_t) + sizeof(UInt_t);
+         Short_t keylen = 0;
+         frombuf(pkeylen, &keylen);
+         if (keylen <= 0 || keylen >= fNbytesInfo)
+            keylen = 0;
+         hash = ROOT::Internal::RConcurrentHashColl::Hash(buf + keylen, fNbytesInfo - keylen);
+         if (fgStreamerInfoRecords.Find(hash)) {
             if (gDebug > 0) Info("GetStreamerInfo", "The streamer info record for file %s has already been treated, skipping it.", GetName());
             return {nullptr, 0, hash};
          }
       }
-#else
-      (void) lookupSICache;
-#endif
       key->ReadKeyBuffer(buf);
       list = dynamic_cast<TList*>(key->ReadObjWithBuffer(buffer.data()));
       if (list) list->SetOwner();
@@ -1636,6 +1736,34 @@ void TFile::Print(Option_t *option) const
 
 Bool_t TFile::ReadBuffer(char *buf, Long64_t pos, Int_t len)
 {
+   if (IsOpen() && fConcurrentRead) {
+      // Several threads may read: neither the cursor nor the caches can be used.
+      Int_t nread = 0;
+      while (nread < len) {
+         Int_t siz = SysReadAt(fD, buf + nread, len - nread, pos + nread);
+         if (siz < 0 && GetErrno() == EINTR) {
+            ResetErrno();
+            continue;
+         }
+         if (siz < 0) {
+            SysError("ReadBuffer", "error reading from file %s", GetName());
+            return kTRUE;
+         }
+         if (siz == 0)
+            break;
+         nread += siz;
+      }
+      if (nread != len) {
+         Error("ReadBuffer", "error reading all requested bytes from file %s, got %d of %d", GetName(), nread, len);
+         return kTRUE;
+      }
+      fConcurrentRead->fBytesRead += len;
+      fConcurrentRead->fReadCalls++;
+      fgBytesRead += len;
+      fgReadCalls++;
+      return kFALSE;
+   }
+
    if (IsOpen()) {
 
       SetOffset(pos);
@@ -1747,6 +1875,10 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
       return kFALSE;
    }
 
+   // Data handed over to a write-behind cache may not be in the file yet.
+   if (fWritable && fCacheWrite && fCacheWrite->IsWriteBehind())
+      fCacheWrite->Flush();
+
    Int_t k = 0;
    Bool_t result = kTRUE;
    TFileCacheRead *old = fCacheRead;
@@ -1807,6 +1939,11 @@ Int_t TFile::ReadBufferViaCache(char *buf, Int_t len)
 {
    Long64_t off = GetRelOffset();
    if (fCacheRead) {
+      if (fWritable && fCacheWrite && fCacheWrite->IsWriteBehind()) {
+         // Data handed over to a write-behind cache may not be in the file yet.
+         fCacheWrite->Flush();
+         Seek(off);
+      }
       Int_t st = fCacheRead->ReadBuffer(buf, off, len);
       if (st < 0)
          return 2;  // failure reading
@@ -2091,6 +2228,11 @@ Int_t TFile::ReOpen(Option_t *mode)
    if (opt == fOption || (opt == "UPDATE" && fOption == "CREATE"))
       return 1;
 
+   if (fConcurrentRead) {
+      Error("ReOpen", "file %s is read concurrently and cannot be updated", GetName());
+      return 1;
+   }
+
    if (opt == "READ") {
       // switch to READ mode
 
@@ -2257,6 +2399,158 @@ void TFile::SetCompressionSettings(Int_t settings)
    fCompress = settings;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add a ZSTD dictionary to be used for the ZSTD compressed keys of the class
+/// 'classname' or, if 'classname' is null, only to be stored in the file (e.g.
+/// because it was given to TBranch::SetZstdDictionary).
+///
+/// 'content' is a dictionary in the format produced by `zstd --train` or
+/// ZDICT_trainFromBuffer(). The dictionaries are stored in the StreamerInfo
+/// record and registered when the file is opened, so that the data compressed
+/// with them can be read back.
+///
+/// Returns the ID of the dictionary, 0 if 'content' is not a ZSTD dictionary.
+
+Int_t TFile::AddZstdDictionary(const void *content, Int_t size, const char *classname)
+{
+   auto dict = ROOT::Internal::RZstdDictionary::Register(content, size > 0 ? size : 0);
+   if (!dict) {
+      Error("AddZstdDictionary", "not a ZSTD dictionary");
+      return 0;
+   }
+   AddZstdDictionary(*dict, classname);
+   return dict->GetID();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add a registered ZSTD dictionary to the file, see above.
+///
+/// Baskets call this while holding the write lock of the file.
+
+void TFile::AddZstdDictionary(const ROOT::Internal::RZstdDictionary &dict, const char *classname)
+{
+   if (!fZstdDictionaries)
+      fZstdDictionaries = new ROOT::Internal::RZstdFileDictionaries;
+   if (classname && classname[0])
+      fZstdDictionaries->fByClass[classname] = &dict;
+   if (!fZstdDictionaries->fIDs.insert(dict.GetID()).second)
+      return;
+   fZstdDictionaries->fDictionaries.push_back(&dict);
+   // Have the StreamerInfo record rewritten with the new dictionary.
+   if (fWritable && fClassIndex && fClassIndex->fArray[0] == 0)
+      fClassIndex->fArray[0] = 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the ZSTD dictionaries of 'other' to this file, as needed when copying
+/// compressed buffers from 'other' without decompressing them.
+
+void TFile::AddZstdDictionaries(const TFile &other)
+{
+   if (!other.fZstdDictionaries || &other == this)
+      return;
+   for (auto dict : other.fZstdDictionaries->fDictionaries)
+      AddZstdDictionary(*dict);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the ZSTD dictionary to compress the key of an object of class
+/// 'classname' whose streamed form is the 'size' bytes of 'buffer'.
+///
+/// If the dictionary training is enabled (see SetZstdDictionaryTraining) and
+/// there is no dictionary yet for the class, the buffer is kept as sample and
+/// the dictionary is trained once enough samples of the class were collected.
+
+const ROOT::Internal::RZstdDictionary *TFile::GetZstdDictionaryForKey(const char *classname, const char *buffer,
+                                                                      Int_t size)
+{
+   if (!fZstdDictionaries || !classname)
+      return nullptr;
+#ifdef R__USE_IMT
+   std::lock_guard<std::mutex> lock(fWriteMutex);
+#endif
+   auto iter = fZstdDictionaries->fByClass.find(classname);
+   if (iter != fZstdDictionaries->fByClass.end())
+      return iter->second;
+   if (!fZstdDictionaries->fTrainingCapacity || size <= 0)
+      return nullptr;
+
+   auto &trainer = fZstdDictionaries->fTrainers[classname];
+   if (!trainer)
+      trainer.reset(new ROOT::Internal::RZstdDictionaryTrainer(fZstdDictionaries->fTrainingCapacity));
+   auto dict = trainer->AddSample(buffer, size);
+   if (trainer->IsDone()) {
+      trainer.reset();
+      if (dict)
+         AddZstdDictionary(*dict, classname);
+      else
+         fZstdDictionaries->fByClass[classname] = nullptr; // Do not try again.
+   }
+   return dict;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Train, for each class, a ZSTD dictionary of at most 'capacity' bytes from
+/// the first keys of the class written to this file; the following keys of the
+/// class are compressed with it. This only affects keys compressed with ZSTD,
+/// and is mostly useful for many small objects of the same class. 0 disables
+/// the training of new dictionaries.
+///
+/// The dictionaries are stored in the file; reading it back requires a ROOT
+/// version supporting ZSTD dictionaries.
+
+void TFile::SetZstdDictionaryTraining(Int_t capacity)
+{
+   if (!fZstdDictionaries)
+      fZstdDictionaries = new ROOT::Internal::RZstdFileDictionaries;
+   fZstdDictionaries->fTrainingCapacity = capacity > 0 ? capacity : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Share the decompressed data of this file with the other processes of the
+/// node reading it, through a shared memory segment of 'size' bytes named after
+/// the UUID of the file. The segment is created by the first process attaching
+/// it; the payload of each key and basket is then decompressed by only one of
+/// the processes, the others copy it from the segment. A process attaching with
+/// 'readOnly' only uses the payloads published by the others. A size of 0
+/// takes the value of TFile.SharedMemorySize (in MB, 256 by default) in system.rootrc.
+///
+/// Only files opened for reading can be shared, see also TFile::Open with the
+/// "shm://" prefix. The payloads are identified by the position, date and cycle
+/// of their key, so that a process updating the file meanwhile cannot make the
+/// readers use the payload of a key it replaced. The segment persists until UnlinkSharedMemory is called,
+/// possibly while other processes still use it.
+/// Returns kFALSE if the segment cannot be attached; the file is then read as usual.
+
+Bool_t TFile::AttachSharedMemory(Long64_t size, Bool_t readOnly)
+{
+   if (IsWritable() || IsZombie()) {
+      Error("AttachSharedMemory", "%s: only files opened for reading can be shared", GetName());
+      return kFALSE;
+   }
+   if (size <= 0)
+      size = gEnv->GetValue("TFile.SharedMemorySize", 256) * (Long64_t)1024 * 1024;
+   TString name = TString::Format("/root-%s", fUUID.AsString());
+   auto shared = ROOT::Internal::RSharedPayloadCache::Attach(name.Data(), size, readOnly);
+   if (!shared)
+      return kFALSE;
+   delete fSharedPayloads;
+   fSharedPayloads = shared.release();
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove the shared memory segment attached by AttachSharedMemory from the
+/// system. The processes still using it, including this one, keep their access;
+/// the next process attaching it creates a new one.
+
+Bool_t TFile::UnlinkSharedMemory()
+{
+   if (!fSharedPayloads)
+      return kFALSE;
+   return ROOT::Internal::RSharedPayloadCache::Unlink(fSharedPayloads->GetName());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set a pointer to the read cache.
 ///
@@ -3525,7 +3819,11 @@ void TFile::ReadStreamerInfo()
    TList *list = listRetcode.fList;
    auto retcode = listRetcode.fReturnCode;
    if (!list) {
-      if (retcode) MakeZombie();
+      if (retcode)
+         MakeZombie();
+      else if (fClassIndex)
+         // Same record as a file already read: the TStreamerInfo are known, only mark them as used.
+         fgStreamerInfoRecords.MarkClasses(listRetcode.fHash, *fClassIndex);
       return;
    }
 
@@ -3534,6 +3832,8 @@ void TFile::ReadStreamerInfo()
    if (gDebug > 0) Info("ReadStreamerInfo", "called for file %s",GetName());
 
    TStreamerInfo *info;
+   Bool_t hasZstdDictionaries = kFALSE;
+   std::vector<Int_t> uids;
 
    Int_t version = fVersion;
    if (version > 1000000) version -= 1000000;
@@ -3588,6 +3888,15 @@ void TFile::ReadStreamerInfo()
                      rulelnk = rulelnk->Next();
                   }
 #endif
+               } else if (strcmp(obj->GetName(),"listOfZstdDictionaries")==0) {
+                  // Register the dictionaries before any data compressed with them is read.
+                  hasZstdDictionaries = kTRUE;
+                  TIter nextDict((TList*)obj);
+                  while (TObjString *content = (TObjString*)nextDict()) {
+                     if (!AddZstdDictionary(content->String().Data(), content->String().Length()))
+                        Error("ReadStreamerInfo", "%s has an invalid ZSTD dictionary.", GetName());
+                  }
+                  ((TList*)obj)->SetOwner(kTRUE);
                } else {
                   Warning("ReadStreamerInfo","%s has a %s in the list of TStreamerInfo.", GetName(), info->IsA()->GetName());
                }
@@ -3613,8 +3922,10 @@ void TFile::ReadStreamerInfo()
             Int_t uid = info->GetNumber();
             Int_t asize = fClassIndex->GetSize();
             if (uid >= asize && uid <100000) fClassIndex->Set(2*asize);
-            if (uid >= 0 && uid < fClassIndex->GetSize()) fClassIndex->fArray[uid] = 1;
-            else if (!isstl && !info->GetClass()->IsSyntheticPair()) {
+            if (uid >= 0 && uid < fClassIndex->GetSize()) {
+               fClassIndex->fArray[uid] = 1;
+               uids.push_back(uid);
+            } else if (!isstl && !info->GetClass()->IsSyntheticPair()) {
                printf("ReadStreamerInfo, class:%s, illegal uid=%d\n",info->GetName(),uid);
             }
             if (gDebug > 0) printf(" -class: %s version: %d info read at slot %d\n",info->GetName(), info->GetClassVersion(),uid);
@@ -3626,11 +3937,11 @@ void TFile::ReadStreamerInfo()
    list->Clear();  //this will delete all TStreamerInfo objects with kCanDelete bit set
    delete list;
 
-#ifdef R__USE_IMT
-   // We are done processing the record, let future calls and other threads that it
-   // has been done.
-   fgTsSIHashes.Insert(listRetcode.fHash);
-#endif
+   // We are done processing the record, let future calls and other threads know that it
+   // has been done. Records with ZSTD dictionaries are always processed, for the
+   // file to know which dictionaries it uses.
+   if (fSeekInfo && !hasZstdDictionaries)
+      fgStreamerInfoRecords.Insert(listRetcode.fHash, std::move(uids));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3764,6 +4075,18 @@ void TFile::WriteStreamerInfo()
       list.Add(&listOfRules);
    }
 
+   TList listOfZstdDictionaries;
+   listOfZstdDictionaries.SetOwner(kTRUE);
+   listOfZstdDictionaries.SetName("listOfZstdDictionaries");
+   if (fZstdDictionaries && !fZstdDictionaries->fDictionaries.empty()) {
+      for (auto dict : fZstdDictionaries->fDictionaries) {
+         TObjString *obj = new TObjString();
+         obj->String() = TString(dict->GetContent().data(), dict->GetContent().size());
+         listOfZstdDictionaries.Add(obj);
+      }
+      list.Add(&listOfZstdDictionaries);
+   }
+
    //free previous StreamerInfo record
    if (fSeekInfo) MakeFree(fSeekInfo,fSeekInfo+fNbytesInfo-1);
    //Create new key
@@ -3776,7 +4099,8 @@ void TFile::WriteStreamerInfo()
 
    fClassIndex->fArray[0] = 0;
 
-   list.RemoveLast(); // remove the listOfRules.
+   list.Remove(&listOfZstdDictionaries);
+   list.Remove(&listOfRules);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4011,6 +4335,17 @@ TFile *TFile::Open(const char *url, Option_t *options, const char *ftitle,
    TString expandedUrl(url);
    gSystem->ExpandPathName(expandedUrl);
 
+   // A local file whose decompressed data is shared with the other processes
+   // opening it through "shm://", see TFile::AttachSharedMemory.
+   if (expandedUrl.BeginsWith("shm://")) {
+      expandedUrl.Remove(0, strlen("shm://"));
+      f = TFile::Open(expandedUrl, options, ftitle, compress, netopt);
+      if (f && !f->IsZombie() && !f->AttachSharedMemory())
+         ::Warning("TFile::Open", "%s: cannot share the decompressed data, reading it privately",
+                   expandedUrl.Data());
+      return f;
+   }
+
    // If a timeout has been specified extract the value and try to apply it (it requires
    // support for asynchronous open, though; the following is completely transparent if
    // such support if not available for the required protocol)
@@ -4201,6 +4536,14 @@ TFile *TFile::Open(const char *url, Option_t *options, const char *ftitle,
    if (type != kLocal && type != kFile &&
        f && f->IsWritable() && !f->IsRaw()) {
       new TFileCacheWrite(f, 1);
+   } else if (f && f->IsWritable() && !f->IsRaw() && f->IsA() == TFile::Class()) {
+      // Coalesce the writes of local files in large buffers, written in the
+      // background, if so configured (see TFileCacheWrite::SetWriteBehind).
+      Int_t inFlight = gEnv->GetValue("TFile.WriteBehind", 0);
+      if (inFlight > 0) {
+         auto cache = new TFileCacheWrite(f, gEnv->GetValue("TFile.WriteBehindBufferSize", 4 * 1024 * 1024));
+         cache->SetWriteBehind(inFlight);
+      }
    }
 
    return f;
@@ -4399,6 +4742,24 @@ Int_t TFile::SysRead(Int_t fd, void *buf, Int_t len)
    return ::read(fd, buf, len);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Interface to system positional read. All arguments like in POSIX pread(),
+/// the file offset is not changed.
+
+Int_t TFile::SysReadAt(Int_t fd, void *buf, Int_t len, Long64_t offset)
+{
+#ifndef WIN32
+   return ::pread(fd, buf, len, offset);
+#else
+   std::unique_lock<std::mutex> lock;
+   if (fConcurrentRead)
+      lock = std::unique_lock<std::mutex>(fConcurrentRead->fSeekMutex);
+   if (SysSeek(fd, offset, SEEK_SET) < 0)
+      return -1;
+   return SysRead(fd, buf, len);
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Interface to system write. All arguments like in POSIX write().
 
@@ -4451,6 +4812,22 @@ Int_t TFile::SysSync(Int_t fd)
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of bytes read from this file.
+
+Long64_t TFile::GetBytesRead() const
+{
+   return fConcurrentRead ? fBytesRead + fConcurrentRead->fBytesRead : fBytesRead;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of read calls on this file, not counting the cache calls.
+
+Int_t TFile::GetReadCalls() const
+{
+   return fConcurrentRead ? fReadCalls + fConcurrentRead->fReadCalls : fReadCalls;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the total number of bytes written so far to the file.
 
@@ -23,12 +23,203 @@ TXNetFile and TWebFile (via TFile::WriteBuffers()).
 
 The write cache is automatically created when writing a remote file
 (created in TFile::Open()).
+
+With SetWriteBehind() the cache becomes a write-behind pipeline for
+local files: the full buffers, cut at 4 kB aligned file positions, are
+written by a background thread while the next one is being filled, with
+a bounded number of buffers in flight. Flush() waits for all of them to
+be written. TFile::Open() enables it for the local files opened for
+writing when TFile.WriteBehind is set in the rootrc.
 */
 
 
 #include "TFile.h"
 #include "TFileCacheWrite.h"
 
+#include <condition_variable>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+namespace ROOT {
+namespace Internal {
+
+/// Writes the buffers handed over by a TFileCacheWrite at their position in the
+/// file, in order, on a background thread. At most fMaxInFlight buffers are
+/// queued or being written at any time: Submit() blocks until there is room.
+class RFileWriteBehind {
+public:
+   struct RJob {
+      int fFd;
+      char *fBuffer;
+      Long64_t fPos;
+      Int_t fLen;
+      bool fPooled; ///< fBuffer goes back to the pool of buffers once written
+   };
+
+private:
+   Int_t fBufferSize;
+   Int_t fMaxInFlight;
+   std::mutex fMutex;
+   std::condition_variable fCond;
+   std::deque<RJob> fQueue;
+   std::vector<char *> fFreeBuffers;
+   Int_t fInFlight = 0;
+   bool fStop = false;
+   bool fSuspended = false; ///< The queued buffers are not written until resumed
+   int fErrno = 0;          ///< errno of the first failed write
+   Long64_t fErrorPos = 0;  ///< Position of the first failed write
+   std::thread fThread;
+
+   void Run();
+
+public:
+   RFileWriteBehind(Int_t bufferSize, Int_t maxInFlight);
+   ~RFileWriteBehind();
+
+   char *GetBuffer();
+   void Submit(const RJob &job);
+   int Drain(Long64_t &errorPos);
+   void Suspend(bool suspend);
+   bool HasError()
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      return fErrno != 0;
+   }
+   Int_t GetInFlight()
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      return fInFlight;
+   }
+};
+
+RFileWriteBehind::RFileWriteBehind(Int_t bufferSize, Int_t maxInFlight)
+   : fBufferSize(bufferSize), fMaxInFlight(maxInFlight)
+{
+   fThread = std::thread([this]() { Run(); });
+}
+
+RFileWriteBehind::~RFileWriteBehind()
+{
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = true;
+   }
+   fCond.notify_all();
+   fThread.join();
+   for (auto buffer : fFreeBuffers)
+      delete[] buffer;
+}
+
+/// Return a buffer of fBufferSize bytes to fill, recycled from the buffers already written.
+char *RFileWriteBehind::GetBuffer()
+{
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      if (!fFreeBuffers.empty()) {
+         char *buffer = fFreeBuffers.back();
+         fFreeBuffers.pop_back();
+         return buffer;
+      }
+   }
+   return new char[fBufferSize];
+}
+
+void RFileWriteBehind::Submit(const RJob &job)
+{
+   std::unique_lock<std::mutex> lock(fMutex);
+   if (fInFlight >= fMaxInFlight && fSuspended) {
+      // Waiting for room while the writes are held back would never end.
+      fSuspended = false;
+      fCond.notify_all();
+   }
+   fCond.wait(lock, [this]() { return fInFlight < fMaxInFlight; });
+   fQueue.push_back(job);
+   ++fInFlight;
+   fCond.notify_all();
+}
+
+/// Wait until all the submitted buffers are written; return the errno of the first
+/// failed write since the last call, 0 if there was none.
+int RFileWriteBehind::Drain(Long64_t &errorPos)
+{
+   std::unique_lock<std::mutex> lock(fMutex);
+   fSuspended = false;
+   fCond.notify_all();
+   fCond.wait(lock, [this]() { return fInFlight == 0; });
+   int err = fErrno;
+   errorPos = fErrorPos;
+   fErrno = 0;
+   return err;
+}
+
+/// Hold the queued buffers back, or let them be written again. Drain(), or a
+/// Submit() waiting for room, resumes the writes.
+void RFileWriteBehind::Suspend(bool suspend)
+{
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fSuspended = suspend;
+   }
+   fCond.notify_all();
+}
+
+void RFileWriteBehind::Run()
+{
+   std::unique_lock<std::mutex> lock(fMutex);
+   while (true) {
+      fCond.wait(lock, [this]() { return fStop || (!fSuspended && !fQueue.empty()); });
+      if (fQueue.empty())
+         return;
+      RJob job = fQueue.front();
+      fQueue.pop_front();
+      const bool skip = fErrno != 0; // After a failure, the following writes are dropped.
+      lock.unlock();
+
+      int err = 0;
+#ifndef WIN32
+      Int_t written = 0;
+      while (!skip && written < job.fLen) {
+         ssize_t siz = ::pwrite(job.fFd, job.fBuffer + written, job.fLen - written, job.fPos + written);
+         if (siz < 0 && errno == EINTR)
+            continue;
+         if (siz <= 0) {
+            err = siz < 0 ? errno : EIO;
+            break;
+         }
+         written += siz;
+      }
+#endif
+
+      lock.lock();
+      if (err && !fErrno) {
+         fErrno = err;
+         fErrorPos = job.fPos;
+      }
+      if (job.fPooled)
+         fFreeBuffers.push_back(job.fBuffer);
+      else
+         delete[] job.fBuffer;
+      --fInFlight;
+      fCond.notify_all();
+   }
+}
+
+} // namespace Internal
+} // namespace ROOT
+
+namespace {
+/// The buffers written in the background end at file positions multiple of this, where possible.
+constexpr Long64_t kWriteBehindAlignment = 4096;
+} // namespace
+
 ClassImp(TFileCacheWrite);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -42,6 +233,7 @@ TFileCacheWrite::TFileCacheWrite() : TObject()
    fFile        = 0;
    fBuffer      = 0;
    fRecursive   = kFALSE;
+   fWriteBehind = nullptr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -59,6 +251,7 @@ TFileCacheWrite::TFileCacheWrite(TFile *file, Int_t buffersize)
    fNtot        = 0;
    fFile        = file;
    fRecursive   = kFALSE;
+   fWriteBehind = nullptr;
    fBuffer      = new char[fBufferSize];
    if (file) file->SetCacheWrite(this);
    if (gDebug > 0) Info("TFileCacheWrite","Creating a write cache with buffersize=%d bytes",buffersize);
@@ -69,6 +262,7 @@ TFileCacheWrite::TFileCacheWrite(TFile *file, Int_t buffersize)
 
 TFileCacheWrite::~TFileCacheWrite()
 {
+   delete fWriteBehind;
    delete [] fBuffer;
 }
 
@@ -78,6 +272,10 @@ TFileCacheWrite::~TFileCacheWrite()
 
 Bool_t TFileCacheWrite::Flush()
 {
+   if (fWriteBehind) {
+      if (fNtot && SubmitBuffer(fNtot)) return kTRUE;
+      return CheckWriteBehind("Flush");
+   }
    if (!fNtot) return kFALSE;
    fFile->Seek(fSeekStart);
    //printf("Flushing buffer at fSeekStart=%lld, fNtot=%d\n",fSeekStart,fNtot);
@@ -107,7 +305,13 @@ void TFileCacheWrite::Print(Option_t *option) const
 
 Int_t TFileCacheWrite::ReadBuffer(char *buf, Long64_t pos, Int_t len)
 {
-   if (pos < fSeekStart || pos+len > fSeekStart+fNtot) return -1;
+   if (pos < fSeekStart || pos+len > fSeekStart+fNtot) {
+      // The data may be in a buffer not yet written by the background thread,
+      // or partly in the current one, carried over from a buffer cut at an
+      // aligned position: write them all before the data is read from the file.
+      if (fWriteBehind) Flush();
+      return -1;
+   }
    memcpy(buf,fBuffer+pos-fSeekStart,len);
    return 0;
 }
@@ -121,6 +325,7 @@ Int_t TFileCacheWrite::ReadBuffer(char *buf, Long64_t pos, Int_t len)
 Int_t TFileCacheWrite::WriteBuffer(const char *buf, Long64_t pos, Int_t len)
 {
    if (fRecursive) return 0;
+   if (fWriteBehind) return WriteBufferBehind(buf, pos, len);
 
    //printf("TFileCacheWrite::WriteBuffer, pos=%lld, len=%d, fSeekStart=%lld, fNtot=%d\n",pos,len,fSeekStart,fNtot);
 
@@ -152,5 +357,122 @@ Int_t TFileCacheWrite::WriteBuffer(const char *buf, Long64_t pos, Int_t len)
 
 void TFileCacheWrite::SetFile(TFile *file)
 {
+   if (fWriteBehind) {
+      fNtot = 0;
+      CheckWriteBehind("SetFile");
+      SafeDelete(fWriteBehind);
+   }
    fFile = file;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the full buffers of the cache in the background, on a dedicated
+/// thread, while the next buffer is being filled. At most maxInFlight buffers
+/// (each of the size of the cache) are waiting to be written or being written;
+/// the writes to the file wait beyond that. The buffers are cut at 4 kB aligned
+/// positions in the file where possible. Flush(), as called by TFile::Flush()
+/// and TFile::Close(), waits for all the buffers to be written.
+///
+/// Only local files, written with positional writes, support it; returns
+/// kFALSE otherwise. maxInFlight = 0 switches back to synchronous writes.
+
+Bool_t TFileCacheWrite::SetWriteBehind(Int_t maxInFlight)
+{
+   if (fWriteBehind) {
+      if (Flush()) return kFALSE;
+      SafeDelete(fWriteBehind);
+   }
+   if (maxInFlight <= 0) return kTRUE;
+#ifdef WIN32
+   return kFALSE;
+#else
+   if (!fFile || fFile->IsA() != TFile::Class() || fFile->GetFd() < 0 || !fFile->IsWritable())
+      return kFALSE;
+   if (Flush()) return kFALSE;
+   fWriteBehind = new ROOT::Internal::RFileWriteBehind(fBufferSize, maxInFlight);
+   return kTRUE;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of buffers handed over to the background thread and not
+/// yet written, 0 without write-behind.
+
+Int_t TFileCacheWrite::GetWriteBehindInFlight() const
+{
+   return fWriteBehind ? fWriteBehind->GetInFlight() : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the buffers written in the background; returns kTRUE, after having
+/// reported the failure, if one of them could not be written.
+
+Bool_t TFileCacheWrite::CheckWriteBehind(const char *where)
+{
+   Long64_t errorPos = 0;
+   int err = fWriteBehind->Drain(errorPos);
+   if (!err) return kFALSE;
+   fFile->SetBit(TFile::kWriteError);
+   Error(where, "error writing to file %s at %lld: %s", fFile->GetName(), errorPos, strerror(err));
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hand the first nbytes of the cache buffer over to the background thread,
+/// keeping the rest at the start of a fresh buffer.
+
+Bool_t TFileCacheWrite::SubmitBuffer(Int_t nbytes)
+{
+   char *next = fWriteBehind->GetBuffer();
+   if (nbytes < fNtot) memcpy(next, fBuffer + nbytes, fNtot - nbytes);
+   fWriteBehind->Submit({fFile->GetFd(), fBuffer, fSeekStart + fFile->GetArchiveOffset(), nbytes, true});
+   fBuffer = next;
+   fSeekStart += nbytes;
+   fNtot -= nbytes;
+   fFile->fBytesWrite += nbytes;
+   TFile::fgBytesWrite += nbytes;
+   return fWriteBehind->HasError() && CheckWriteBehind("WriteBuffer");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// WriteBuffer() in write-behind mode: adjacent writes are coalesced in the
+/// cache buffer, which is handed over to the background thread once full.
+
+Int_t TFileCacheWrite::WriteBufferBehind(const char *buf, Long64_t pos, Int_t len)
+{
+   if (fNtot && fSeekStart + fNtot != pos) {
+      if (SubmitBuffer(fNtot)) return -1;
+   }
+   if (len >= fBufferSize) {
+      // Larger than the cache: written in the background as well, from a copy,
+      // not to overtake an older write of the same region.
+      if (fNtot && SubmitBuffer(fNtot)) return -1;
+      char *copy = new char[len];
+      memcpy(copy, buf, len);
+      fWriteBehind->Submit({fFile->GetFd(), copy, pos + fFile->GetArchiveOffset(), len, false});
+      fFile->fBytesWrite += len;
+      TFile::fgBytesWrite += len;
+      return 1;
+   }
+   if (fNtot + len > fBufferSize) {
+      // Write up to the last aligned position and carry the rest over.
+      Long64_t end = fSeekStart + fNtot;
+      Int_t nbytes = (Int_t)(end - end % kWriteBehindAlignment - fSeekStart);
+      if (nbytes <= 0 || fNtot - nbytes + len > fBufferSize) nbytes = fNtot;
+      if (SubmitBuffer(nbytes)) return -1;
+   }
+   if (!fNtot) fSeekStart = pos;
+   memcpy(fBuffer+fNtot,buf,len);
+   fNtot += len;
+   return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hold back the writes of the background thread of 'cache' (suspend = true),
+/// or let them go on, to test the callers against writes still in flight.
+/// Flush() resumes them, as does a write waiting for room in the pipeline.
+
+void ROOT::Internal::SuspendWriteBehind(TFileCacheWrite &cache, bool suspend)
+{
+   if (cache.fWriteBehind) cache.fWriteBehind->Suspend(suspend);
+}
@@ -20,6 +20,13 @@ any of its remote file access plugins. It is therefore useful in
 a Grid environment where the files might be accessible only remotely.
 The merging interface allows files containing histograms and trees
 to be merged, like the standalone hadd program.
+
+With SetParallelMerge(), and ROOT::EnableImplicitMT() called beforehand,
+the merge runs in-process on several threads: the objects of a directory
+that are merged in memory (histograms and other non-resetable objects)
+are read and merged in parallel, the next set of input files is opened
+while the current one is being merged and the trees that cannot be
+fast-cloned are refilled with TTree::SetParallelFill.
 */
 
 #include "TFileMerger.h"
@@ -38,6 +45,7 @@ to be merged, like the standalone hadd program.
 #include "TROOT.h"
 #include "TMemFile.h"
 #include "TVirtualMutex.h"
+#include "TError.h"
 
 #ifdef WIN32
 // For _getmaxstdio
@@ -48,7 +56,12 @@ to be merged, like the standalone hadd program.
 #include <sys/resource.h>
 #endif
 
+#include <atomic>
 #include <cstring>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 ClassImp(TFileMerger);
 
@@ -133,7 +146,7 @@ Bool_t TFileMerger::AddFile(const char *url, Bool_t cpProgress)
    TFile *newfile = 0;
    TString localcopy;
 
-   if (fFileList.GetEntries() >= (fMaxOpenedFiles-1)) {
+   if (fFileList.GetEntries() >= GetMaxFilesPerBatch()) {
 
       TObjString *urlObj = new TObjString(url);
       fMergeList.Add(urlObj);
@@ -385,6 +398,99 @@ Long64_t MergeRNTuples(TClass* rntupleHandle, const TString& /* target */, const
    return func(static_cast<void*>(rntupleHandle), nullptr, nullptr);
 }
 
+/// An object read from the first source whose merge was deferred to MergeInParallel.
+struct RPendingMerge {
+   TObject *fObject; ///< Object receiving the merge result
+   TClass  *fClass;  ///< Class of fObject
+   TString  fName;   ///< Name of the key fObject was read from
+   Bool_t   fOneGo;  ///< Whether all the inputs are merged in a single call
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge each of the pending objects with the objects of the same name in the
+/// source directories, using up to ROOT::GetThreadPoolSize() threads.
+///
+/// A source file is only accessed by one thread at a time: reading an object
+/// attaches it to its directory (and deleting it detaches it), so both happen
+/// under the lock of that file. Different objects are read from different files
+/// and merged concurrently.
+
+void MergeInParallel(std::vector<RPendingMerge> &pending, const std::vector<TDirectory *> &sources,
+                     const TFileMergeInfo &info)
+{
+   std::vector<std::mutex> locks(sources.size());
+
+   auto mergeOne = [&](RPendingMerge &entry) {
+      // Objects created by the Merge functions must not be attached to this thread's gDirectory.
+      TDirectory::TContext ctxt(nullptr);
+      TFileMergeInfo localInfo(info.fOutputDirectory);
+      localInfo.fIOFeatures = info.fIOFeatures;
+      localInfo.fOptions = info.fOptions;
+      ROOT::MergeFunc_t func = entry.fClass->GetMerge();
+
+      TList inputs;
+      std::vector<size_t> origins;
+      auto releaseInputs = [&]() {
+         TIter next(&inputs);
+         size_t i = 0;
+         while (TObject *hobj = next()) {
+            std::lock_guard<std::mutex> lock(locks[origins[i++]]);
+            delete hobj;
+         }
+         inputs.Clear();
+         origins.clear();
+      };
+
+      for (size_t s = 0; s < sources.size(); ++s) {
+         if (!sources[s])
+            continue;
+         TObject *hobj = nullptr;
+         {
+            std::lock_guard<std::mutex> lock(locks[s]);
+            TKey *key2 = (TKey *)sources[s]->GetListOfKeys()->FindObject(entry.fName);
+            if (!key2)
+               continue;
+            hobj = key2->ReadObj();
+         }
+         if (!hobj) {
+            ::Info("TFileMerger::MergeRecursive", "could not read object for key %s; skipping file %s",
+                   entry.fName.Data(), sources[s]->GetFile()->GetName());
+            continue;
+         }
+         hobj->ResetBit(kMustCleanup);
+         inputs.Add(hobj);
+         origins.push_back(s);
+         if (!entry.fOneGo) {
+            Long64_t result = func(entry.fObject, &inputs, &localInfo);
+            localInfo.fIsFirst = kFALSE;
+            if (result < 0) {
+               ::Error("TFileMerger::MergeRecursive", "calling Merge() on '%s' with the corresponding object in '%s'",
+                       entry.fName.Data(), sources[s]->GetFile()->GetName());
+            }
+            releaseInputs();
+         }
+      }
+      // Merge the list, if still to be done
+      if (entry.fOneGo || localInfo.fIsFirst) {
+         func(entry.fObject, &inputs, &localInfo);
+         releaseInputs();
+      }
+   };
+
+   std::atomic<size_t> nextEntry{0};
+   auto worker = [&]() {
+      for (size_t i = nextEntry++; i < pending.size(); i = nextEntry++)
+         mergeOne(pending[i]);
+   };
+   const size_t nThreads = std::min<size_t>(std::max(ROOT::GetThreadPoolSize(), 1u), pending.size());
+   std::vector<std::thread> threads;
+   for (size_t t = 1; t < nThreads; ++t)
+      threads.emplace_back(worker);
+   worker();
+   for (auto &thread : threads)
+      thread.join();
+}
+
 } // anonymous namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -425,6 +531,11 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
    if (fFastMethod && ((type&kKeepCompression) || !fCompressionChange) ) {
       info.fOptions.Append(" fast");
    }
+   // Merge the objects that stay in memory in parallel tasks, see SetParallelMerge.
+   const Bool_t parallel = fParallelMerge && ROOT::IsImplicitMTEnabled();
+   if (parallel) {
+      info.fOptions.Append(" ParallelFill");
+   }
 
    TFile      *current_file;
    TDirectory *current_sourcedir;
@@ -444,6 +555,7 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
          TIter nextkey( current_sourcedir->GetListOfKeys() );
          TKey *key;
          TString oldkeyname;
+         std::vector<RPendingMerge> pending;
 
          while ( (key = (TKey*)nextkey())) {
 
@@ -584,6 +696,13 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
                // Check if already treated
                if (alreadyseen) continue;
 
+               if (parallel && !cl->GetResetAfterMerge() && !cl->InheritsFrom(TCollection::Class())) {
+                  // Merged and written once all the keys of this directory have been seen.
+                  pending.push_back({obj, cl, key->GetName(), fHistoOneGo && cl->InheritsFrom(R__TH1_Class)});
+                  oldkeyname = key->GetName();
+                  continue;
+               }
+
                TList inputs;
                Bool_t oneGo = fHistoOneGo && cl->InheritsFrom(R__TH1_Class);
 
@@ -778,6 +897,25 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
             }
             info.Reset();
          } // while ( ( TKey *key = (TKey*)nextkey() ) )
+
+         if (!pending.empty()) {
+            std::vector<TDirectory *> sources;
+            TFile *nextsource = current_file ? (TFile*)sourcelist->After( current_file ) : (TFile*)sourcelist->First();
+            while (nextsource) {
+               sources.push_back(nextsource->GetDirectory(path));
+               nextsource = (TFile*)sourcelist->After( nextsource );
+            }
+            MergeInParallel(pending, sources, info);
+
+            target->cd();
+            for (auto &entry : pending) {
+               if (entry.fObject->Write(entry.fName, TObject::kOverwrite) <= 0) {
+                  status = kFALSE;
+               }
+               entry.fObject->ResetBit(kMustCleanup);
+               entry.fClass->Destructor(entry.fObject);
+            }
+         }
       }
       current_file = current_file ? (TFile*)sourcelist->After(current_file) : (TFile*)sourcelist->First();
       if (current_file) {
@@ -861,6 +999,13 @@ Bool_t TFileMerger::PartialMerge(Int_t in_type)
    Bool_t result = kTRUE;
    Int_t type = in_type;
    while (result && fFileList.GetEntries()>0) {
+      // Open the next set of files while the current one is being merged.
+      TList prefetched;
+      std::future<Bool_t> prefetch;
+      if (fParallelMerge && ROOT::IsImplicitMTEnabled() && fExcessFiles.GetEntries() > 0) {
+         prefetch = std::async(std::launch::async, [this, &prefetched]() { return OpenExcessFiles(prefetched); });
+      }
+
       result = MergeRecursive(fOutputFile, &fFileList, type);
 
       // Remove local copies if there are any
@@ -878,7 +1023,14 @@ Bool_t TFileMerger::PartialMerge(Int_t in_type)
          }
       }
       fFileList.Clear();
-      if (result && fExcessFiles.GetEntries() > 0) {
+      if (prefetch.valid()) {
+         const Bool_t opened = prefetch.get();
+         AdoptExcessFiles(prefetched);
+         if (result) {
+            type = type | kIncremental;
+            result = opened;
+         }
+      } else if (result && fExcessFiles.GetEntries() > 0) {
          // We merge the first set of files in the output,
          // we now need to open the next set and make
          // sure we accumulate into the output, so we
@@ -909,13 +1061,56 @@ Bool_t TFileMerger::PartialMerge(Int_t in_type)
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of input files merged together in one pass.
+///
+/// In parallel mode two sets of files are open at the same time (the one being
+/// merged and the next one), so each gets half of the allowed opened files.
+
+Int_t TFileMerger::GetMaxFilesPerBatch() const
+{
+   if (fParallelMerge) {
+      return TMath::Max((fMaxOpenedFiles - 1) / 2, 1);
+   }
+   return fMaxOpenedFiles - 1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Open up to fMaxOpenedFiles of the excess files.
 
 Bool_t TFileMerger::OpenExcessFiles()
 {
+   TList files;
+   Bool_t result = OpenExcessFiles(files);
+   AdoptExcessFiles(files);
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the files opened by OpenExcessFiles(TList&) to the list of files to be merged.
+
+void TFileMerger::AdoptExcessFiles(TList &files)
+{
+   TIter next(&files);
+   TFile *newfile;
+   while ((newfile = (TFile*)next())) {
+      if (fOutputFile && fOutputFile->GetCompressionLevel() != newfile->GetCompressionLevel()) fCompressionChange = kTRUE;
+      fFileList.Add(newfile);
+   }
+   files.Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Open the next set of excess files and add them to 'files'.
+///
+/// This does not touch the list of files being merged, so it can run while
+/// MergeRecursive is in progress (see SetParallelMerge).
+
+Bool_t TFileMerger::OpenExcessFiles(TList &files)
+{
+   const Int_t maxfiles = GetMaxFilesPerBatch();
    if (fPrintLevel > 0) {
-      Printf("%s Opening the next %d files", fMsgPrefix.Data(), TMath::Min(fExcessFiles.GetEntries(), fMaxOpenedFiles - 1));
+      Printf("%s Opening the next %d files", fMsgPrefix.Data(), TMath::Min(fExcessFiles.GetEntries(), maxfiles));
    }
    Int_t nfiles = 0;
    TIter next(&fExcessFiles);
@@ -923,7 +1118,7 @@ Bool_t TFileMerger::OpenExcessFiles()
    TString localcopy;
    // We want gDirectory untouched by anything going on here
    TDirectory::TContext ctxt;
-   while( nfiles < (fMaxOpenedFiles-1) && ( url = (TObjString*)next() ) ) {
+   while( nfiles < maxfiles && ( url = (TObjString*)next() ) ) {
       TFile *newfile = 0;
       if (fLocal) {
          TUUID uuid;
@@ -945,10 +1140,8 @@ Bool_t TFileMerger::OpenExcessFiles()
             Error("OpenExcessFiles", "cannot open file %s", url->GetName());
          return kFALSE;
       } else {
-         if (fOutputFile && fOutputFile->GetCompressionLevel() != newfile->GetCompressionLevel()) fCompressionChange = kTRUE;
-
          newfile->SetBit(kCanDelete);
-         fFileList.Add(newfile);
+         files.Add(newfile);
          ++nfiles;
          fExcessFiles.Remove(url);
       }
@@ -986,6 +1179,28 @@ void TFileMerger::SetMaxOpenedFiles(Int_t newmax)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Merge in-process with several threads.
+///
+/// The objects of a directory that are merged in memory (histograms and the
+/// other objects without a ResetAfterMerge function) are read from the input
+/// files and merged in parallel tasks, then written in the order they were seen.
+/// While a set of input files is merged, the next one (see SetMaxOpenedFiles) is
+/// opened, and copied if local copies are requested, in the background; each set
+/// then uses at most half of the allowed opened files. Trees that cannot be
+/// fast-cloned, for instance because the compression settings change, are
+/// copied with TTree::SetParallelFill so that their baskets are compressed in
+/// parallel.
+///
+/// This has no effect unless ROOT::EnableImplicitMT() has been called; the size
+/// of its thread pool is the number of threads used. Call this before adding
+/// the input files.
+
+void TFileMerger::SetParallelMerge(Bool_t enabled)
+{
+   fParallelMerge = enabled;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set the prefix to be used when printing informational message.
 
@@ -49,6 +49,7 @@
 
 #include <atomic>
 #include <iostream>
+#include <vector>
 
 #include "TROOT.h"
 #include "TClass.h"
@@ -66,6 +67,7 @@
 #include "ThreadLocalStorage.h"
 
 #include "RZip.h"
+#include "ROOT/RSharedPayloadCache.hxx"
 
 const Int_t kTitleMax = 32000;
 #if 0
@@ -238,7 +240,7 @@ TKey::TKey(const TObject *obj, const char *name, Int_t bufsize, TDirectory* moth
 
    Build(motherDir, obj->ClassName(), -1);
 
-   Int_t lbuf, nout, noutot, bufmax, nzip;
+   Int_t lbuf, noutot;
    fBufferRef = new TBufferFile(TBuffer::kWrite, bufsize);
    fBufferRef->SetParent(GetFile());
    fCycle     = fMotherDir->AppendKey(this);
@@ -258,23 +260,15 @@ TKey::TKey(const TObject *obj, const char *name, Int_t bufsize, TDirectory* moth
       fBuffer = new char[buflen];
       char *objbuf = fBufferRef->Buffer() + fKeylen;
       char *bufcur = &fBuffer[fKeylen];
-      noutot = 0;
-      nzip   = 0;
-      for (Int_t i = 0; i < nbuffers; ++i) {
-         if (i == nbuffers - 1) bufmax = fObjlen - nzip;
-         else               bufmax = kMAXZIPBUF;
-         R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm);
-         if (nout == 0 || nout >= fObjlen) { //this happens when the buffer cannot be compressed
-            fBuffer = fBufferRef->Buffer();
-            Create(fObjlen);
-            fBufferRef->SetBufferOffset(0);
-            Streamer(*fBufferRef);         //write key itself again
-            return;
-         }
-         bufcur += nout;
-         noutot += nout;
-         objbuf += kMAXZIPBUF;
-         nzip   += kMAXZIPBUF;
+      noutot = ROOT::Internal::R__zipBlocks(cxlevel, fObjlen, objbuf, buflen - fKeylen, bufcur, cxAlgorithm,
+                                            GetZipThreads(fObjlen), GetZstdDictionary(cxAlgorithm, objbuf, fObjlen));
+      if (noutot == 0 || noutot >= fObjlen) { //this happens when the buffer cannot be compressed
+         delete [] fBuffer;
+         fBuffer = fBufferRef->Buffer();
+         Create(fObjlen);
+         fBufferRef->SetBufferOffset(0);
+         Streamer(*fBufferRef);         //write key itself again
+         return;
       }
       Create(noutot);
       fBufferRef->SetBufferOffset(0);
@@ -334,7 +328,7 @@ TKey::TKey(const void *obj, const TClass *cl, const char *name, Int_t bufsize, T
    Streamer(*fBufferRef);         //write key itself
    fKeylen    = fBufferRef->Length();
 
-   Int_t lbuf, nout, noutot, bufmax, nzip;
+   Int_t lbuf, noutot;
 
    fBufferRef->MapObject(actualStart,clActual);         //register obj in map in case of self reference
    clActual->Streamer((void*)actualStart, *fBufferRef); //write object
@@ -349,23 +343,15 @@ TKey::TKey(const void *obj, const TClass *cl, const char *name, Int_t bufsize, T
       fBuffer = new char[buflen];
       char *objbuf = fBufferRef->Buffer() + fKeylen;
       char *bufcur = &fBuffer[fKeylen];
-      noutot = 0;
-      nzip   = 0;
-      for (Int_t i = 0; i < nbuffers; ++i) {
-         if (i == nbuffers - 1) bufmax = fObjlen - nzip;
-         else               bufmax = kMAXZIPBUF;
-         R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm);
-         if (nout == 0 || nout >= fObjlen) { //this happens when the buffer cannot be compressed
-            fBuffer = fBufferRef->Buffer();
-            Create(fObjlen);
-            fBufferRef->SetBufferOffset(0);
-            Streamer(*fBufferRef);         //write key itself again
-            return;
-         }
-         bufcur += nout;
-         noutot += nout;
-         objbuf += kMAXZIPBUF;
-         nzip   += kMAXZIPBUF;
+      noutot = ROOT::Internal::R__zipBlocks(cxlevel, fObjlen, objbuf, buflen - fKeylen, bufcur, cxAlgorithm,
+                                            GetZipThreads(fObjlen), GetZstdDictionary(cxAlgorithm, objbuf, fObjlen));
+      if (noutot == 0 || noutot >= fObjlen) { //this happens when the buffer cannot be compressed
+         delete [] fBuffer;
+         fBuffer = fBufferRef->Buffer();
+         Create(fObjlen);
+         fBufferRef->SetBufferOffset(0);
+         Streamer(*fBufferRef);         //write key itself again
+         return;
       }
       Create(noutot);
       fBufferRef->SetBufferOffset(0);
@@ -519,12 +505,83 @@ void TKey::Create(Int_t nbytes, TFile* externFile)
    fSeekPdir = externFile ? externFile->GetSeekDir() : fMotherDir->GetSeekDir();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of threads to compress or decompress a payload of
+/// nbytes uncompressed bytes with. Payloads spanning several compression
+/// blocks (kMAXZIPBUF bytes each) have their blocks processed concurrently
+/// when implicit multi-threading is enabled: TBasket runs them as tasks of the
+/// pool, TKey (libRIO does not use libImt) on as many threads as the pool has.
+
+Int_t TKey::GetZipThreads(Int_t nbytes)
+{
+   if (nbytes <= kMAXZIPBUF || !ROOT::IsImplicitMTEnabled())
+      return 1;
+   return ROOT::GetThreadPoolSize();
+}
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+/// Return a buffer of at least nbytes owned by the calling thread, holding the
+/// compressed object when reading a file opened with "READ_CONCURRENT". It is
+/// only used until the object is decompressed, before streaming the object can
+/// read other keys.
+
+char *GetThreadReadBuffer(Int_t nbytes)
+{
+   thread_local std::vector<char> buffer;
+   if ((Int_t)buffer.size() < nbytes)
+      buffer.resize(nbytes);
+   return buffer.data();
+}
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Decompress the object of this key from 'compressed' into 'objbuf' and return
+/// the number of bytes decompressed. When the file shares its decompressed data
+/// with other processes (see TFile::AttachSharedMemory), the object is copied
+/// from there if another process already decompressed it, and published otherwise.
+
+Int_t TKey::UnzipObject(UChar_t *compressed, char *objbuf)
+{
+   auto shared = GetFile() ? GetFile()->GetSharedPayloads() : nullptr;
+   const auto version = ROOT::Internal::RSharedPayloadCache::MakeVersion(fDatime.Get(), fCycle);
+   if (shared) {
+      if (const char *payload = shared->Find(fSeekKey, version, fObjlen)) {
+         memcpy(objbuf, payload, fObjlen);
+         return fObjlen;
+      }
+   }
+   Int_t nout = ROOT::Internal::R__unzipBlocks(fNbytes - fKeylen, compressed, fObjlen, (UChar_t *)objbuf,
+                                               GetZipThreads(fObjlen));
+   if (shared && nout == fObjlen)
+      shared->Insert(fSeekKey, version, objbuf, fObjlen);
+   return nout;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the ZSTD dictionary to compress the nbytes of buffer holding the
+/// object of this key with, if any (see TFile::SetZstdDictionaryTraining).
+
+const ROOT::Internal::RZstdDictionary *TKey::GetZstdDictionary(Int_t algorithm, const char *buffer, Int_t nbytes)
+{
+   auto resolved = ROOT::Internal::R__resolveAlgorithm(static_cast<ROOT::RCompressionSetting::EAlgorithm::EValues>(algorithm));
+   if (resolved != ROOT::RCompressionSetting::EAlgorithm::kZSTD || !GetFile())
+      return nullptr;
+   // The dictionaries are stored in the StreamerInfo record, which hence cannot use them.
+   if (fName == "StreamerInfo")
+      return nullptr;
+   return GetFile()->GetZstdDictionaryForKey(fClassName, buffer, nbytes);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// TKey default destructor.
 
 TKey::~TKey()
 {
-   if (fMotherDir && fMotherDir->GetListOfKeys())
+   // Removing the key through the compact key index does not create all the other keys.
+   if (auto dirFile = dynamic_cast<TDirectoryFile *>(fMotherDir))
+      dirFile->RemoveKey(this);
+   else if (fMotherDir && fMotherDir->GetListOfKeys())
       fMotherDir->GetListOfKeys()->Remove(this);
    TKey::DeleteBuffer();
 }
@@ -550,7 +607,10 @@ void TKey::Delete(Option_t *option)
    Long64_t first = fSeekKey;
    Long64_t last  = fSeekKey + fNbytes -1;
    if (GetFile()) GetFile()->MakeFree(first, last);  // release space used by this key
-   fMotherDir->GetListOfKeys()->Remove(this);
+   if (auto dirFile = dynamic_cast<TDirectoryFile *>(fMotherDir))
+      dirFile->RemoveKey(this);
+   else
+      fMotherDir->GetListOfKeys()->Remove(this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -817,18 +877,7 @@ TObject *TKey::ReadObj()
    if (fObjlen > fNbytes-fKeylen) {
       char *objbuf = bufferRef.Buffer() + fKeylen;
       UChar_t *bufcur = (UChar_t *)&compressedBuffer[fKeylen];
-      Int_t nin, nout = 0, nbuf;
-      Int_t noutot = 0;
-      while (1) {
-         Int_t hc = R__unzip_header(&nin, bufcur, &nbuf);
-         if (hc!=0) break;
-         R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objbuf, &nout);
-         if (!nout) break;
-         noutot += nout;
-         if (noutot >= fObjlen) break;
-         bufcur += nin;
-         objbuf += nout;
-      }
+      Int_t nout = UnzipObject(bufcur, objbuf);
       compressedBuffer.reset(nullptr);
       if (nout) {
          tobj->Streamer(bufferRef); //does not work with example 2 above
@@ -942,18 +991,7 @@ TObject *TKey::ReadObjWithBuffer(char *bufferRead)
    if (fObjlen > fNbytes-fKeylen) {
       char *objbuf = bufferRef.Buffer() + fKeylen;
       UChar_t *bufcur = (UChar_t *)&bufferRead[fKeylen];
-      Int_t nin, nout = 0, nbuf;
-      Int_t noutot = 0;
-      while (1) {
-         Int_t hc = R__unzip_header(&nin, bufcur, &nbuf);
-         if (hc!=0) break;
-         R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objbuf, &nout);
-         if (!nout) break;
-         noutot += nout;
-         if (noutot >= fObjlen) break;
-         bufcur += nin;
-         objbuf += nout;
-      }
+      Int_t nout = UnzipObject(bufcur, objbuf);
       if (nout) {
          tobj->Streamer(bufferRef); //does not work with example 2 above
       } else {
@@ -1023,18 +1061,33 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
    bufferRef.SetParent(GetFile());
    bufferRef.SetPidOffset(fPidOffset);
 
+   const Bool_t concurrent = GetFile()->IsConcurrentRead();
    std::unique_ptr<char []> compressedBuffer;
-   auto storeBuffer = fBuffer;
-   if (fObjlen > fNbytes-fKeylen) {
-      compressedBuffer.reset(new char[fNbytes]);
-      fBuffer = compressedBuffer.get();
-      ReadFile();                    //Read object structure from file
-      memcpy(bufferRef.Buffer(),fBuffer,fKeylen);
+   char *compressed = nullptr;
+   if (concurrent) {
+      // Other threads may read this key: do not go through fBuffer.
+      const Bool_t isCompressed = fObjlen > fNbytes - fKeylen;
+      compressed = isCompressed ? GetThreadReadBuffer(fNbytes) : bufferRef.Buffer();
+      if (GetFile()->ReadBuffer(compressed, fSeekKey, fNbytes)) {
+         Error("ReadObjectAny", "Failed to read data.");
+         return nullptr;
+      }
+      if (isCompressed)
+         memcpy(bufferRef.Buffer(), compressed, fKeylen);
    } else {
-      fBuffer = bufferRef.Buffer();
-      ReadFile();                    //Read object structure from file
+      auto storeBuffer = fBuffer;
+      if (fObjlen > fNbytes-fKeylen) {
+         compressedBuffer.reset(new char[fNbytes]);
+         compressed = compressedBuffer.get();
+         fBuffer = compressed;
+         ReadFile();                    //Read object structure from file
+         memcpy(bufferRef.Buffer(),fBuffer,fKeylen);
+      } else {
+         fBuffer = bufferRef.Buffer();
+         ReadFile();                    //Read object structure from file
+      }
+      fBuffer = storeBuffer;
    }
-   fBuffer = storeBuffer;
 
    // get version of key
    bufferRef.SetBufferOffset(sizeof(fNbytes));
@@ -1085,19 +1138,8 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
 
    if (fObjlen > fNbytes-fKeylen) {
       char *objbuf = bufferRef.Buffer() + fKeylen;
-      UChar_t *bufcur = (UChar_t *)&compressedBuffer[fKeylen];
-      Int_t nin, nout = 0, nbuf;
-      Int_t noutot = 0;
-      while (1) {
-         Int_t hc = R__unzip_header(&nin, bufcur, &nbuf);
-         if (hc!=0) break;
-         R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objbuf, &nout);
-         if (!nout) break;
-         noutot += nout;
-         if (noutot >= fObjlen) break;
-         bufcur += nin;
-         objbuf += nout;
-      }
+      UChar_t *bufcur = (UChar_t *)&compressed[fKeylen];
+      Int_t nout = UnzipObject(bufcur, objbuf);
       if (nout) {
          cl->Streamer((void*)pobj, bufferRef, clOnfile);    //read object
       } else {
@@ -1124,11 +1166,13 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
          dir->SetName(GetName());
          dir->SetTitle(GetTitle());
          dir->SetMother(fMotherDir);
-         fMotherDir->Append(dir);
+         if (!concurrent)
+            fMotherDir->Append(dir);
       }
    }
 
-   {
+   // The directories of a file read concurrently are not modified, see TFile::TFile.
+   if (!concurrent) {
       // Append the object to the directory if requested:
       ROOT::DirAutoAdd_t addfunc = cl->GetDirectoryAutoAdd();
       if (addfunc) {
@@ -1174,18 +1218,7 @@ Int_t TKey::Read(TObject *obj)
    if (fObjlen > fNbytes-fKeylen) {
       char *objbuf = bufferRef.Buffer() + fKeylen;
       UChar_t *bufcur = (UChar_t *)&compressedBuffer[fKeylen];
-      Int_t nin, nout = 0, nbuf;
-      Int_t noutot = 0;
-      while (1) {
-         Int_t hc = R__unzip_header(&nin, bufcur, &nbuf);
-         if (hc!=0) break;
-         R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objbuf, &nout);
-         if (!nout) break;
-         noutot += nout;
-         if (noutot >= fObjlen) break;
-         bufcur += nin;
-         objbuf += nout;
-      }
+      Int_t nout = UnzipObject(bufcur, objbuf);
       if (nout) obj->Streamer(bufferRef);
    } else {
       obj->Streamer(bufferRef);
@@ -170,6 +170,7 @@ TStreamerInfo::TStreamerInfo()
    fWriteMemberWise = 0;
    fWriteMemberWiseVecPtr = 0;
    fWriteText = 0;
+   fCollectionActions = nullptr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -204,6 +205,7 @@ TStreamerInfo::TStreamerInfo(TClass *cl)
    fWriteMemberWise = 0;
    fWriteMemberWiseVecPtr = 0;
    fWriteText = 0;
+   fCollectionActions = nullptr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -230,6 +232,7 @@ TStreamerInfo::~TStreamerInfo()
    delete fWriteMemberWise;
    delete fWriteMemberWiseVecPtr;
    delete fWriteText;
+   DeleteCollectionActions();
 
    if (!fElements) return;
    fElements->Delete();
@@ -2593,14 +2596,15 @@ void TStreamerInfo::Clear(Option_t *option)
       ResetIsCompiled();
       ResetBit(kBuildOldUsed);
 
-      if (fReadObjectWise) fReadObjectWise->fActions.clear();
+      if (fReadObjectWise) { fReadObjectWise->fActions.clear(); fReadObjectWise->ResetJIT(); }
       if (fReadMemberWise) fReadMemberWise->fActions.clear();
       if (fReadMemberWiseVecPtr) fReadMemberWiseVecPtr->fActions.clear();
       if (fReadText) fReadText->fActions.clear();
-      if (fWriteObjectWise) fWriteObjectWise->fActions.clear();
+      if (fWriteObjectWise) { fWriteObjectWise->fActions.clear(); fWriteObjectWise->ResetJIT(); }
       if (fWriteMemberWise) fWriteMemberWise->fActions.clear();
       if (fWriteMemberWiseVecPtr) fWriteMemberWiseVecPtr->fActions.clear();
       if (fWriteText) fWriteText->fActions.clear();
+      DeleteCollectionActions();
    }
 }
 
@@ -24,6 +24,16 @@
 #include "TVirtualCollectionIterators.h"
 #include "TProcessID.h"
 #include "TFile.h"
+#include "TEnv.h"
+#include "TObjArray.h"
+#include "TObjString.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
 
 static const Int_t kRegrouped = TStreamerInfo::kOffsetL;
 
@@ -3006,10 +3016,10 @@ void TStreamerInfo::Compile()
    Int_t ndata = fElements->GetEntries();
 
 
-   if (fReadObjectWise) fReadObjectWise->fActions.clear();
+   if (fReadObjectWise) { fReadObjectWise->fActions.clear(); fReadObjectWise->ResetJIT(); }
    else fReadObjectWise = new TStreamerInfoActions::TActionSequence(this,ndata);
 
-   if (fWriteObjectWise) fWriteObjectWise->fActions.clear();
+   if (fWriteObjectWise) { fWriteObjectWise->fActions.clear(); fWriteObjectWise->ResetJIT(); }
    else fWriteObjectWise = new TStreamerInfoActions::TActionSequence(this,ndata);
 
    if (fReadMemberWise) fReadMemberWise->fActions.clear();
@@ -4166,6 +4176,51 @@ TStreamerInfoActions::TActionSequence *TStreamerInfoActions::TActionSequence::Cr
       return sequence;
 }
 
+/// Member wise sequences of a TStreamerInfo for the collections of its class, by
+/// collection class, collection proxy implementation and direction. Each sequence
+/// loops over a private copy of the collection proxy it was built for.
+struct TStreamerInfo::TCollectionActions {
+   struct TEntry {
+      std::unique_ptr<TVirtualCollectionProxy> fProxy;
+      std::unique_ptr<TStreamerInfoActions::TActionSequence> fSequence;
+   };
+   std::map<std::tuple<TClass *, std::type_index, Bool_t>, TEntry> fEntries;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the member wise actions to read or write a collection of this class
+/// through 'proxy'. They are built once per kind of collection and kept with the
+/// StreamerInfo, so that the branches of the many trees of a TChain sharing this
+/// layout do not have to build them again. The sequence loops over a copy of
+/// 'proxy': the sub-sequences derived from it must be pointed to the proxy they
+/// are used with.
+
+TStreamerInfoActions::TActionSequence *TStreamerInfo::GetCollectionMemberWiseActions(TVirtualCollectionProxy &proxy, Bool_t read)
+{
+   R__LOCKGUARD(gInterpreterMutex);
+
+   if (!fCollectionActions)
+      fCollectionActions = new TCollectionActions;
+   auto &entry = fCollectionActions->fEntries[std::make_tuple(proxy.GetCollectionClass(), std::type_index(typeid(proxy)), read)];
+   if (!entry.fSequence) {
+      entry.fProxy.reset(proxy.Generate());
+      if (read)
+         entry.fSequence.reset(TStreamerInfoActions::TActionSequence::CreateReadMemberWiseActions(this, *entry.fProxy));
+      else
+         entry.fSequence.reset(TStreamerInfoActions::TActionSequence::CreateWriteMemberWiseActions(this, *entry.fProxy));
+   }
+   return entry.fSequence.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the member wise actions built by GetCollectionMemberWiseActions.
+
+void TStreamerInfo::DeleteCollectionActions()
+{
+   delete fCollectionActions;
+   fCollectionActions = nullptr;
+}
+
 void TStreamerInfoActions::TActionSequence::AddToOffset(Int_t delta)
 {
    // Add the (potentially negative) delta to all the configuration's offset.  This is used by
@@ -4179,6 +4234,7 @@ void TStreamerInfoActions::TActionSequence::AddToOffset(Int_t delta)
       if (!iter->fConfiguration->fInfo->GetElements()->At(iter->fConfiguration->fElemId)->TestBit(TStreamerElement::kCache))
          iter->fConfiguration->AddToOffset(delta);
    }
+   ResetJIT();
 }
 
 void TStreamerInfoActions::TActionSequence::SetMissing()
@@ -4194,6 +4250,192 @@ void TStreamerInfoActions::TActionSequence::SetMissing()
       if (!iter->fConfiguration->fInfo->GetElements()->At(iter->fConfiguration->fElemId)->TestBit(TStreamerElement::kCache))
          iter->fConfiguration->SetMissing();
    }
+   ResetJIT();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the statement streaming the data member of 'action' if it is a basic
+/// type that JITCompile can inline, an empty string otherwise.
+
+static TString GetJITStatement(const TConfiguredAction &action)
+{
+   struct RBasicAction {
+      TStreamerInfoAction_t fAction;
+      const char *fType;
+      const char *fMethod;
+   };
+   static const RBasicAction gBasicActions[] = {
+      {ReadBasicType<Bool_t>, "Bool_t", "ReadBool"},          {ReadBasicType<Char_t>, "Char_t", "ReadChar"},
+      {ReadBasicType<Short_t>, "Short_t", "ReadShort"},       {ReadBasicType<Int_t>, "Int_t", "ReadInt"},
+      {ReadBasicType<Long_t>, "Long_t", "ReadLong"},          {ReadBasicType<Long64_t>, "Long64_t", "ReadLong64"},
+      {ReadBasicType<Float_t>, "Float_t", "ReadFloat"},       {ReadBasicType<Double_t>, "Double_t", "ReadDouble"},
+      {ReadBasicType<UChar_t>, "UChar_t", "ReadUChar"},       {ReadBasicType<UShort_t>, "UShort_t", "ReadUShort"},
+      {ReadBasicType<UInt_t>, "UInt_t", "ReadUInt"},          {ReadBasicType<ULong_t>, "ULong_t", "ReadULong"},
+      {ReadBasicType<ULong64_t>, "ULong64_t", "ReadULong64"}, {WriteBasicType<Bool_t>, "Bool_t", "WriteBool"},
+      {WriteBasicType<Char_t>, "Char_t", "WriteChar"},        {WriteBasicType<Short_t>, "Short_t", "WriteShort"},
+      {WriteBasicType<Int_t>, "Int_t", "WriteInt"},           {WriteBasicType<Long_t>, "Long_t", "WriteLong"},
+      {WriteBasicType<Long64_t>, "Long64_t", "WriteLong64"},  {WriteBasicType<Float_t>, "Float_t", "WriteFloat"},
+      {WriteBasicType<Double_t>, "Double_t", "WriteDouble"},  {WriteBasicType<UChar_t>, "UChar_t", "WriteUChar"},
+      {WriteBasicType<UShort_t>, "UShort_t", "WriteUShort"},  {WriteBasicType<UInt_t>, "UInt_t", "WriteUInt"},
+      {WriteBasicType<ULong_t>, "ULong_t", "WriteULong"},     {WriteBasicType<ULong64_t>, "ULong64_t", "WriteULong64"}};
+
+   const Int_t offset = action.fConfiguration->fOffset;
+   if (offset == TVirtualStreamerInfo::kMissing)
+      return "";
+   for (const auto &basic : gBasicActions) {
+      if (basic.fAction == action.fAction)
+         return TString::Format("buf.TBufferFile::%s(*(%s*)(obj + %d));", basic.fMethod, basic.fType, offset);
+   }
+   return "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compile with cling a function applying this sequence of actions to an object.
+///
+/// The basic type data members are streamed by inlined, non-virtual calls to
+/// TBufferFile; all the other actions (objects, strings, collections, arrays,
+/// conversions and other schema evolution rules, ...) are called back, in the
+/// same order, through JITApplyAction. The generated code only depends on the
+/// actions and offsets, so the compiled functions are cached and shared between
+/// sequences with the same layout (e.g. the same class, checksum and on-file
+/// version read from several files).
+///
+/// The compilation is attempted only once per sequence (until its actions are
+/// modified), if IsJITEnabled is true for its StreamerInfo and the sequence has
+/// at least one basic type member. TBufferFile::ApplySequence calls it on the
+/// first use of the sequence and then uses the compiled function, if any.
+///
+/// Returns true if a compiled function is available for this sequence.
+
+Bool_t TStreamerInfoActions::TActionSequence::JITCompile()
+{
+   if (fJITState != kJITNotTried)
+      return fJITAction != nullptr;
+   if (!IsJITEnabledForAny()) {
+      // Avoid the locking for the common case where no class is compiled.
+      fJITState = kJITNotUsed;
+      return kFALSE;
+   }
+
+   R__LOCKGUARD(gInterpreterMutex);
+   // Another thread might have been faster.
+   if (fJITState != kJITNotTried)
+      return fJITAction != nullptr;
+
+   TString body;
+   Bool_t hasInlined = kFALSE;
+   if (gInterpreter && fStreamerInfo && IsJITEnabled(fStreamerInfo)) {
+      for (size_t i = 0; i < fActions.size(); ++i) {
+         TString statement = GetJITStatement(fActions[i]);
+         if (statement.IsNull())
+            statement.Form("apply(buf, obj, sequence, %d);", (Int_t)i);
+         else
+            hasInlined = kTRUE;
+         body += "   ";
+         body += statement;
+         body += "\n";
+      }
+   }
+
+   JITAction_t func = nullptr;
+   if (hasInlined) {
+      static ROOT::Internal::TJITFunctionCache gCompiled;
+
+      void *ptr = nullptr;
+      if (!gCompiled.Find(body.Data(), ptr)) {
+         const Int_t id = gCompiled.NextId();
+         TString name = TString::Format("TStreamerInfoJIT::Sequence%d", id);
+         TString code = TString::Format("#pragma cling optimize(3)\n"
+                                        "#include \"TBufferFile.h\"\n"
+                                        "#include \"TStreamerInfoActions.h\"\n"
+                                        "namespace TStreamerInfoJIT {\n"
+                                        "// %s, version %d, checksum 0x%x\n"
+                                        "void Sequence%d(TBufferFile &buf, char *obj, const TStreamerInfoActions::TActionSequence *sequence,\n"
+                                        "   TStreamerInfoActions::TActionSequence::JITApply_t apply)\n"
+                                        "{\n   (void)sequence; (void)apply;\n%s}\n}\n",
+                                        fStreamerInfo->GetName(), fStreamerInfo->GetClassVersion(),
+                                        fStreamerInfo->GetCheckSum(), id, body.Data());
+         ptr = gCompiled.Compile(body.Data(), code.Data(), name.Data());
+         if (!ptr)
+            Warning("TActionSequence::JITCompile", "Compilation of the streaming actions of %s failed, using the regular actions",
+                    fStreamerInfo->GetName());
+      }
+      func = reinterpret_cast<JITAction_t>(ptr);
+   }
+   fJITAction = func;
+   fJITState = func ? kJITCompiled : kJITNotUsed;
+   return func != nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Apply the action at 'index' of 'sequence' on 'obj', called back by the
+/// cling-compiled sequences for the actions that were not inlined.
+
+Int_t TStreamerInfoActions::TActionSequence::JITApplyAction(TBuffer &buf, void *obj, const TActionSequence *sequence, Int_t index)
+{
+   return sequence->fActions[index](buf, obj);
+}
+
+static std::string &GetJITClasses()
+{
+   static std::string classes = gEnv->GetValue("TStreamerInfo.JIT", "no");
+   return classes;
+}
+
+static Bool_t IsJITDisabled(const TString &classes)
+{
+   return classes.IsNull() || classes == "no" || classes == "0";
+}
+
+/// Whether the compilation is enabled for at least one class, cached so that it
+/// can be checked without locking.
+static std::atomic<bool> &GetJITEnabledForAny()
+{
+   static std::atomic<bool> enabled{!IsJITDisabled(GetJITClasses().c_str())};
+   return enabled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return false if the object-wise actions of no StreamerInfo are compiled with
+/// cling, see SetJITClasses.
+
+Bool_t TStreamerInfoActions::TActionSequence::IsJITEnabledForAny()
+{
+   return GetJITEnabledForAny();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the object-wise actions of this StreamerInfo should be compiled
+/// with cling, see SetJITClasses.
+
+Bool_t TStreamerInfoActions::TActionSequence::IsJITEnabled(const TVirtualStreamerInfo *info)
+{
+   R__LOCKGUARD(gInterpreterMutex);
+   TString classes = GetJITClasses().c_str();
+   if (IsJITDisabled(classes))
+      return kFALSE;
+   if (classes == "yes" || classes == "1" || classes == "*")
+      return kTRUE;
+   std::unique_ptr<TObjArray> names(classes.Tokenize(" ,"));
+   for (auto name : *names) {
+      if (strcmp(name->GetName(), info->GetName()) == 0)
+         return kTRUE;
+   }
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the classes whose object-wise streaming actions are compiled with cling:
+/// a space separated list of class names, "yes" for all the classes or "no"
+/// (the default, set by the rootrc variable TStreamerInfo.JIT).
+///
+/// This applies to the action sequences not used yet.
+
+void TStreamerInfoActions::TActionSequence::SetJITClasses(const char *classes)
+{
+   R__LOCKGUARD(gInterpreterMutex);
+   GetJITClasses() = classes ? classes : "";
+   GetJITEnabledForAny() = !IsJITDisabled(GetJITClasses().c_str());
 }
 
 TStreamerInfoActions::TActionSequence *TStreamerInfoActions::TActionSequence::CreateCopy()
@@ -0,0 +1,77 @@
+#include "TBufferJSON.h"
+#include "TH1.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstring>
+#include <regex>
+#include <string>
+
+static std::uint32_t ReadLittleEndian32(const std::string &buf, std::size_t pos)
+{
+   std::uint32_t res = 0;
+   for (int n = 3; n >= 0; --n)
+      res = (res << 8) | (unsigned char)buf[pos + n];
+   return res;
+}
+
+TEST(TBufferJSON, BinaryJSONLayout)
+{
+   TH1D h("binjson", "binary json", 100, 0., 10.);
+   h.SetDirectory(nullptr);
+   // leading and trailing zeros are not stored
+   for (int bin = 11; bin <= 60; ++bin)
+      h.SetBinContent(bin, 0.5 * bin);
+
+   std::string msg = TBufferJSON::ConvertToBinaryJSON(&h, TBufferJSON::kNoSpaces);
+
+   ASSERT_GT(msg.size(), 8u);
+   EXPECT_EQ(msg.compare(0, 4, "RJB1"), 0);
+   const std::size_t jsonlen = ReadLittleEndian32(msg, 4);
+   const std::size_t blocksStart = (8 + jsonlen + 7) & ~std::size_t(7);
+   ASSERT_LE(blocksStart, msg.size());
+   const std::string json = msg.substr(8, jsonlen);
+   EXPECT_EQ(json.front(), '{');
+   EXPECT_EQ(json.back(), '}');
+   for (std::size_t pos = 8 + jsonlen; pos < blocksStart; ++pos)
+      EXPECT_EQ(msg[pos], ' ');
+
+   std::smatch match;
+   const std::regex arrayRegex(
+      "\"fArray\":\\{\"\\$arr\":\"Float64\",\"len\":(\\d+),\"o\":(\\d+),\"bin\":(\\d+),\"nb\":(\\d+)\\}");
+   ASSERT_TRUE(std::regex_search(json, match, arrayRegex)) << json;
+   EXPECT_EQ(std::stoi(match[1]), h.GetSize());
+   const std::size_t offset = std::stoul(match[2]);
+   const std::size_t bin = std::stoul(match[3]);
+   const std::size_t nbytes = std::stoul(match[4]);
+   EXPECT_EQ(offset, 11 * sizeof(Double_t));
+   EXPECT_EQ(nbytes, 50 * sizeof(Double_t));
+   EXPECT_EQ(bin % 8, 0u);
+   ASSERT_LE(blocksStart + bin + nbytes, msg.size());
+
+   // the block is the raw content of the array, in host byte order
+   std::vector<Double_t> values(nbytes / sizeof(Double_t));
+   std::memcpy(values.data(), msg.data() + blocksStart + bin, nbytes);
+   for (std::size_t i = 0; i < values.size(); ++i)
+      EXPECT_EQ(values[i], h.GetArray()[offset / sizeof(Double_t) + i]) << "element " << i;
+
+   // without binary blocks the same array is formatted in the JSON code
+   TString text = TBufferJSON::ConvertToJSON(&h, TBufferJSON::kNoSpaces);
+   EXPECT_EQ(text.Index("\"bin\":"), kNPOS);
+   EXPECT_NE(text.Index("\"fArray\":[0,0,0,0,0,0,0,0,0,0,0,5.5,6,"), kNPOS);
+}
+
+TEST(TBufferJSON, BinaryJSONZeroArrays)
+{
+   TH1D h("binjsonzero", "empty", 20, 0., 1.);
+   h.SetDirectory(nullptr);
+
+   std::string msg = TBufferJSON::ConvertToBinaryJSON(&h, TBufferJSON::kNoSpaces);
+   const std::size_t jsonlen = ReadLittleEndian32(msg, 4);
+   const std::string json = msg.substr(8, jsonlen);
+
+   // an array with only zeros has no binary block
+   EXPECT_NE(json.find("\"fArray\":{\"$arr\":\"Float64\",\"len\":22}"), std::string::npos) << json;
+   EXPECT_EQ(msg.size(), (8 + jsonlen + 7) & ~std::size_t(7));
+}
@@ -266,3 +266,91 @@ TEST(TBufferMerger, SetMaxTreeSize)
 
    RemoveFile("tbuffermerger_setmaxtreesize.root");
 }
+
+TEST(TBufferMerger, MaxQueuedBytes)
+{
+   int nthreads = 8;
+   int nwrites = 16;
+   int events_per_write = 1024;
+   size_t maxqueued = 256 * 1024;
+
+   ROOT::EnableThreadSafety();
+
+   {
+      TBufferMerger merger("tbuffermerger_maxqueued.root");
+      merger.SetMaxQueuedBytes(maxqueued);
+      merger.SetAutoSave(16 * 1024 * 1024); // Only merge when the queue is full
+      EXPECT_EQ(maxqueued, merger.GetMaxQueuedBytes());
+
+      std::vector<std::thread> threads;
+      for (int i = 0; i < nthreads; ++i) {
+         threads.emplace_back([=, &merger]() {
+            auto myfile = merger.GetFile();
+            auto mytree = new TTree("mytree", "mytree");
+
+            int n = 0;
+            mytree->Branch("n", &n, "n/I");
+            for (int w = 0; w < nwrites; ++w) {
+               for (int j = 0; j < events_per_write; ++j) {
+                  n = (i * nwrites + w) * events_per_write + j;
+                  mytree->Fill();
+               }
+               myfile->Write();
+            }
+            mytree->ResetBranchAddresses();
+         });
+      }
+
+      for (auto &&t : threads)
+         t.join();
+
+      auto stats = merger.GetStats();
+      EXPECT_LE(stats.fPeakQueuedBytes, maxqueued);
+      EXPECT_GT(stats.fMerges, 0u);
+      EXPECT_EQ(size_t(nthreads * nwrites), stats.fMergedBuffers + merger.GetQueueSize());
+   }
+
+   {
+      TFile f("tbuffermerger_maxqueued.root");
+      auto t = f.Get<TTree>("mytree");
+      ASSERT_TRUE(t != nullptr);
+      EXPECT_EQ(nthreads * nwrites * events_per_write, t->GetEntries());
+   }
+
+   RemoveFile("tbuffermerger_maxqueued.root");
+}
+
+TEST(TBufferMerger, KeepCompression)
+{
+   ROOT::EnableThreadSafety();
+
+   {
+      TBufferMerger merger("tbuffermerger_keepcompression.root", "RECREATE", 505);
+      merger.SetKeepCompression(true);
+      EXPECT_TRUE(merger.GetKeepCompression());
+
+      auto myfile = merger.GetFile();
+      myfile->SetCompressionSettings(101);
+      auto mytree = new TTree("mytree", "mytree");
+      Fill(mytree, 0, 1024);
+      myfile->Write();
+   }
+
+   {
+      TFile f("tbuffermerger_keepcompression.root");
+      auto t = f.Get<TTree>("mytree");
+      ASSERT_TRUE(t != nullptr);
+      EXPECT_EQ(1024, t->GetEntries());
+
+      int n, sum = 0;
+      t->SetBranchAddress("n", &n);
+      for (int i = 0; i < t->GetEntries(); ++i) {
+         t->GetEntry(i);
+         sum += n;
+      }
+      t->ResetBranchAddresses();
+      EXPECT_EQ(523776, sum);
+   }
+
+   RemoveFile("tbuffermerger_keepcompression.root");
+}
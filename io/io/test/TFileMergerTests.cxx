@@ -2,9 +2,16 @@
 
 #include "TFileMerger.h"
 
+#include "RConfigure.h"
+#include "TH1D.h"
 #include "TMemFile.h"
+#include "TROOT.h"
 #include "TTree.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 static void CreateATuple(TMemFile &file, const char *name, double value)
 {
    auto mytree = new TTree(name, "A tree");
@@ -68,3 +75,45 @@ TEST(TFileMerger, CreateWithUnwritableTFilePointer)
    ROOT_EXPECT_ERROR(merger.OutputFile(std::move(output)), "TFileMerger::OutputFile",
                      "output file output.root is not writable");
 }
+
+#ifdef R__USE_IMT
+TEST(TFileMerger, ParallelMerge)
+{
+   ROOT::EnableImplicitMT(4);
+
+   constexpr int nFiles = 4;
+   constexpr int nHistos = 20;
+   std::vector<std::unique_ptr<TMemFile>> inputs;
+   for (int i = 0; i < nFiles; ++i) {
+      inputs.emplace_back(new TMemFile(("input" + std::to_string(i) + ".root").c_str(), "RECREATE"));
+      for (int j = 0; j < nHistos; ++j) {
+         TH1D h(("h" + std::to_string(j)).c_str(), "h", 10, 0, 10);
+         h.SetDirectory(nullptr);
+         h.Fill(j % 10, i + 1);
+         inputs.back()->WriteTObject(&h);
+      }
+      CreateATuple(*inputs.back(), "tree", i);
+   }
+
+   TFileMerger merger(kFALSE);
+   merger.SetParallelMerge();
+   ASSERT_TRUE(merger.OutputFile(std::unique_ptr<TMemFile>(new TMemFile("parallel.root", "CREATE"))));
+   for (auto &input : inputs)
+      merger.AddFile(input.get(), false);
+   EXPECT_TRUE(merger.PartialMerge());
+
+   auto &result = *static_cast<TMemFile *>(merger.GetOutputFile());
+   for (int j = 0; j < nHistos; ++j) {
+      auto h = result.Get<TH1D>(("h" + std::to_string(j)).c_str());
+      ASSERT_TRUE(h != nullptr);
+      EXPECT_EQ(nFiles, h->GetEntries());
+      EXPECT_DOUBLE_EQ(1. + 2. + 3. + 4., h->GetBinContent(h->FindBin(j % 10)));
+   }
+   auto t = result.Get<TTree>("tree");
+   ASSERT_TRUE(t != nullptr);
+   EXPECT_EQ(nFiles, t->GetEntries());
+   CheckTree(result, "tree", 0.);
+
+   ROOT::DisableImplicitMT();
+}
+#endif
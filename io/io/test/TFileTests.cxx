@@ -1,7 +1,26 @@
+#include "TArrayC.h"
+#include "TEnv.h"
 #include "TFile.h"
+#include "TFileCacheWrite.h"
+#include "TKey.h"
+#include "TList.h"
+#include "TMap.h"
+#include "TNamed.h"
+#include "TObjString.h"
+#include "TROOT.h"
+#include "TStreamerInfo.h"
+#include "TSystem.h"
+#include "TVirtualCollectionProxy.h"
+#include "ROOT/RSharedPayloadCache.hxx"
 
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
 // Tests ROOT-9857
 TEST(TFile, ReadFromSameFile)
 {
@@ -21,4 +40,356 @@ TEST(TFile, ReadFromSameFile)
    auto o2 = f2.Get(objpath);
 
    EXPECT_TRUE(o1 != o2) << "Same objects read from two different files have the same pointer!";
-}
\ No newline at end of file
+}
+
+TEST(TFile, KeyIndex)
+{
+   const auto filename = "TFileKeyIndex.root";
+   {
+      TFile f(filename, "RECREATE");
+      for (int i = 0; i < 100; ++i) {
+         TNamed obj(TString::Format("obj%d", i).Data(), "first");
+         obj.Write();
+      }
+      // A second cycle for a few keys.
+      for (int i = 0; i < 100; i += 10) {
+         TNamed obj(TString::Format("obj%d", i).Data(), "second");
+         obj.Write();
+      }
+      TNamed inner("inner", "inner");
+      f.mkdir("sub")->WriteObject(&inner, "inner");
+   }
+
+   std::vector<std::string> expected;
+   {
+      gEnv->SetValue("TFile.KeyIndexThreshold", 0);
+      TFile f(filename);
+      for (auto key : TRangeDynCast<TKey>(f.GetListOfKeys()))
+         expected.push_back(std::string(key->GetName()) + ";" + std::to_string(key->GetCycle()));
+   }
+
+   gEnv->SetValue("TFile.KeyIndexThreshold", 10);
+   TFile f(filename);
+   EXPECT_EQ(111, f.GetNkeys());
+
+   auto obj = f.Get<TNamed>("obj20");
+   ASSERT_NE(nullptr, obj);
+   EXPECT_STREQ("second", obj->GetTitle());
+   obj = f.Get<TNamed>("obj20;1");
+   ASSERT_NE(nullptr, obj);
+   EXPECT_STREQ("first", obj->GetTitle());
+   EXPECT_EQ(nullptr, f.Get<TNamed>("obj21;2"));
+   EXPECT_EQ(nullptr, f.Get("missing"));
+
+   TKey *key = f.GetKey("obj30");
+   ASSERT_NE(nullptr, key);
+   EXPECT_EQ(2, key->GetCycle());
+   EXPECT_EQ(key, f.FindKey("obj30;2"));
+   key = f.GetKey("obj30", 1);
+   ASSERT_NE(nullptr, key);
+   EXPECT_EQ(1, key->GetCycle());
+   EXPECT_STREQ("TNamed", key->GetClassName());
+
+   auto inner = f.Get<TNamed>("sub/inner");
+   ASSERT_NE(nullptr, inner);
+   EXPECT_STREQ("inner", inner->GetTitle());
+
+   // Iterating creates all the keys, in file order, including those already looked up.
+   std::vector<std::string> names;
+   for (auto k : TRangeDynCast<TKey>(f.GetListOfKeys()))
+      names.push_back(std::string(k->GetName()) + ";" + std::to_string(k->GetCycle()));
+   EXPECT_EQ(expected, names);
+   EXPECT_EQ(111, f.GetNkeys());
+   EXPECT_EQ(key, f.GetKey("obj30", 1));
+
+   gEnv->SetValue("TFile.KeyIndexThreshold", 10000);
+   gSystem->Unlink(filename);
+}
+
+TEST(TFile, KeyIndexShortAndDeletedKeys)
+{
+   const auto filename = "TFileKeyIndexShort.root";
+   {
+      TFile f(filename, "RECREATE");
+      for (int i = 0; i < 20; ++i) {
+         TNamed obj(TString::Format("obj%d", i).Data(), "title");
+         obj.Write();
+      }
+      // The last key header is only 33 bytes long: class "TMap", empty name and title.
+      TMap map;
+      f.WriteTObject(&map);
+   }
+
+   gEnv->SetValue("TFile.KeyIndexThreshold", 10);
+   TFile f(filename);
+   EXPECT_EQ(21, f.GetNkeys());
+   TKey *key = f.GetKey("");
+   ASSERT_NE(nullptr, key);
+   EXPECT_STREQ("TMap", key->GetClassName());
+
+   // Deleting a key looked up in the index removes it from the index.
+   key = f.GetKey("obj5");
+   ASSERT_NE(nullptr, key);
+   delete key;
+   EXPECT_EQ(20, f.GetNkeys());
+   EXPECT_EQ(nullptr, f.GetKey("obj5"));
+   ASSERT_NE(nullptr, f.GetKey("obj6"));
+   EXPECT_EQ(20, f.GetListOfKeys()->GetSize());
+   EXPECT_EQ(nullptr, f.GetListOfKeys()->FindObject("obj5"));
+
+   gEnv->SetValue("TFile.KeyIndexThreshold", 10000);
+   gSystem->Unlink(filename);
+}
+
+TEST(TFile, ConcurrentRead)
+{
+   const auto filename = "TFileConcurrentRead.root";
+   {
+      TFile f(filename, "RECREATE");
+      auto sub = f.mkdir("sub")->mkdir("deeper");
+      for (int i = 0; i < 20; ++i) {
+         // Long titles are compressed.
+         TNamed obj(TString::Format("obj%d", i).Data(), std::string(100 * i, 'a' + i).c_str());
+         f.WriteObject(&obj, obj.GetName());
+         sub->WriteObject(&obj, obj.GetName());
+      }
+   }
+
+   ROOT::EnableThreadSafety();
+   TFile f(filename, "READ_CONCURRENT");
+   ASSERT_FALSE(f.IsZombie());
+   EXPECT_TRUE(f.IsConcurrentRead());
+   EXPECT_STREQ("READ", f.GetOption());
+   const Int_t nInMemory = f.GetList()->GetSize();
+   const Long64_t bytesRead = f.GetBytesRead();
+
+   std::atomic<int> nErrors{0};
+   std::vector<std::thread> threads;
+   for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&f, &nErrors, t]() {
+         for (int n = 0; n < 100; ++n) {
+            const int i = (n + 7 * t) % 20;
+            const std::string title(100 * i, 'a' + i);
+            std::unique_ptr<TNamed> top(f.Get<TNamed>(TString::Format("obj%d", i)));
+            std::unique_ptr<TObject> deep(f.Get(TString::Format("sub/deeper/obj%d", i)));
+            auto named = dynamic_cast<TNamed *>(deep.get());
+            if (!top || top->GetTitle() != title || !named || named->GetTitle() != title)
+               ++nErrors;
+         }
+      });
+   }
+   for (auto &thread : threads)
+      thread.join();
+
+   EXPECT_EQ(0, nErrors);
+   EXPECT_EQ(nInMemory, f.GetList()->GetSize());
+   EXPECT_GT(f.GetBytesRead(), bytesRead);
+   EXPECT_EQ(1, f.ReOpen("UPDATE"));
+   f.Close();
+   gSystem->Unlink(filename);
+}
+
+TEST(TFile, WriteBehind)
+{
+   const auto filename = "TFileWriteBehind.root";
+   {
+      TFile f(filename, "RECREATE");
+      auto cache = new TFileCacheWrite(&f, 20000);
+      ASSERT_TRUE(cache->SetWriteBehind(2));
+      EXPECT_TRUE(cache->IsWriteBehind());
+      for (int i = 0; i < 2000; ++i) {
+         TNamed obj(TString::Format("obj%d", i).Data(), std::string(i % 300, 'a' + i % 26).c_str());
+         obj.Write();
+      }
+      // Larger than the cache buffer.
+      TNamed large("large", std::string(50000, 'x').c_str());
+      large.Write();
+      // Read back through the file while writes may be in flight.
+      auto obj = f.Get<TNamed>("obj1000");
+      ASSERT_NE(nullptr, obj);
+      EXPECT_EQ(std::string(1000 % 300, 'a' + 1000 % 26), obj->GetTitle());
+   }
+
+   TFile f(filename);
+   ASSERT_FALSE(f.IsZombie());
+   EXPECT_EQ(2001, f.GetNkeys());
+   for (int i = 0; i < 2000; i += 7) {
+      auto obj = f.Get<TNamed>(TString::Format("obj%d", i));
+      ASSERT_NE(nullptr, obj);
+      EXPECT_EQ(std::string(i % 300, 'a' + i % 26), obj->GetTitle());
+   }
+   auto large = f.Get<TNamed>("large");
+   ASSERT_NE(nullptr, large);
+   EXPECT_EQ(50000, (int)strlen(large->GetTitle()));
+   gSystem->Unlink(filename);
+}
+
+TEST(TFile, WriteBehindInFlight)
+{
+   const auto filename = "TFileWriteBehindInFlight.root";
+   {
+      TFile f(filename, "RECREATE");
+      auto cache = new TFileCacheWrite(&f, 20000);
+      ASSERT_TRUE(cache->SetWriteBehind(2));
+      // Keep the submitted buffers from being written: the writes must return anyway.
+      ROOT::Internal::SuspendWriteBehind(*cache, true);
+      int n = 0;
+      while (n < 1000 && cache->GetWriteBehindInFlight() == 0) {
+         TNamed obj(TString::Format("obj%d", n).Data(), std::string(100, 'a' + n % 26).c_str());
+         obj.Write();
+         ++n;
+      }
+      EXPECT_EQ(1, cache->GetWriteBehindInFlight());
+      EXPECT_LT(n, 1000);
+      EXPECT_FALSE(cache->Flush());
+      EXPECT_EQ(0, cache->GetWriteBehindInFlight());
+      EXPECT_EQ(0, cache->GetBytesInCache());
+   }
+
+   TFile f(filename);
+   ASSERT_FALSE(f.IsZombie());
+   auto obj = f.Get<TNamed>("obj0");
+   ASSERT_NE(nullptr, obj);
+   EXPECT_EQ(std::string(100, 'a'), obj->GetTitle());
+   gSystem->Unlink(filename);
+}
+
+TEST(TFile, WriteBehindStraddlingRead)
+{
+   const auto filename = "TFileWriteBehindStraddling.root";
+   TFile f(filename, "RECREATE");
+   auto cache = new TFileCacheWrite(&f, 20000);
+   ASSERT_TRUE(cache->SetWriteBehind(2));
+   ROOT::Internal::SuspendWriteBehind(*cache, true);
+   // Write until a key is cut at the start of the current cache buffer: its
+   // beginning is in flight, its end is still in the cache.
+   TKey *straddling = nullptr;
+   for (int n = 0; n < 1000 && !straddling; ++n) {
+      TNamed obj(TString::Format("obj%d", n).Data(), std::string(100 + n % 50, 'a' + n % 26).c_str());
+      obj.Write();
+      const Long64_t start = f.GetEND() - cache->GetBytesInCache();
+      for (auto key : TRangeDynCast<TKey>(f.GetListOfKeys())) {
+         if (key->GetSeekKey() < start && start < key->GetSeekKey() + key->GetNbytes()) {
+            straddling = key;
+            break;
+         }
+      }
+   }
+   ASSERT_NE(nullptr, straddling);
+   EXPECT_LE(1, cache->GetWriteBehindInFlight());
+   const int n = TString(straddling->GetName() + 3).Atoi();
+   auto obj = f.Get<TNamed>(straddling->GetName());
+   ASSERT_NE(nullptr, obj);
+   EXPECT_EQ(std::string(100 + n % 50, 'a' + n % 26), obj->GetTitle());
+   f.Close();
+   gSystem->Unlink(filename);
+}
+
+TEST(TFile, SharedStreamerInfoRecord)
+{
+   // Files with the same StreamerInfo record, as in a chain.
+   const char *filenames[] = {"TFileSharedSI1.root", "TFileSharedSI2.root"};
+   for (auto filename : filenames) {
+      TFile f(filename, "RECREATE");
+      TObjString str("payload");
+      str.Write("str");
+   }
+   const Int_t uid = TObjString::Class()->GetStreamerInfo()->GetNumber();
+
+   Long64_t hits[2];
+   for (int i = 0; i < 2; ++i) {
+      TFile f(filenames[i]);
+      hits[i] = ROOT::Internal::GetStreamerInfoRecordCacheHits();
+      ASSERT_FALSE(f.IsZombie());
+      ASSERT_LT(uid, f.GetClassIndex()->GetSize());
+      EXPECT_EQ(1, f.GetClassIndex()->fArray[uid]) << filenames[i];
+   }
+   // The record of the second file is the one already read from the first.
+   EXPECT_EQ(hits[0] + 1, hits[1]);
+
+   // The member wise actions for a collection of a class are built once, for all the
+   // collection proxies of the same kind, e.g. of the branches in the files of a chain.
+   TClass *vecClass = TClass::GetClass("vector<TNamed>");
+   ASSERT_NE(nullptr, vecClass);
+   ASSERT_NE(nullptr, vecClass->GetCollectionProxy());
+   auto info = static_cast<TStreamerInfo *>(TNamed::Class()->GetStreamerInfo());
+   std::unique_ptr<TVirtualCollectionProxy> proxy1(vecClass->GetCollectionProxy()->Generate());
+   std::unique_ptr<TVirtualCollectionProxy> proxy2(vecClass->GetCollectionProxy()->Generate());
+   auto readActions = info->GetCollectionMemberWiseActions(*proxy1, kTRUE);
+   ASSERT_NE(nullptr, readActions);
+   EXPECT_EQ(readActions, info->GetCollectionMemberWiseActions(*proxy2, kTRUE));
+   auto writeActions = info->GetCollectionMemberWiseActions(*proxy1, kFALSE);
+   EXPECT_NE(readActions, writeActions);
+   EXPECT_EQ(writeActions, info->GetCollectionMemberWiseActions(*proxy2, kFALSE));
+
+   // The second file skips the record when reopened, it must still keep its classes.
+   {
+      TFile f(filenames[1], "UPDATE");
+      TNamed named("named", "title");
+      named.Write();
+   }
+   TFile f(filenames[1]);
+   std::unique_ptr<TList> infos(f.GetStreamerInfoList());
+   ASSERT_NE(nullptr, infos);
+   EXPECT_NE(nullptr, infos->FindObject("TObjString"));
+   EXPECT_NE(nullptr, infos->FindObject("TNamed"));
+   auto str = f.Get<TObjString>("str");
+   ASSERT_NE(nullptr, str);
+   EXPECT_EQ(std::string("payload"), str->GetString().Data());
+
+   for (auto filename : filenames)
+      gSystem->Unlink(filename);
+}
+
+#ifndef _WIN32
+TEST(TFile, SharedMemory)
+{
+   const auto filename = "TFileSharedMemory.root";
+   {
+      TFile f(filename, "RECREATE");
+      for (int i = 0; i < 10; ++i) {
+         TNamed obj(TString::Format("obj%d", i).Data(), std::string(10000 + i, 'a' + i).c_str());
+         obj.Write();
+      }
+   }
+
+   // Two readers sharing the file, as two processes would.
+   std::unique_ptr<TFile> first(TFile::Open(TString::Format("shm://%s", filename)));
+   ASSERT_NE(nullptr, first);
+   ASSERT_NE(nullptr, first->GetSharedPayloads());
+   std::unique_ptr<TFile> second(TFile::Open(TString::Format("shm://%s", filename)));
+   ASSERT_NE(nullptr, second);
+   ASSERT_NE(nullptr, second->GetSharedPayloads());
+   EXPECT_EQ(first->GetSharedPayloads()->GetName(), second->GetSharedPayloads()->GetName());
+
+   auto key = first->GetKey("obj3");
+   ASSERT_NE(nullptr, key);
+   ASSERT_LT(key->GetNbytes() - key->GetKeylen(), key->GetObjlen());
+   const auto version = ROOT::Internal::RSharedPayloadCache::MakeVersion(key->GetDatime().Get(), key->GetCycle());
+   EXPECT_EQ(nullptr, second->GetSharedPayloads()->Find(key->GetSeekKey(), version, key->GetObjlen()));
+   std::unique_ptr<TNamed> obj(first->Get<TNamed>("obj3"));
+   ASSERT_NE(nullptr, obj);
+   EXPECT_NE(nullptr, second->GetSharedPayloads()->Find(key->GetSeekKey(), version, key->GetObjlen()));
+   // A key written at the same position with another date or cycle does not match.
+   const auto otherVersion =
+      ROOT::Internal::RSharedPayloadCache::MakeVersion(key->GetDatime().Get() + 1, key->GetCycle());
+   EXPECT_EQ(nullptr, second->GetSharedPayloads()->Find(key->GetSeekKey(), otherVersion, key->GetObjlen()));
+   EXPECT_EQ(nullptr, second->GetSharedPayloads()->Find(
+                         key->GetSeekKey(), ROOT::Internal::RSharedPayloadCache::MakeVersion(key->GetDatime().Get(), 2),
+                         key->GetObjlen()));
+
+   std::unique_ptr<TFile> reader(TFile::Open(filename));
+   ASSERT_TRUE(reader->AttachSharedMemory(0, /*readOnly*/ true));
+   EXPECT_TRUE(reader->GetSharedPayloads()->IsReadOnly());
+   for (auto f : {second.get(), reader.get()}) {
+      for (int i = 0; i < 10; ++i) {
+         std::unique_ptr<TNamed> named(f->Get<TNamed>(TString::Format("obj%d", i)));
+         ASSERT_NE(nullptr, named);
+         EXPECT_EQ(std::string(10000 + i, 'a' + i), named->GetTitle());
+      }
+   }
+
+   EXPECT_TRUE(first->UnlinkSharedMemory());
+   gSystem->Unlink(filename);
+}
+#endif
@@ -0,0 +1,67 @@
+#include "TAttMarker.h"
+#include "TBufferFile.h"
+#include "TClass.h"
+#include "TStreamerInfo.h"
+#include "TStreamerInfoActions.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+static void ResetMarkerActions(TStreamerInfo *info)
+{
+   info->GetReadObjectWiseActions()->ResetJIT();
+   info->GetWriteObjectWiseActions()->ResetJIT();
+}
+
+TEST(TStreamerInfoJIT, RoundTrip)
+{
+   auto info = static_cast<TStreamerInfo *>(TAttMarker::Class()->GetStreamerInfo());
+   ASSERT_NE(info, nullptr);
+
+   // Reference buffer written by the regular actions.
+   TStreamerInfoActions::TActionSequence::SetJITClasses("no");
+   ResetMarkerActions(info);
+   TAttMarker in(kRed, 21, 1.5);
+   TBufferFile reference(TBuffer::kWrite);
+   in.Streamer(reference);
+   EXPECT_EQ(info->GetWriteObjectWiseActions()->fJITAction.load(), nullptr);
+
+   TStreamerInfoActions::TActionSequence::SetJITClasses("TAttMarker");
+   ResetMarkerActions(info);
+   TBufferFile buf(TBuffer::kWrite);
+   in.Streamer(buf);
+   EXPECT_NE(info->GetWriteObjectWiseActions()->fJITAction.load(), nullptr);
+   ASSERT_EQ(buf.Length(), reference.Length());
+   EXPECT_EQ(memcmp(buf.Buffer(), reference.Buffer(), buf.Length()), 0);
+
+   buf.SetReadMode();
+   buf.SetBufferOffset(0);
+   TAttMarker out;
+   out.Streamer(buf);
+   EXPECT_NE(info->GetReadObjectWiseActions()->fJITAction.load(), nullptr);
+   EXPECT_EQ(out.GetMarkerColor(), kRed);
+   EXPECT_EQ(out.GetMarkerStyle(), 21);
+   EXPECT_FLOAT_EQ(out.GetMarkerSize(), 1.5);
+
+   TStreamerInfoActions::TActionSequence::SetJITClasses("no");
+   ResetMarkerActions(info);
+}
+
+TEST(TStreamerInfoJIT, OtherClassesNotCompiled)
+{
+   auto info = static_cast<TStreamerInfo *>(TAttMarker::Class()->GetStreamerInfo());
+   ASSERT_NE(info, nullptr);
+
+   TStreamerInfoActions::TActionSequence::SetJITClasses("TAttLine TAttFill");
+   ResetMarkerActions(info);
+   EXPECT_TRUE(TStreamerInfoActions::TActionSequence::IsJITEnabledForAny());
+   EXPECT_FALSE(TStreamerInfoActions::TActionSequence::IsJITEnabled(info));
+   EXPECT_FALSE(info->GetReadObjectWiseActions()->JITCompile());
+
+   TStreamerInfoActions::TActionSequence::SetJITClasses("no");
+   ResetMarkerActions(info);
+   EXPECT_FALSE(TStreamerInfoActions::TActionSequence::IsJITEnabledForAny());
+   EXPECT_FALSE(info->GetReadObjectWiseActions()->JITCompile());
+   EXPECT_EQ(info->GetReadObjectWiseActions()->fJITState.load(), TStreamerInfoActions::TActionSequence::kJITNotUsed);
+}
@@ -343,6 +343,11 @@
         * Can be enabled by adding "wrong_http_response" parameter to URL when using JSROOT UI
         * @default false */
       HandleWrongHttpResponse: false,
+      /** @summary Request objects from THttpServer as binary JSON, where arrays are transferred as raw binary blocks
+        * @desc Used only when server announces support of "root.jbin" requests.
+        * Can be enabled by adding "binary_json" parameter to URL when using JSROOT UI
+        * @default false */
+      BinaryJSON: false,
       /** @summary Configures keybord key press handling
         * @desc Can be disabled to prevent keys heandling in complex HTML layouts
         * @default true */
@@ -811,14 +816,28 @@
 
    /** @summary Should be used to parse JSON string produced with TBufferJSON class
      * @desc Replace all references inside object like { "$ref": "1" }
-     * @param {object|string} json  object where references will be replaced
+     * Also decodes binary JSON message produced with TBufferJSON::ConvertToBinaryJSON
+     * @param {object|string|ArrayBuffer} json  object where references will be replaced
      * @returns {object} parsed object */
    JSROOT.parse = function(json) {
 
       if (!json) return null;
 
-      let obj = (typeof json == 'string') ? JSON.parse(json) : json,
-          map = [], newfmt = undefined;
+      let obj = json, map = [], newfmt = undefined, binbuf = null, binstart = 0;
+
+      if (typeof json == 'string') {
+         obj = JSON.parse(json);
+      } else if (json instanceof ArrayBuffer) {
+         // signature "RJB1", JSON length, JSON code and binary blocks aligned to 8 bytes
+         let hdr = new DataView(json);
+         if ((json.byteLength < 8) || (hdr.getUint32(0, true) !== 0x31424A52))
+            throw new Error('Not a binary JSON message');
+         let jsonlen = hdr.getUint32(4, true),
+             decoder = (typeof TextDecoder != 'undefined') ? new TextDecoder() : new (require('util').TextDecoder)();
+         obj = JSON.parse(decoder.decode(new Uint8Array(json, 8, jsonlen)));
+         binbuf = json;
+         binstart = (8 + jsonlen + 7) & ~7;
+      }
 
       function unref_value(value) {
          if ((value===null) || (value===undefined)) return;
@@ -871,7 +890,27 @@
             }
             for (let k=0;k<value.len;++k) arr[k] = dflt;
 
-            if (value.b !== undefined) {
+            if (value.bin !== undefined) {
+               // raw block of binary JSON message
+               if (!binbuf) throw new Error('Binary array block outside of binary JSON message');
+               let pos = binstart + value.bin, nb = value.nb, o = value.o || 0;
+               switch (value.$arr) {
+                  case "Bool": {
+                     let src = new Uint8Array(binbuf, pos, nb);
+                     for (let k = 0; k < nb; ++k) arr[o + k] = (src[k] !== 0);
+                     break;
+                  }
+                  case "Int64":
+                  case "Uint64": {
+                     let dv = new DataView(binbuf, pos, nb), signed = (value.$arr === "Int64");
+                     for (let k = 0; k < nb/8; ++k)
+                        arr[o/8 + k] = (signed ? dv.getInt32(k*8 + 4, true) : dv.getUint32(k*8 + 4, true)) * 4294967296 + dv.getUint32(k*8, true);
+                     break;
+                  }
+                  default:
+                     new Uint8Array(arr.buffer, o, nb).set(new Uint8Array(binbuf, pos, nb));
+               }
+            } else if (value.b !== undefined) {
                // base64 coding
 
                let atob_func = JSROOT.nodejs ? require('atob') : window.atob;
@@ -1193,8 +1232,10 @@
          if (this.nodejs_checkzip && (this.getResponseHeader("content-encoding") == "gzip")) {
             // special handling of gzipped JSON objects in Node.js
             let zlib = require('zlib'),
-                res = zlib.unzipSync(Buffer.from(this.response)),
-                obj = JSON.parse(res); // zlib returns Buffer, use JSON to parse it
+                res = zlib.unzipSync(Buffer.from(this.response));
+            if (this.kind == "jbin")
+               return this.http_callback(JSROOT.parse(res.buffer.slice(res.byteOffset, res.byteOffset + res.byteLength)));
+            let obj = JSON.parse(res); // zlib returns Buffer, use JSON to parse it
             return this.http_callback(JSROOT.parse(obj));
          }
 
@@ -1203,6 +1244,7 @@
             case "posttext":
             case "text": return this.http_callback(this.responseText);
             case "object": return this.http_callback(JSROOT.parse(this.responseText));
+            case "jbin": return this.http_callback(JSROOT.parse(this.response));
             case "multi": return this.http_callback(JSROOT.parseMulti(this.responseText));
             case "head": return this.http_callback(this);
          }
@@ -1226,9 +1268,9 @@
 
       xhr.open(method, url, async);
 
-      if ((kind == "bin") || (kind == "buf")) xhr.responseType = 'arraybuffer';
+      if ((kind == "bin") || (kind == "buf") || (kind == "jbin")) xhr.responseType = 'arraybuffer';
 
-      if (JSROOT.nodejs && (method == "GET") && (kind === "object") && (url.indexOf('.json.gz')>0)) {
+      if (JSROOT.nodejs && (method == "GET") && (((kind === "object") && (url.indexOf('.json.gz')>0)) || ((kind === "jbin") && (url.indexOf('.jbin.gz')>0)))) {
          xhr.nodejs_checkzip = true;
          xhr.responseType = 'arraybuffer';
       }
@@ -1242,6 +1284,7 @@
      *    - "buf" - abstract binary data, result as ArrayBuffer (default)
      *    - "text" - returns req.responseText
      *    - "object" - returns JSROOT.parse(req.responseText)
+     *    - "jbin" - binary JSON produced by TBufferJSON::ConvertToBinaryJSON, returns JSROOT.parse(req.response)
      *    - "multi" - returns correctly parsed multi.json request
      *    - "xml" - returns req.responseXML
      *    - "head" - returns request itself, uses "HEAD" request method
@@ -2174,6 +2217,8 @@
       if (d.has('nocache')) JSROOT.settings.NoCache = (new Date).getTime(); // use timestamp to overcome cache limitation
       if (d.has('wrong_http_response') || JSROOT.decodeUrl().has('wrong_http_response'))
          JSROOT.settings.HandleWrongHttpResponse = true; // server may send wrong content length by partial requests, use other method to control this
+      if (d.has('binary_json') || JSROOT.decodeUrl().has('binary_json'))
+         JSROOT.settings.BinaryJSON = true; // request objects as binary JSON when server supports it
       if (d.has('nosap')) _.sap = undefined; // let ignore sap loader even with openui5 loaded
 
       return this;
@@ -1964,7 +1964,17 @@ JSROOT.define(['d3', 'painter'], (d3, jsrp) => {
          return Promise.resolve(obj);
       }
 
-      if (req.length == 0) req = 'root.json.gz?compact=23';
+      if (req.length == 0) {
+         // binary JSON used when supported by the server
+         let prnt = item;
+         while (prnt && (prnt._online === undefined)) prnt = prnt._parent;
+         if (JSROOT.settings.BinaryJSON && prnt && prnt._jbin) {
+            req = 'root.jbin.gz?compact=3';
+            req_kind = 'jbin';
+         } else {
+            req = 'root.json.gz?compact=23';
+         }
+      }
 
       if (url.length > 0) url += "/";
       url += req;
@@ -114,6 +114,9 @@ if ((typeof document === "undefined") || (typeof window === "undefined")) {
       // server may send wrong content length by partial requests, use other method to control this
       if (d.has('wrong_http_response') || JSROOT.decodeUrl().has('wrong_http_response'))
          JSROOT.settings.HandleWrongHttpResponse = true;
+      // request objects as binary JSON when server supports it
+      if (d.has('binary_json') || JSROOT.decodeUrl().has('binary_json'))
+         JSROOT.settings.BinaryJSON = true;
       // let ignore sap loader even with openui5 loaded
       if (d.has('nosap')) JSROOT._.sap = undefined;
 
@@ -27,6 +27,7 @@
   \param -O   Re-optimize basket size when merging TTree
   \param -v   Explicitly set the verbosity level: 0 request no output, 99 is the default
   \param -j   Parallelise the execution in multiple processes
+  \param -jt  Merge in-process with multiple threads (see TFileMerger::SetParallelMerge)
   \param -dbg  Parallelise the execution in multiple processes in debug mode (Does not delete  partial  files  stored
               inside working directory)
   \param -d   Carry out the partial multiprocess execution in the specified directory
@@ -80,6 +81,12 @@
   (i.e. direct copy of the raw byte on disk). The "fast" mode is typically
   5 times faster than the mode unzipping and unstreaming the baskets.
 
+  With -jt [nthreads], the merge runs in a single process with a pool of
+  threads (by default one per logical core): histograms are read and merged
+  in parallel, the next set of input files (see -n) is opened while the
+  current one is merged, and the trees that need recompression are refilled
+  in parallel. No partial files are written.
+
   If the option -cachesize is used, hadd will resize (or disable if 0) the
   prefetching cache use to speed up I/O operations.
 
@@ -103,6 +110,7 @@
 #include "THashList.h"
 #include "TKey.h"
 #include "TClass.h"
+#include "TROOT.h"
 #include "TSystem.h"
 #include "TUUID.h"
 #include "ROOT/StringConv.hxx"
@@ -139,6 +147,7 @@ int main( int argc, char **argv )
    Bool_t keepCompressionAsIs = kFALSE;
    Bool_t useFirstInputCompression = kFALSE;
    Bool_t multiproc = kFALSE;
+   Bool_t multithread = kFALSE;
    Bool_t debug = kFALSE;
    Int_t maxopenedfiles = 0;
    Int_t verbosity = 99;
@@ -146,6 +155,7 @@ int main( int argc, char **argv )
    SysInfo_t s;
    gSystem->GetSysInfo(&s);
    auto nProcesses = s.fCpus;
+   UInt_t nThreads = 0;
    auto workingDir = gSystem->TempDirectory();
    int outputPlace = 0;
    int ffirst = 2;
@@ -213,6 +223,30 @@ int main( int argc, char **argv )
          }
          multiproc = kTRUE;
          ++ffirst;
+      } else if (strcmp(argv[a], "-jt") == 0) {
+         // If the number of threads is not specified, use the default.
+         if (a + 1 != argc && argv[a + 1][0] != '-') {
+            Bool_t isNumber = kTRUE;
+            for (char *c = argv[a + 1]; *c != '\0'; ++c) {
+               if (!isdigit(*c)) {
+                  isNumber = kFALSE;
+                  break;
+               }
+            }
+            if (isNumber) {
+               Long_t request = strtol(argv[a + 1], 0, 10);
+               if (request < kMaxInt && request >= 0) {
+                  nThreads = (UInt_t)request;
+                  ++a;
+                  ++ffirst;
+               } else {
+                  std::cerr << "Error: could not parse the number of threads to use passed after -jt: " << argv[a + 1]
+                            << ". We will use the default value (number of logical cores).\n";
+               }
+            }
+         }
+         multithread = kTRUE;
+         ++ffirst;
       } else if ( strcmp(argv[a],"-cachesize=") == 0 ) {
          int size;
          static const size_t arglen = strlen("-cachesize=");
@@ -380,6 +414,17 @@ int main( int argc, char **argv )
    if (maxopenedfiles > 0) {
       fileMerger.SetMaxOpenedFiles(maxopenedfiles);
    }
+   if (multithread) {
+      if (multiproc) {
+         std::cerr << "Error: -j and -jt cannot be used together. Merging with threads.\n";
+         multiproc = kFALSE;
+      }
+      ROOT::EnableImplicitMT(nThreads);
+      fileMerger.SetParallelMerge(kTRUE);
+      if (verbosity > 1) {
+         std::cout << "hadd merging with " << ROOT::GetThreadPoolSize() << " threads" << std::endl;
+      }
+   }
    if (newcomp == -1) {
       if (useFirstInputCompression || keepCompressionAsIs) {
          // grab from the first file.
@@ -215,6 +215,9 @@ public:
    ///Apply Weight correction for error matrix computation
    bool UseWeightCorrection() const { return fWeightCorr; }
 
+   ///Use the gradient of the model function only when it is analytic
+   bool UseAnalyticGradient() const { return fAnalyticGrad; }
+
 
    /// return vector of parameter indeces for which the Minos Error will be computed
    const std::vector<unsigned int> & MinosParams() const { return fMinosParams; }
@@ -233,6 +236,11 @@ public:
    ///apply the weight correction for error matric computation
    void SetWeightCorrection(bool on = true) { fWeightCorr = on; }
 
+   /// use the gradient with respect to the parameters of the model function when it is computed analytically
+   /// (see IParamMultiGradFunction::HasParameterGradient), otherwise let the minimizer compute numerically
+   /// the gradient of the objective function
+   void SetAnalyticGradient(bool on = true) { fAnalyticGrad = on; }
+
    /// set parameter indeces for running Minos
    /// this can be used for running Minos on a subset of parameters - otherwise is run on all of them
    /// if MinosErrors() is set
@@ -263,6 +271,7 @@ private:
    bool fMinosErrors;      // do full error analysis using Minos
    bool fUpdateAfterFit;   // update the configuration after a fit using the result
    bool fWeightCorr;       // apply correction to errors for weights fits
+   bool fAnalyticGrad;     // use the model gradient only when analytic, the minimizer gradient otherwise
 
    std::vector<ROOT::Fit::ParameterSettings> fSettings;  // vector with the parameter settings
    std::vector<unsigned int> fMinosParams;               // vector with the parameter indeces for running Minos
@@ -468,6 +468,8 @@ protected:
    /// linear least square fit
    bool DoLinearFit();
 
+   // choose between the model gradient and the minimizer gradient when an analytic gradient is requested
+   void DoCheckAnalyticGradient();
    // initialize the minimizer
    bool DoInitMinimizer();
    /// do minimization
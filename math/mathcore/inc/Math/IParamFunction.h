@@ -127,6 +127,16 @@ namespace ROOT {
             return DoEval(x);
          }
 
+         /**
+            Evaluate the function at n points for the given parameters p, storing the results in out.
+            The coordinates of point i start at x[i * stride].
+            Use the virtual function DoEvalParBatch to implement it
+         */
+         void EvalParBatch(const T *x, size_t n, size_t stride, const double *p, T *out) const
+         {
+            DoEvalParBatch(x, n, stride, p, out);
+         }
+
       private:
          /**
             Implementation of the evaluation function using the x values and the parameters.
@@ -134,6 +144,16 @@ namespace ROOT {
          */
          virtual T DoEvalPar(const T *x, const double *p) const = 0;
 
+         /**
+            Evaluate the function at n points. The default implementation calls DoEvalPar for each point,
+            derived classes can re-implement it when they can evaluate many points at once
+         */
+         virtual void DoEvalParBatch(const T *x, size_t n, size_t stride, const double *p, T *out) const
+         {
+            for (size_t i = 0; i < n; ++i)
+               out[i] = DoEvalPar(x + i * stride, p);
+         }
+
          /**
             Implement the ROOT::Math::IBaseFunctionMultiDim interface DoEval(x) using the cached parameter values
          */
@@ -278,6 +298,13 @@ namespace ROOT {
             return DoParameterDerivative(x, Parameters() , ipar);
          }
 
+         /**
+            Return true if the derivatives with respect to the parameters are computed analytically.
+            Derived classes approximating them with finite differences should return false, so that
+            a fitter can let the minimizer compute the gradient of the objective function instead
+         */
+         virtual bool HasParameterGradient() const { return true; }
+
       private:
 
          /**
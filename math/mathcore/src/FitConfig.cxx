@@ -43,6 +43,7 @@ FitConfig::FitConfig(unsigned int npar) :
    fMinosErrors(false),    // do full Minos error analysis for all parameters
    fUpdateAfterFit(true),    // update after fit
    fWeightCorr(false),
+   fAnalyticGrad(false),
    fSettings(std::vector<ParameterSettings>(npar) )
 {
    // constructor implementation
@@ -68,6 +69,7 @@ FitConfig & FitConfig::operator = (const FitConfig &rhs) {
    fMinosErrors = rhs.fMinosErrors;
    fUpdateAfterFit = rhs.fUpdateAfterFit;
    fWeightCorr     = rhs.fWeightCorr;
+   fAnalyticGrad   = rhs.fAnalyticGrad;
 
    fSettings = rhs.fSettings;
    fMinosParams = rhs.fMinosParams;
@@ -213,7 +213,25 @@ namespace ROOT {
             }
          }
 
-
+         // number of points for which the model function is evaluated at once
+         const unsigned int kEvalBatchSize = 256;
+
+         // sum pointFunction(i, fval) over the block iblock of kEvalBatchSize points of one-dimensional data,
+         // evaluating the model function on all the points of the block with a single call
+         template <class PointFunc>
+         double EvaluateBatch(const IModelFunction &func, const BinData &data, const double *p, unsigned int iblock,
+                              const PointFunc &pointFunction)
+         {
+            const unsigned int begin = iblock * kEvalBatchSize;
+            const unsigned int end = std::min(data.Size(), begin + kEvalBatchSize);
+            double fval[kEvalBatchSize];
+            // the coordinates of one-dimensional data are contiguous
+            func.EvalParBatch(data.GetCoordComponent(begin, 0), end - begin, 1, p, fval);
+            double sum{};
+            for (unsigned int i = begin; i < end; ++i)
+               sum += pointFunction(i, &fval[i - begin]);
+            return sum;
+         }
 
       } // end namespace  FitUtil
 
@@ -275,7 +293,12 @@ namespace ROOT {
 
    (const_cast<IModelFunction &>(func)).SetParameters(p);
 
-   auto mapFunction = [&](const unsigned i){
+   // evaluate the function on blocks of points when it is evaluated at the bin centers of one-dimensional data
+   const bool useBatch = !useBinIntegral && !useBinVolume && data.NDim() == 1 && n > 0;
+   const unsigned int nBlocks = (n + kEvalBatchSize - 1) / kEvalBatchSize;
+
+   // chi2 term of point i, fvalBatch is the function value if already evaluated
+   auto pointFunction = [&](const unsigned i, const double *fvalBatch){
 
       double chi2{};
       double fval{};
@@ -313,7 +336,10 @@ namespace ROOT {
       }
 
 
-      if (!useBinIntegral) {
+      if (fvalBatch) {
+         fval = *fvalBatch;
+      }
+      else if (!useBinIntegral) {
 #ifdef USE_PARAMCACHE
          fval = func ( x );
 #else
@@ -376,6 +402,9 @@ namespace ROOT {
       return chi2;
   };
 
+  auto mapFunction = [&](const unsigned i) { return pointFunction(i, nullptr); };
+  auto mapBlock = [&](const unsigned iblock) { return EvaluateBatch(func, data, p, iblock, pointFunction); };
+
 #ifdef R__USE_IMT
   auto redFunction = [](const std::vector<double> & objs){
                           return std::accumulate(objs.begin(), objs.end(), double{});
@@ -393,14 +422,22 @@ namespace ROOT {
 
   double res{};
   if(executionPolicy == ROOT::EExecutionPolicy::kSequential){
-    for (unsigned int i=0; i<n; ++i) {
-      res += mapFunction(i);
+    if (useBatch) {
+      for (unsigned int iblock = 0; iblock < nBlocks; ++iblock)
+        res += mapBlock(iblock);
+    } else {
+      for (unsigned int i=0; i<n; ++i) {
+        res += mapFunction(i);
+      }
     }
 #ifdef R__USE_IMT
   } else if(executionPolicy == ROOT::EExecutionPolicy::kMultiThread) {
     ROOT::TThreadExecutor pool;
     auto chunks = nChunks !=0? nChunks: setAutomaticChunking(data.Size());
-    res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+    if (useBatch)
+      res = pool.MapReduce(mapBlock, ROOT::TSeq<unsigned>(0, nBlocks), redFunction, std::min(chunks, nBlocks));
+    else
+      res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
 #endif
 //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
     // ROOT::TProcessExecutor pool;
@@ -970,35 +1007,17 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double> &func, const UnBi
             }
          }
 
-         // needed to compue effective global weight in case of extended likelihood
+         const double invNorm = 1.0 / norm;
+         const unsigned int ndim = data.NDim();
 
-         auto mapFunction = [&](const unsigned i) {
+         // needed to compue effective global weight in case of extended likelihood
+         // log-likelihood term of event i, fval is the (not normalized) function value at the event
+         auto pointFunction = [&](const unsigned i, double fval) {
             double W = 0;
             double W2 = 0;
-            double fval = 0;
-
-            if (data.NDim() > 1) {
-               std::vector<double> x(data.NDim());
-               for (unsigned int j = 0; j < data.NDim(); ++j)
-                  x[j] = *data.GetCoordComponent(i, j);
-#ifdef USE_PARAMCACHE
-               fval = func(x.data());
-#else
-               fval = func(x.data(), p);
-#endif
-
-               // one -dim case
-            } else {
-               const auto x = data.GetCoordComponent(i, 0);
-#ifdef USE_PARAMCACHE
-               fval = func(x);
-#else
-               fval = func(x, p);
-#endif
-            }
 
             if (normalizeFunc)
-               fval = fval * (1 / norm);
+               fval *= invNorm;
 
             // function EvalLog protects against negative or too small values of fval
             double logval = ROOT::Math::Util::EvalLog(fval);
@@ -1017,22 +1036,38 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double> &func, const UnBi
             return LikelihoodAux<double>(logval, W, W2);
          };
 
-#ifdef R__USE_IMT
-  // auto redFunction = [](const std::vector<LikelihoodAux<double>> & objs){
-  //          return std::accumulate(objs.begin(), objs.end(), LikelihoodAux<double>(0.0,0.0,0.0),
-  //                      [](const LikelihoodAux<double> &l1, const LikelihoodAux<double> &l2){
-  //                          return l1+l2;
-  //                 });
-  // };
-  // do not use std::accumulate to be sure to maintain always the same order
-  auto redFunction = [](const std::vector<LikelihoodAux<double>> & objs){
-     auto l0 =  LikelihoodAux<double>(0.0,0.0,0.0);
-     for ( auto & l : objs ) {
-        l0 = l0 + l;
-     }
-     return l0;
-  };
-#else
+         // the events are processed in blocks of kEvalBatchSize: the function is evaluated on all the events
+         // of a block with a single call and the terms of the block are summed with a Kahan summation.
+         // The blocks do not depend on the execution policy, so the result does not depend on the number of threads
+         const unsigned int nBlocks = (n + kEvalBatchSize - 1) / kEvalBatchSize;
+         auto mapBlock = [&](const unsigned iblock) {
+            const unsigned int begin = iblock * kEvalBatchSize;
+            const unsigned int nEvents = std::min(n, begin + kEvalBatchSize) - begin;
+            double fval[kEvalBatchSize];
+            if (ndim == 1) {
+               // the coordinates of one-dimensional data are contiguous
+               func.EvalParBatch(data.GetCoordComponent(begin, 0), nEvents, 1, p, fval);
+            } else {
+               // the coordinates are stored by component, copy them event by event
+               std::vector<double> x(nEvents * ndim);
+               for (unsigned int j = 0; j < ndim; ++j) {
+                  const double *xj = data.GetCoordComponent(begin, j);
+                  for (unsigned int i = 0; i < nEvents; ++i)
+                     x[i * ndim + j] = xj[i];
+               }
+               func.EvalParBatch(x.data(), nEvents, ndim, p, fval);
+            }
+            ROOT::Math::KahanSum<double> logval, weight, weight2;
+            for (unsigned int i = 0; i < nEvents; ++i) {
+               auto res = pointFunction(begin + i, fval[i]);
+               logval.Add(res.logvalue);
+               weight.Add(res.weight);
+               weight2.Add(res.weight2);
+            }
+            return LikelihoodAux<double>(logval, weight, weight2);
+         };
+
+#ifndef R__USE_IMT
   (void)nChunks;
 
   // If IMT is disabled, force the execution policy to the serial case
@@ -1043,24 +1078,16 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double> &func, const UnBi
   }
 #endif
 
-  double logl{};
-  double sumW{};
-  double sumW2{};
+  std::vector<LikelihoodAux<double>> blockResults(nBlocks);
   if(executionPolicy == ROOT::EExecutionPolicy::kSequential){
-    for (unsigned int i=0; i<n; ++i) {
-      auto resArray = mapFunction(i);
-      logl+=resArray.logvalue;
-      sumW+=resArray.weight;
-      sumW2+=resArray.weight2;
-    }
+    for (unsigned int iblock = 0; iblock < nBlocks; ++iblock)
+      blockResults[iblock] = mapBlock(iblock);
 #ifdef R__USE_IMT
   } else if(executionPolicy == ROOT::EExecutionPolicy::kMultiThread) {
     ROOT::TThreadExecutor pool;
     auto chunks = nChunks !=0? nChunks: setAutomaticChunking(data.Size());
-    auto resArray = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
-    logl=resArray.logvalue;
-    sumW=resArray.weight;
-    sumW2=resArray.weight2;
+    pool.Foreach([&](const unsigned iblock) { blockResults[iblock] = mapBlock(iblock); },
+                 ROOT::TSeq<unsigned>(0, nBlocks), std::min(chunks, nBlocks));
 #endif
 //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
     // ROOT::TProcessExecutor pool;
@@ -1069,6 +1096,17 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double> &func, const UnBi
     Error("FitUtil::EvaluateLogL","Execution policy unknown. Avalaible choices:\n ROOT::EExecutionPolicy::kSequential (default)\n ROOT::EExecutionPolicy::kMultiThread (requires IMT)\n");
   }
 
+  // sum the block results always in the same order
+  ROOT::Math::KahanSum<double> sumLogL, sumWeight, sumWeight2;
+  for (auto &res : blockResults) {
+     sumLogL.Add(res.logvalue);
+     sumWeight.Add(res.weight);
+     sumWeight2.Add(res.weight2);
+  }
+  double logl = sumLogL;
+  double sumW = sumWeight;
+  double sumW2 = sumWeight2;
+
   if (extended) {
       // add Poisson extended term
       double extendedTerm = 0; // extended term in likelihood
@@ -1431,7 +1469,12 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
    IntegralEvaluator<> igEval(func, p, useBinIntegral, igType);
 #endif
 
-   auto mapFunction = [&](const unsigned i) {
+   // evaluate the function on blocks of points when it is evaluated at the bin centers of one-dimensional data
+   const bool useBatch = !useBinIntegral && !useBinVolume && data.NDim() == 1 && n > 0;
+   const unsigned int nBlocks = (n + kEvalBatchSize - 1) / kEvalBatchSize;
+
+   // likelihood term of point i, fvalBatch is the function value if already evaluated
+   auto pointFunction = [&](const unsigned i, const double *fvalBatch) {
       auto x1 = data.GetCoordComponent(i, 0);
       auto y = *data.ValuePtr(i);
 
@@ -1463,7 +1506,9 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
          x = x1;
       }
 
-      if (!useBinIntegral) {
+      if (fvalBatch) {
+         fval = *fvalBatch;
+      } else if (!useBinIntegral) {
 #ifdef USE_PARAMCACHE
          fval = func(x);
 #else
@@ -1543,6 +1588,9 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
       return nloglike;
    };
 
+   auto mapFunction = [&](const unsigned i) { return pointFunction(i, nullptr); };
+   auto mapBlock = [&](const unsigned iblock) { return EvaluateBatch(func, data, p, iblock, pointFunction); };
+
 #ifdef R__USE_IMT
    auto redFunction = [](const std::vector<double> &objs) {
       return std::accumulate(objs.begin(), objs.end(), double{});
@@ -1560,14 +1608,22 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
 
    double res{};
    if (executionPolicy == ROOT::EExecutionPolicy::kSequential) {
-      for (unsigned int i = 0; i < n; ++i) {
-         res += mapFunction(i);
+      if (useBatch) {
+         for (unsigned int iblock = 0; iblock < nBlocks; ++iblock)
+            res += mapBlock(iblock);
+      } else {
+         for (unsigned int i = 0; i < n; ++i) {
+            res += mapFunction(i);
+         }
       }
 #ifdef R__USE_IMT
    } else if (executionPolicy == ROOT::EExecutionPolicy::kMultiThread) {
       ROOT::TThreadExecutor pool;
       auto chunks = nChunks != 0 ? nChunks : setAutomaticChunking(data.Size());
-      res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+      if (useBatch)
+         res = pool.MapReduce(mapBlock, ROOT::TSeq<unsigned>(0, nBlocks), redFunction, std::min(chunks, nBlocks));
+      else
+         res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
 #endif
       //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
       // ROOT::TProcessExecutor pool;
@@ -383,6 +383,7 @@ bool Fitter::DoLeastSquareFit(const ROOT::EExecutionPolicy &executionPolicy)
 
       fBinFit = true;
       fDataSize = data->Size();
+      DoCheckAnalyticGradient();
       // check if fFunc provides gradient
       if (!fUseGradient) {
          // do minimzation without using the gradient
@@ -449,6 +450,7 @@ bool Fitter::DoBinnedLikelihoodFit(bool extended, const ROOT::EExecutionPolicy &
 
    fBinFit = true;
    fDataSize = data->Size();
+   DoCheckAnalyticGradient();
 
    if (!fUseGradient) {
       // do minimization without using the gradient
@@ -562,6 +564,8 @@ bool Fitter::DoUnbinnedLikelihoodFit(bool extended, const ROOT::EExecutionPolicy
       fConfig.MinimizerOptions().SetErrorDef(0.5);
    }
 
+   DoCheckAnalyticGradient();
+
    if (!fUseGradient) {
       // do minimization without using the gradient
      if (fFunc_v ){
@@ -824,6 +828,20 @@ struct ObjFuncTrait<ROOT::Math::FitMethodGradFunction> {
    static bool IsGrad() { return true; }
 };
 
+void Fitter::DoCheckAnalyticGradient() {
+   // when the configuration requests an analytic gradient, use the gradient of the model function only if
+   // its derivatives with respect to the parameters are analytic: otherwise the minimizer computes the
+   // gradient of the objective function numerically, which is cheaper than from numerical derivatives at each point
+   if (!fConfig.UseAnalyticGradient() || !fFunc)
+      return;
+   std::shared_ptr<IGradModelFunction> gradFunc = std::dynamic_pointer_cast<IGradModelFunction>(fFunc);
+   bool useGradient = gradFunc && gradFunc->HasParameterGradient();
+   if (!useGradient && fConfig.MinimizerOptions().PrintLevel() > 0)
+      MATH_INFO_MSG("Fitter::DoCheckAnalyticGradient",
+                    "model function has no analytic gradient - use the gradient computed by the minimizer");
+   fUseGradient = useGradient;
+}
+
 bool Fitter::DoInitMinimizer() {
    //initialize minimizer by creating it
    // and set there the objective function
@@ -4,6 +4,7 @@
 #include "Fit/BinData.h"
 #include "Fit/UnBinData.h"
 #include "Fit/Fitter.h"
+#include "Fit/FitUtil.h"
 #include "HFitInterface.h"
 #include "TH2.h"
 #include "TF2.h"
@@ -287,6 +288,41 @@ REGISTER_TYPED_TEST_SUITE_P(GradientFittingTest,Sequential,Multithread);
 
 INSTANTIATE_TYPED_TEST_SUITE_P(GradientFitting, GradientFittingTest, TestTypes);
 
+// Test that the log-likelihood does not depend on the execution policy and on the number of chunks
+TEST(FitUtil, LogLDeterministic)
+{
+   const double p[5] = {1., 0.5, 0.3, 0.2, 0.1};
+   GradFunc2D<double> func;
+   func.SetParameters(p);
+
+   // use a number of events which is not a multiple of the block size
+   const unsigned int nEvents = 100003;
+   ROOT::Fit::UnBinData data(nEvents, 2, true);
+   TRandom rndm(111);
+   for (unsigned int i = 0; i < nEvents; ++i) {
+      double x[2] = {rndm.Uniform(), rndm.Uniform()};
+      data.Add(x, rndm.Uniform(0.5, 1.5));
+   }
+
+   double expected = 0;
+   for (unsigned int i = 0; i < nEvents; ++i) {
+      double x[2] = {*data.GetCoordComponent(i, 0), *data.GetCoordComponent(i, 1)};
+      expected -= std::log(func(x, p)) * data.Weight(i);
+   }
+
+   unsigned int nPoints = 0;
+   double seq = ROOT::Fit::FitUtil::EvaluateLogL(func, data, p, 1, false, nPoints, ROOT::EExecutionPolicy::kSequential);
+   EXPECT_EQ(nEvents, nPoints);
+   EXPECT_NEAR(expected, seq, 1e-10 * std::abs(expected));
+#ifdef R__USE_IMT
+   for (unsigned int nChunks : {0u, 1u, 7u, 64u}) {
+      double mt =
+         ROOT::Fit::FitUtil::EvaluateLogL(func, data, p, 1, false, nPoints, ROOT::EExecutionPolicy::kMultiThread, nChunks);
+      EXPECT_EQ(seq, mt) << "with " << nChunks << " chunks";
+   }
+#endif
+}
+
 int main(int argc, char** argv) {
 
    // Disables elapsed time by default.
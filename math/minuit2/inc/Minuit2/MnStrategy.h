@@ -48,6 +48,8 @@ public:
 
    int StorageLevel() const { return fStoreLevel; }
 
+   bool ParallelDerivatives() const { return fParallelDerivatives; }
+
    bool IsLow() const { return fStrategy == 0; }
    bool IsMedium() const { return fStrategy == 1; }
    bool IsHigh() const { return fStrategy >= 2; }
@@ -69,6 +71,10 @@ public:
    // 0 = store only last iterations 1 = full storage (default)
    void SetStorageLevel(unsigned int level) { fStoreLevel = level; }
 
+   // compute the numerical derivatives of the different parameters in parallel, using the ROOT thread pool
+   // (only available in ROOT builds with IMT); the FCN must then be thread safe
+   void SetParallelDerivatives(bool on = true) { fParallelDerivatives = on; }
+
 private:
    unsigned int fStrategy;
 
@@ -80,6 +86,7 @@ private:
    double fHessTlrG2;
    unsigned int fHessGradNCyc;
    int fStoreLevel;
+   bool fParallelDerivatives;
 };
 
 } // namespace Minuit2
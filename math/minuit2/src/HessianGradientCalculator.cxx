@@ -18,6 +18,13 @@
 #include "Minuit2/MnPrint.h"
 #include "Minuit2/MPIProcess.h"
 
+#ifdef USE_ROOT_ERROR
+#include "RConfigure.h" // for R__USE_IMT
+#endif
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
 #include <cmath>
 #include <cassert>
 
@@ -90,12 +97,8 @@ HessianGradientCalculator::DeltaGradient(const MinimumParameters &par, const Fun
    unsigned int n = x.size();
    MnAlgebraicVector dgrd(n);
 
-   MPIProcess mpiproc(n, 0);
-   // initial starting values
-   unsigned int startElementIndex = mpiproc.StartElementIndex();
-   unsigned int endElementIndex = mpiproc.EndElementIndex();
-
-   for (unsigned int i = startElementIndex; i < endElementIndex; i++) {
+   // compute the derivative with respect to parameter i; x is the point, restored at the end
+   auto computeDerivative = [&](unsigned int i, MnAlgebraicVector &x, MnPrint &print) {
       double xtf = x(i);
       double dmin = 4. * Precision().Eps2() * (xtf + Precision().Eps2());
       double epspri = Precision().Eps2() + fabs(grd(i) * Precision().Eps2());
@@ -144,7 +147,31 @@ HessianGradientCalculator::DeltaGradient(const MinimumParameters &par, const Fun
       dgrd(i) = std::max(dgmin, std::fabs(grdold - grdnew));
 
       print.Debug("HGC Param :", i, "\t new g1 =", grd(i), "gstep =", d, "dgrd =", dgrd(i));
+   };
+
+#ifdef R__USE_IMT
+   if (Strategy().ParallelDerivatives() && n > 1) {
+      // the parameters are independent: compute their derivatives in parallel, each task using its own point
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(
+         [&](unsigned int i) {
+            // must create thread-local MnPrint instances when printing inside threads
+            MnPrint printTask("HessianGradientCalculator[IMT]");
+            MnAlgebraicVector xTask = par.Vec();
+            computeDerivative(i, xTask, printTask);
+         },
+         ROOT::TSeqU(n));
+      return std::pair<FunctionGradient, MnAlgebraicVector>(FunctionGradient(grd, g2, gstep), dgrd);
    }
+#endif
+
+   MPIProcess mpiproc(n, 0);
+   // initial starting values
+   unsigned int startElementIndex = mpiproc.StartElementIndex();
+   unsigned int endElementIndex = mpiproc.EndElementIndex();
+
+   for (unsigned int i = startElementIndex; i < endElementIndex; i++)
+      computeDerivative(i, x, print);
 
    mpiproc.SyncVector(grd);
    mpiproc.SyncVector(gstep);
@@ -82,6 +82,17 @@ int ControlPrintLevel()
 void RestoreGlobalPrintLevel(int) {}
 #endif
 
+// compute the numerical derivatives in parallel if the extra option "ParallelDerivatives"
+// is set (requires a thread safe FCN); used for both the minimization and Hesse
+static void SetParallelDerivativesOption(MnStrategy &strategy)
+{
+   int parallelDerivatives = 0;
+   ROOT::Math::IOptions *minuit2Opt = ROOT::Math::MinimizerOptions::FindDefault("Minuit2");
+   if (minuit2Opt)
+      minuit2Opt->GetValue("ParallelDerivatives", parallelDerivatives);
+   strategy.SetParallelDerivatives(parallelDerivatives != 0);
+}
+
 Minuit2Minimizer::Minuit2Minimizer(ROOT::Minuit2::EMinimizerType type)
    : Minimizer(), fDim(0), fMinimizer(0), fMinuitFCN(0), fMinimum(0)
 {
@@ -504,6 +515,7 @@ bool Minuit2Minimizer::Minimize()
          minuit2Opt->Print();
       }
    }
+   SetParallelDerivativesOption(strategy);
 
    // set a minimizer tracer object (default for printlevel=10, from gROOT for printLevel=11)
    // use some special print levels
@@ -1195,7 +1207,8 @@ bool Minuit2Minimizer::Hesse()
       return false;
    }
 
-   const int strategy = Strategy();
+   ROOT::Minuit2::MnStrategy strategy(Strategy());
+   SetParallelDerivativesOption(strategy);
    const int maxfcn = MaxFunctionCalls();
    print.Info("Using max-calls", maxfcn);
 
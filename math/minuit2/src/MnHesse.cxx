@@ -21,6 +21,13 @@
 #include "Minuit2/MnPrint.h"
 #include "Minuit2/MPIProcess.h"
 
+#ifdef USE_ROOT_ERROR
+#include "RConfigure.h" // for R__USE_IMT
+#endif
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
 namespace ROOT {
 
 namespace Minuit2 {
@@ -130,8 +137,9 @@ operator()(const MnFcn &mfcn, const MinimumState &st, const MnUserTransformation
    print.Debug("Gradient is", st.Gradient().IsAnalytical() ? "analytical" : "numerical", "\n  point:", x,
                "\n  fcn  :", amin, "\n  grad :", grd, "\n  step :", gst, "\n  g2   :", g2);
 
-   for (unsigned int i = 0; i < n; i++) {
-
+   // compute the second derivative with respect to parameter i; x is the point, restored at the end.
+   // Returns false if the second derivative is zero
+   auto computeDiagonal = [&](unsigned int i, MnAlgebraicVector &x, MnPrint &print) {
       double xtf = x(i);
       double dmin = 8. * prec.Eps2() * (std::fabs(xtf) + prec.Eps2());
       double d = std::fabs(gst(i));
@@ -159,7 +167,7 @@ operator()(const MnFcn &mfcn, const MinimumState &st, const MnUserTransformation
                goto L30; // break
             if (trafo.Parameter(i).HasLimits()) {
                if (d > 0.5)
-                  goto L26;
+                  return false;
                d *= 10.;
                if (d > 0.5)
                   d = 0.51;
@@ -167,20 +175,7 @@ operator()(const MnFcn &mfcn, const MinimumState &st, const MnUserTransformation
             }
             d *= 10.;
          }
-
-      L26:
-         // get parameter name for i
-         // (need separate scope for avoiding compl error when declaring name)
-         print.Warn("2nd derivative zero for parameter", trafo.Name(trafo.ExtOfInt(i)),
-                    "; MnHesse fails and will return diagonal matrix");
-
-         for (unsigned int j = 0; j < n; j++) {
-            double tmp = g2(j) < prec.Eps2() ? 1. : 1. / g2(j);
-            vhmat(j, j) = tmp < prec.Eps2() ? 1. : tmp;
-         }
-
-         return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(),
-                             st.Edm(), mfcn.NumOfCalls());
+         return false;
 
       L30:
          double g2bfor = g2(i);
@@ -208,19 +203,58 @@ operator()(const MnFcn &mfcn, const MinimumState &st, const MnUserTransformation
          d = std::max(d, 0.1 * dlast);
       }
       vhmat(i, i) = g2(i);
-      if (mfcn.NumOfCalls() > maxcalls) {
-
-         // std::cout<<"maxcalls " << maxcalls << " " << mfcn.NumOfCalls() << "  " <<   st.NFcn() << std::endl;
-         print.Warn("Maximum number of allowed function calls exhausted; will return diagonal matrix");
+      return true;
+   };
 
-         for (unsigned int j = 0; j < n; j++) {
-            double tmp = g2(j) < prec.Eps2() ? 1. : 1. / g2(j);
-            vhmat(j, j) = tmp < prec.Eps2() ? 1. : tmp;
-         }
+   // state returned when the diagonal elements cannot be computed
+   auto diagonalFailure = [&]() {
+      for (unsigned int j = 0; j < n; j++) {
+         double tmp = g2(j) < prec.Eps2() ? 1. : 1. / g2(j);
+         vhmat(j, j) = tmp < prec.Eps2() ? 1. : tmp;
+      }
 
-         return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(),
-                             st.Edm(), mfcn.NumOfCalls());
+      return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(),
+                          st.Edm(), mfcn.NumOfCalls());
+   };
+   auto zeroDerivativeFailure = [&](unsigned int i) {
+      // get parameter name for i
+      print.Warn("2nd derivative zero for parameter", trafo.Name(trafo.ExtOfInt(i)),
+                 "; MnHesse fails and will return diagonal matrix");
+      return diagonalFailure();
+   };
+   auto maxCallsFailure = [&]() {
+      // std::cout<<"maxcalls " << maxcalls << " " << mfcn.NumOfCalls() << "  " <<   st.NFcn() << std::endl;
+      print.Warn("Maximum number of allowed function calls exhausted; will return diagonal matrix");
+      return diagonalFailure();
+   };
+
+#ifdef R__USE_IMT
+   // the parameters are independent: compute the elements in parallel, each task using its own point
+   const bool parallel = fStrategy.ParallelDerivatives() && n > 1;
+   if (parallel) {
+      std::vector<char> valid(n);
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(
+         [&](unsigned int i) {
+            // must create thread-local MnPrint instances when printing inside threads
+            MnPrint printTask("MnHesse[IMT]");
+            MnAlgebraicVector xTask = x;
+            valid[i] = computeDiagonal(i, xTask, printTask);
+         },
+         ROOT::TSeqU(n));
+      for (unsigned int i = 0; i < n; i++) {
+         if (!valid[i])
+            return zeroDerivativeFailure(i);
       }
+      if (mfcn.NumOfCalls() > maxcalls)
+         return maxCallsFailure();
+   } else
+#endif
+   for (unsigned int i = 0; i < n; i++) {
+      if (!computeDiagonal(i, x, print))
+         return zeroDerivativeFailure(i);
+      if (mfcn.NumOfCalls() > maxcalls)
+         return maxCallsFailure();
    }
 
    print.Debug("Second derivatives", g2);
@@ -235,6 +269,24 @@ operator()(const MnFcn &mfcn, const MinimumState &st, const MnUserTransformation
    }
 
    // off-diagonal Elements
+#ifdef R__USE_IMT
+   if (parallel) {
+      // compute the rows in parallel
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(
+         [&](unsigned int i) {
+            MnAlgebraicVector xTask = x;
+            xTask(i) += dirin(i);
+            for (unsigned int j = i + 1; j < n; j++) {
+               xTask(j) += dirin(j);
+               double fs1 = mfcn(xTask);
+               vhmat(i, j) = (fs1 + amin - yy(i) - yy(j)) / (dirin(i) * dirin(j));
+               xTask(j) -= dirin(j);
+            }
+         },
+         ROOT::TSeqU(n - 1));
+   } else
+#endif
    // initial starting values
    if (n > 0) {
       MPIProcess mpiprocOffDiagonal(n * (n - 1) / 2, 0);
@@ -0,0 +1,86 @@
+// @(#)root/minuit2:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2005 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+// Test that the numerical derivatives computed in parallel
+// (MnStrategy::SetParallelDerivatives) agree with the sequential ones.
+
+#include "Minuit2/FCNBase.h"
+#include "Minuit2/FunctionMinimum.h"
+#include "Minuit2/MnHesse.h"
+#include "Minuit2/MnMigrad.h"
+#include "Minuit2/MnStrategy.h"
+#include "Minuit2/MnUserParameterState.h"
+#include "Minuit2/MnUserParameters.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace ROOT::Minuit2;
+
+namespace {
+
+// Correlated function of 6 parameters, thread safe as it has no state.
+class CorrelatedFcn : public FCNBase {
+public:
+   double operator()(const std::vector<double> &x) const override
+   {
+      double f = 0;
+      for (unsigned int i = 0; i < x.size(); ++i) {
+         const double d = x[i] - 0.5 * i;
+         f += (i + 1) * d * d + 0.1 * d * d * d * d;
+         if (i > 0)
+            f += 0.3 * d * (x[i - 1] - 0.5 * (i - 1));
+      }
+      return f;
+   }
+   double Up() const override { return 1.; }
+};
+
+FunctionMinimum MinimizeWith(bool parallel)
+{
+   MnUserParameters upar;
+   for (int i = 0; i < 6; ++i)
+      upar.Add("x" + std::to_string(i), 2. - i, 0.1);
+   MnStrategy strategy(1);
+   strategy.SetParallelDerivatives(parallel);
+   MnMigrad migrad(CorrelatedFcn(), MnUserParameterState(upar), strategy);
+   return migrad();
+}
+
+} // namespace
+
+TEST(Minuit2, ParallelDerivatives)
+{
+   const FunctionMinimum seq = MinimizeWith(false);
+   const FunctionMinimum par = MinimizeWith(true);
+   ASSERT_TRUE(seq.IsValid());
+   ASSERT_TRUE(par.IsValid());
+
+   // gradient at the minimum
+   const MnAlgebraicVector &gseq = seq.State().Gradient().Vec();
+   const MnAlgebraicVector &gpar = par.State().Gradient().Vec();
+   ASSERT_EQ(gseq.size(), gpar.size());
+   for (unsigned int i = 0; i < gseq.size(); ++i)
+      EXPECT_NEAR(gseq(i), gpar(i), 1e-8) << "parameter " << i;
+
+   // covariance from Hesse
+   MnStrategy seqStrategy(1);
+   MnStrategy parStrategy(1);
+   parStrategy.SetParallelDerivatives(true);
+   const MnUserParameterState hseq = MnHesse(seqStrategy)(CorrelatedFcn(), seq.UserState());
+   const MnUserParameterState hpar = MnHesse(parStrategy)(CorrelatedFcn(), seq.UserState());
+   ASSERT_TRUE(hseq.HasCovariance());
+   ASSERT_TRUE(hpar.HasCovariance());
+   for (unsigned int i = 0; i < 6; ++i) {
+      for (unsigned int j = 0; j <= i; ++j)
+         EXPECT_NEAR(hseq.Covariance()(i, j), hpar.Covariance()(i, j), 1e-8 * std::abs(hseq.Covariance()(i, i)))
+            << "element " << i << "," << j;
+   }
+}
@@ -161,6 +161,8 @@ protected:
 
    virtual Bool_t ProduceJson(const std::string &path, const std::string &options, std::string &res);
 
+   virtual Bool_t ProduceBinaryJson(const std::string &path, const std::string &options, std::string &res);
+
    virtual Bool_t ProduceXml(const std::string &path, const std::string &options, std::string &res);
 
    virtual Bool_t ProduceBinary(const std::string &path, const std::string &options, std::string &res);
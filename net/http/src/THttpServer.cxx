@@ -1205,6 +1205,7 @@ const char *THttpServer::GetMimeType(const char *path)
    } builtin_mime_types[] = {{".xml", 4, "text/xml"},
                              {".json", 5, "application/json"},
                              {".bin", 4, "application/x-binary"},
+                             {".jbin", 5, "application/x-binary"},
                              {".gif", 4, "image/gif"},
                              {".jpg", 4, "image/jpeg"},
                              {".png", 4, "image/png"},
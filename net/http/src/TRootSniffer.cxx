@@ -963,6 +963,7 @@ TFolder *TRootSniffer::GetTopFolder(Bool_t force)
 void TRootSniffer::ScanRoot(TRootSnifferScanRec &rec)
 {
    rec.SetField(item_prop_kind, "ROOT.Session");
+   rec.SetField("_jbin", "true", kFALSE); // root.jbin requests are supported
    if (fCurrentArg && fCurrentArg->GetUserName())
       rec.SetField(item_prop_user, fCurrentArg->GetUserName());
 
@@ -1155,6 +1156,38 @@ Bool_t TRootSniffer::ProduceJson(const std::string &path, const std::string &opt
    return !res.empty();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Produce binary JSON data for specified item
+/// Object structure is stored as JSON while arrays are stored as raw binary blocks,
+/// see TBufferJSON::ConvertToBinaryJSON() for the format
+
+Bool_t TRootSniffer::ProduceBinaryJson(const std::string &path, const std::string &options, std::string &res)
+{
+   if (path.empty())
+      return kFALSE;
+
+   const char *path_ = path.c_str();
+   if (*path_ == '/')
+      path_++;
+
+   TUrl url;
+   url.SetOptions(options.c_str());
+   url.ParseOptions();
+   Int_t compact = -1;
+   if (url.GetValueFromOptions("compact"))
+      compact = url.GetIntValueFromOptions("compact");
+
+   TClass *obj_cl = nullptr;
+   TDataMember *member = nullptr;
+   void *obj_ptr = FindInHierarchy(path_, &obj_cl, &member);
+   if (!obj_ptr || !obj_cl)
+      return kFALSE;
+
+   res = TBufferJSON::ConvertToBinaryJSON(obj_ptr, obj_cl, compact >= 0 ? compact : 0, member ? member->GetName() : nullptr);
+
+   return !res.empty();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute command marked as _kind=='Command'
 
@@ -1471,6 +1504,7 @@ Bool_t TRootSniffer::ProduceImage(Int_t /*kind*/, const std::string & /*path*/,
 ///   "root.gif"  - gif image
 ///   "root.xml"  - xml representation
 ///   "root.json" - json representation
+///   "root.jbin" - json representation with arrays as binary blocks
 ///   "exe.json"  - method execution with json reply
 ///   "exe.bin"   - method execution with binary reply
 ///   "exe.txt"   - method execution with debug output
@@ -1503,6 +1537,9 @@ Bool_t TRootSniffer::Produce(const std::string &path, const std::string &file, c
    if (file == "root.json")
       return ProduceJson(path, options, res);
 
+   if (file == "root.jbin")
+      return ProduceBinaryJson(path, options, res);
+
    // used for debugging
    if (file == "exe.txt")
       return ProduceExe(path, options, 0, res);
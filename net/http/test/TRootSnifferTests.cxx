@@ -0,0 +1,41 @@
+#include "TRootSniffer.h"
+#include "TH1.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+TEST(TRootSniffer, BinaryJsonRequest)
+{
+   TRootSniffer sniff("sniff");
+   auto h = new TH1D("hjbin", "binary json request", 50, 0., 5.);
+   h->SetDirectory(nullptr);
+   for (int bin = 1; bin <= 50; ++bin)
+      h->SetBinContent(bin, bin);
+   ASSERT_TRUE(sniff.RegisterObject("test", h));
+
+   std::string res;
+   ASSERT_TRUE(sniff.Produce("Objects/test/hjbin", "root.jbin", "compact=3", res));
+   ASSERT_GT(res.size(), 8u);
+   EXPECT_EQ(res.compare(0, 4, "RJB1"), 0);
+   std::size_t jsonlen = 0;
+   for (int n = 3; n >= 0; --n)
+      jsonlen = (jsonlen << 8) | (unsigned char)res[4 + n];
+   const std::string json = res.substr(8, jsonlen);
+   EXPECT_NE(json.find("\"_typename\":\"TH1D\""), std::string::npos) << json;
+   EXPECT_NE(json.find("\"fArray\":{\"$arr\":\"Float64\",\"len\":52,\"o\":8,\"bin\":"), std::string::npos) << json;
+   // the block of fArray follows the JSON code
+   EXPECT_GE(res.size(), ((8 + jsonlen + 7) & ~std::size_t(7)) + 50 * sizeof(Double_t));
+
+   // the same object with a plain JSON request
+   std::string text;
+   ASSERT_TRUE(sniff.Produce("Objects/test/hjbin", "root.json", "compact=3", text));
+   EXPECT_EQ(text.find("\"bin\":"), std::string::npos);
+   EXPECT_NE(text.find("\"fArray\":[0,1,2,3,"), std::string::npos) << text;
+
+   // unknown items give no reply
+   EXPECT_FALSE(sniff.Produce("Objects/test/nothere", "root.jbin", "", res));
+
+   sniff.UnregisterObject(h);
+   delete h;
+}
@@ -41,6 +41,8 @@ class RNTupleCompressor {
 private:
    using Buffer_t = std::array<unsigned char, kMAXZIPBUF>;
    std::unique_ptr<Buffer_t> fZipBuffer;
+   /// Used for the ZSTD compression, if set
+   const ROOT::Internal::RZstdDictionary *fZstdDictionary = nullptr;
 
 public:
    /// Data might be overwritten, if a zipped block in the middle of a large input data stream
@@ -54,6 +56,12 @@ public:
    RNTupleCompressor(RNTupleCompressor &&other) = default;
    RNTupleCompressor &operator =(RNTupleCompressor &&other) = default;
 
+   /// Compress with the given ZSTD dictionary when the compression algorithm is ZSTD. The dictionary is found
+   /// by the decompressor if it was registered with ROOT::Internal::RZstdDictionary::Register(), e.g. after having
+   /// been stored alongside the data.
+   void SetZstdDictionary(const ROOT::Internal::RZstdDictionary *dict) { fZstdDictionary = dict; }
+   const ROOT::Internal::RZstdDictionary *GetZstdDictionary() const { return fZstdDictionary; }
+
    /// Returns the size of the compressed data. Data is compressed in 16MB blocks and written
    /// piecewise using the provided writer
    size_t operator() (const void *from, size_t nbytes, int compression, Writer_t fnWriter) {
@@ -75,7 +83,8 @@ public:
       size_t szZipData = 0;
       for (unsigned int i = 0; i < nZipBlocks; ++i) {
          int szSource = std::min(static_cast<int>(kMAXZIPBUF), szRemaining);
-         R__zipMultipleAlgorithm(cxLevel, &szSource, source, &szTarget, target, &szOutBlock, cxAlgorithm);
+         ROOT::Internal::R__zipMultipleAlgorithm(cxLevel, &szSource, source, &szTarget, target, &szOutBlock, cxAlgorithm,
+                                                 fZstdDictionary);
          R__ASSERT(szOutBlock >= 0);
          if ((szOutBlock == 0) || (szOutBlock >= szSource)) {
             // Uncompressible block, we have to store the entire input data stream uncompressed
@@ -111,7 +120,8 @@ public:
       int szTarget = nbytes;
       char *target = reinterpret_cast<char *>(fZipBuffer->data());
       int szOut = 0;
-      R__zipMultipleAlgorithm(cxLevel, &szSource, source, &szTarget, target, &szOut, cxAlgorithm);
+      ROOT::Internal::R__zipMultipleAlgorithm(cxLevel, &szSource, source, &szTarget, target, &szOut, cxAlgorithm,
+                                              fZstdDictionary);
       R__ASSERT(szOut >= 0);
       if ((szOut > 0) && (static_cast<unsigned int>(szOut) < nbytes))
          return szOut;
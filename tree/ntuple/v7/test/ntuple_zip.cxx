@@ -1,5 +1,7 @@
 #include "ntuple_test.hxx"
 
+#include <ZipZSTD.h>
+
 TEST(RNTupleZip, Basics)
 {
    RNTupleCompressor compressor;
@@ -53,6 +55,36 @@ TEST(RNTupleZip, Small)
 }
 
 
+TEST(RNTupleZip, ZstdDictionary)
+{
+   // Pages of a column are alike; train the dictionary from a few of them.
+   auto makePage = [](int i) {
+      std::string page;
+      for (int j = 0; j < 64; ++j)
+         page += "px=" + std::to_string((i * 64 + j) % 97) + ";py=" + std::to_string((i + j) % 89) + ";";
+      return page;
+   };
+   ROOT::Internal::RZstdDictionaryTrainer trainer(512);
+   const ROOT::Internal::RZstdDictionary *dict = nullptr;
+   for (int i = 0; i < 1000 && !dict; ++i) {
+      auto page = makePage(i);
+      dict = trainer.AddSample(page.data(), page.size());
+   }
+   ASSERT_NE(nullptr, dict);
+
+   RNTupleCompressor compressor;
+   RNTupleDecompressor decompressor;
+   auto data = makePage(5000);
+   auto szPlain = compressor(data.data(), data.length(), 505);
+   compressor.SetZstdDictionary(dict);
+   auto szZipped = compressor(data.data(), data.length(), 505);
+   EXPECT_LT(szZipped, szPlain);
+   auto unzipBuffer = std::unique_ptr<char[]>(new char[data.length()]);
+   decompressor(compressor.GetZipBuffer(), szZipped, data.length(), unzipBuffer.get());
+   EXPECT_EQ(data, std::string(unzipBuffer.get(), data.length()));
+}
+
+
 TEST(RNTupleZip, Large)
 {
    constexpr unsigned int N = kMAXZIPBUF + 32;
@@ -50,6 +50,8 @@ class TBulkBranchRead;
 }
 namespace Internal {
 class TBranchIMTHelper; ///< A helper class for managing IMT work during TTree:Fill operations.
+class RZstdDictionary;
+class RZstdDictionaryTrainer;
 }
 }
 
@@ -90,6 +92,7 @@ class TBranch : public TNamed , public TAttFill {
    using TIOFeatures = ROOT::TIOFeatures;
 
 protected:
+   friend class TBasket;
    friend class TTreeCache;
    friend class TTreeCloner;
    friend class TTree;
@@ -150,6 +153,9 @@ protected:
 
    Bool_t      fSkipZip;          ///<! After being read, the buffer will not be unzipped.
 
+   const ROOT::Internal::RZstdDictionary *fZstdDictionary{nullptr};         ///<! ZSTD dictionary compressing the baskets, if any
+   ROOT::Internal::RZstdDictionaryTrainer *fZstdDictionaryTrainer{nullptr}; ///<! Collects the first baskets to train fZstdDictionary
+
    using CacheInfo_t = ROOT::Internal::TBranchCacheInfo;
    CacheInfo_t fCacheInfo;        ///<! Hold info about which basket are in the cache and if they have been retrieved from the cache.
 
@@ -171,6 +177,7 @@ protected:
    Int_t    WriteBasket(TBasket* basket, Int_t where) { return WriteBasketImpl(basket, where, nullptr); }
 
    TString  GetRealFileName() const;
+   const ROOT::Internal::RZstdDictionary *UpdateZstdDictionary(const char *buffer, Int_t nbytes);
 
    virtual void SetAddressImpl(void *addr, Bool_t /* implied */) { SetAddress(addr); }
 
@@ -282,6 +289,8 @@ public:
    virtual void      SetStatus(Bool_t status=1);
    virtual void      SetTree(TTree *tree) { fTree = tree;}
    virtual void      SetupAddresses();
+           Bool_t    SetZstdDictionary(const void *content, Int_t size);
+           void      SetZstdDictionaryTraining(Int_t capacity = 16384);
            Bool_t    SupportsBulkRead() const;
    virtual void      UpdateAddress() {;}
    virtual void      UpdateFile();
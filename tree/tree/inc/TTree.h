@@ -140,6 +140,11 @@ protected:
    UInt_t         fNEntriesSinceSorting;  ///<! Number of entries processed since the last re-sorting of branches
    std::vector<std::pair<Long64_t,TBranch*>> fSortedBranches; ///<! Branches to be processed in parallel when IMT is on, sorted by average task time
    std::vector<TBranch*> fSeqBranches;    ///<! Branches to be processed sequentially when IMT is on
+   Bool_t         fIMTParallelFill{kFALSE}; ///<! true if the top-level branches are filled in parallel when IMT is on
+   UInt_t         fNFillsSinceGrouping{0};  ///<! Number of entries filled since the last regrouping of branches
+   std::vector<Long64_t> fFillBranchTimes;  ///<! Fill time (nanoseconds) per top-level branch since the last regrouping
+   std::vector<Int_t> fFillBranchBytes;     ///<! Bytes written per top-level branch by the last parallel Fill
+   std::vector<Int_t> fFillGroups;          ///<! Index of the first top-level branch of each parallel fill task, plus the end
    Float_t fTargetMemoryRatio{1.1f};      ///<! Ratio for memory usage in uncompressed buffers versus actual occupancy.  1.0
                                            /// indicates basket should be resized to exact memory usage, but causes significant
 /// memory churn.
@@ -159,6 +164,9 @@ private:
 
    void             InitializeBranchLists(bool checkLeafCount);
    void             SortBranchesByTime();
+   void             GroupBranchesForFill();
+   void             FillBranchesParallel();
+   void             FlushFillBranchTimes();
    Int_t            FlushBasketsImpl() const;
    void             MarkEventCluster();
 
@@ -473,6 +481,7 @@ public:
    virtual const char     *GetFriendAlias(TTree*) const;
    TH1                    *GetHistogram() { return GetPlayer()->GetHistogram(); }
    virtual Bool_t          GetImplicitMT() { return fIMTEnabled; }
+   Bool_t                  GetParallelFill() const { return fIMTParallelFill; }
    virtual Int_t          *GetIndex() { return &fIndex.fArray[0]; }
    virtual Double_t       *GetIndexValues() { return &fIndexValues.fArray[0]; }
            ROOT::TIOFeatures GetIOFeatures() const;
@@ -613,6 +622,7 @@ public:
    virtual void            SetEventList(TEventList* list);
    virtual void            SetEntryList(TEntryList* list, Option_t *opt="");
    virtual void            SetImplicitMT(Bool_t enabled) { fIMTEnabled = enabled; }
+   void                    SetParallelFill(Bool_t enabled = kTRUE);
    virtual void            SetMakeClass(Int_t make);
    virtual void            SetMaxEntryLoop(Long64_t maxev = kMaxEntries) { fMaxEntryLoop = maxev; } // *MENU*
    static  void            SetMaxTreeSize(Long64_t maxsize = 100000000000LL);
@@ -640,6 +650,7 @@ public:
    virtual void            SetTreeIndex(TVirtualIndex* index);
    virtual void            SetWeight(Double_t w = 1, Option_t* option = "");
    virtual void            SetUpdate(Int_t freq = 0) { fUpdate = freq; }
+   virtual void            SetZstdDictionaryTraining(const char *bname = "*", Int_t capacity = 16384);
    virtual void            Show(Long64_t entry = -1, Int_t lenmax = 20);
    virtual void            StartViewer(); // *MENU*
    virtual Int_t           StopCacheLearningPhase();
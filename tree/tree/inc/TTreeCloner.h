@@ -54,6 +54,7 @@ class TTreeCloner {
    Int_t           fCacheSize;   ///< Requested size of the file cache
    TFileCacheRead *fFileCache;   ///< File Cache used to reduce the number of individual reads
    TFileCacheRead *fPrevCache;   ///< Cache that set before the TTreeCloner ctor for the 'from' TTree if any.
+   Int_t           fWriteCacheSize; ///< Size of the write cache used to combine the basket writes, 0 to disable.
 
    enum ECloneMethod {
       kDefault             = 0,
@@ -80,6 +81,7 @@ class TTreeCloner {
    friend class CompareEntry;
 
    void ImportClusterRanges();
+   Bool_t CoalesceClusterRanges();
    void CreateCache();
    UInt_t FillCache(UInt_t from);
    void RestoreCache();
@@ -93,7 +95,8 @@ public:
       kNone       = 0,
       kNoWarnings = BIT(1),
       kIgnoreMissingTopLevel = BIT(2),
-      kNoFileCache = BIT(3)
+      kNoFileCache = BIT(3),
+      kKeepClusters = BIT(4)
    };
 
    TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t options = kNone);
@@ -112,6 +115,7 @@ public:
    Bool_t IsValid() { return fIsValid; }
    Bool_t NeedConversion() { return fNeedConversion; }
    void   SetCacheSize(Int_t size);
+   void   SetWriteCacheSize(Int_t size) { fWriteCacheSize = size; }
    void   SortBaskets();
    void   WriteBaskets();
 
@@ -23,14 +23,38 @@
 #include "TVirtualMutex.h"
 #include "TVirtualPerfStats.h"
 #include "TTimeStamp.h"
+#include "ROOT/RSharedPayloadCache.hxx"
 #include "ROOT/TIOFeatures.hxx"
 #include "RZip.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
 #include <bitset>
 
 const UInt_t kDisplacementMask = 0xFF000000;  // In the streamer the two highest bytes of
                                               // the fEntryOffset are used to stored displacement.
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the runner processing the compression blocks of a large basket when
+/// TKey::GetZipThreads allows nthreads > 1: tasks of the implicit multi-threading
+/// pool, in which the baskets are already compressed, rather than new threads.
+
+static ROOT::Internal::RBlockRunner GetBlockRunner(Int_t nthreads)
+{
+#ifdef R__USE_IMT
+   if (nthreads > 1)
+      return [](int nblocks, const std::function<void(int)> &work) {
+         ROOT::TThreadExecutor pool;
+         pool.Foreach(work, ROOT::TSeq<int>(nblocks));
+      };
+#else
+   (void)nthreads;
+#endif
+   return {};
+}
+
 ClassImp(TBasket);
 
 /** \class TBasket
@@ -602,29 +626,47 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       memcpy(rawUncompressedBuffer, rawCompressedBuffer, fKeylen);
       char *rawUncompressedObjectBuffer = rawUncompressedBuffer+fKeylen;
       UChar_t *rawCompressedObjectBuffer = (UChar_t*)rawCompressedBuffer+fKeylen;
-      Int_t nin, nbuf;
+      Int_t nin = 0, nbuf = 0;
       Int_t nout = 0, noutot = 0, nintot = 0;
 
-      // Unzip all the compressed objects in the compressed object buffer.
-      while (1) {
-         // Check the header for errors.
-         if (R__unlikely(R__unzip_header(&nin, rawCompressedObjectBuffer, &nbuf) != 0)) {
-            Error("ReadBasketBuffers", "Inconsistency found in header (nin=%d, nbuf=%d)", nin, nbuf);
-            break;
-         }
-         if (R__unlikely(oldCase && (nin > fObjlen || nbuf > fObjlen))) {
-            //buffer was very likely not compressed in an old version
-            memcpy(rawUncompressedBuffer+fKeylen, rawCompressedObjectBuffer+fKeylen, fObjlen);
-            goto AfterBuffer;
-         }
+      // Payload already decompressed by another process sharing the file, see TFile::AttachSharedMemory.
+      ROOT::Internal::RSharedPayloadCache *shared = oldCase ? nullptr : file->GetSharedPayloads();
+      const auto sharedVersion = ROOT::Internal::RSharedPayloadCache::MakeVersion(fDatime.Get(), fCycle);
+      const char *sharedPayload = shared ? shared->Find(pos, sharedVersion, fObjlen) : nullptr;
+
+      const Int_t nthreads = oldCase ? 1 : GetZipThreads(fObjlen);
+      if (sharedPayload) {
+         memcpy(rawUncompressedObjectBuffer, sharedPayload, fObjlen);
+         noutot = nout = fObjlen;
+         nintot = len - fKeylen;
+      } else if (nthreads > 1) {
+         // Large basket made of several compressed blocks: unzip them concurrently.
+         nintot = len - fKeylen;
+         noutot = nout = ROOT::Internal::R__unzipBlocks(nintot, rawCompressedObjectBuffer, fObjlen,
+                                                        (unsigned char *)rawUncompressedObjectBuffer,
+                                                        GetBlockRunner(nthreads));
+      } else {
+         // Unzip all the compressed objects in the compressed object buffer.
+         while (1) {
+            // Check the header for errors.
+            if (R__unlikely(R__unzip_header(&nin, rawCompressedObjectBuffer, &nbuf) != 0)) {
+               Error("ReadBasketBuffers", "Inconsistency found in header (nin=%d, nbuf=%d)", nin, nbuf);
+               break;
+            }
+            if (R__unlikely(oldCase && (nin > fObjlen || nbuf > fObjlen))) {
+               //buffer was very likely not compressed in an old version
+               memcpy(rawUncompressedBuffer+fKeylen, rawCompressedObjectBuffer+fKeylen, fObjlen);
+               goto AfterBuffer;
+            }
 
-         R__unzip(&nin, rawCompressedObjectBuffer, &nbuf, (unsigned char*) rawUncompressedObjectBuffer, &nout);
-         if (!nout) break;
-         noutot += nout;
-         nintot += nin;
-         if (noutot >= fObjlen) break;
-         rawCompressedObjectBuffer += nin;
-         rawUncompressedObjectBuffer += nout;
+            R__unzip(&nin, rawCompressedObjectBuffer, &nbuf, (unsigned char*) rawUncompressedObjectBuffer, &nout);
+            if (!nout) break;
+            noutot += nout;
+            nintot += nin;
+            if (noutot >= fObjlen) break;
+            rawCompressedObjectBuffer += nin;
+            rawUncompressedObjectBuffer += nout;
+         }
       }
 
       // Make sure the uncompressed numbers are consistent with header.
@@ -633,6 +675,8 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
          fBranch->GetTree()->IncrementTotalBuffers(fBufferSize);
          return 1;
       }
+      if (shared && !sharedPayload)
+         shared->Insert(pos, sharedVersion, rawUncompressedBuffer + fKeylen, fObjlen);
       len = fObjlen+fKeylen;
       TVirtualPerfStats* temp = gPerfStats;
       if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
@@ -1204,7 +1248,7 @@ Int_t TBasket::WriteBuffer()
       }
    }
 
-   Int_t lbuf, nout, noutot, bufmax, nzip;
+   Int_t lbuf, nout, noutot;
    lbuf       = fBufferRef->Length();
    fObjlen    = lbuf - fKeylen;
 
@@ -1228,47 +1272,46 @@ Int_t TBasket::WriteBuffer()
       fBuffer = fCompressedBufferRef->Buffer();
       char *objbuf = fBufferRef->Buffer() + fKeylen;
       char *bufcur = &fBuffer[fKeylen];
-      noutot = 0;
-      nzip   = 0;
-      for (Int_t i = 0; i < nbuffers; ++i) {
-         if (i == nbuffers - 1) bufmax = fObjlen - nzip;
-         else bufmax = kMAXZIPBUF;
-         // Compress the buffer.  Note that we allow multiple TBasket compressions to occur at once
-         // for a given TFile: that's because the compression buffer when we use IMT is no longer
-         // shared amongst several threads.
+      // Compress the buffer, block by block, the blocks of large baskets concurrently on the
+      // implicit multi-threading pool (see GetBlockRunner).  Note that we allow multiple TBasket compressions to occur at once
+      // for a given TFile: that's because the compression buffer when we use IMT is no longer
+      // shared amongst several threads.
 #ifdef R__USE_IMT
-         sentry.unlock();
+      sentry.unlock();
 #endif  // R__USE_IMT
-         // NOTE this is declared with C linkage, so it shouldn't except.  Also, when
-         // USE_IMT is defined, we are guaranteed that the compression buffer is unique per-branch.
-         // (see fCompressedBufferRef in constructor).
-         R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm);
+      // The dictionary, and its training, are per branch: the baskets of a branch are
+      // not written concurrently.
+      const ROOT::Internal::RZstdDictionary *zstdDict = nullptr;
+      if (ROOT::Internal::R__resolveAlgorithm(cxAlgorithm) == ROOT::RCompressionSetting::EAlgorithm::kZSTD)
+         zstdDict = fBranch->UpdateZstdDictionary(objbuf, fObjlen);
+      // NOTE this is declared with C linkage, so it shouldn't except.  Also, when
+      // USE_IMT is defined, we are guaranteed that the compression buffer is unique per-branch.
+      // (see fCompressedBufferRef in constructor).
+      noutot = ROOT::Internal::R__zipBlocks(cxlevel, fObjlen, objbuf, buflen - fKeylen, bufcur, cxAlgorithm,
+                                            GetBlockRunner(GetZipThreads(fObjlen)), zstdDict);
 #ifdef R__USE_IMT
-         sentry.lock();
+      sentry.lock();
 #endif  // R__USE_IMT
-
-         // test if buffer has really been compressed. In case of small buffers
-         // when the buffer contains random data, it may happen that the compressed
-         // buffer is larger than the input. In this case, we write the original uncompressed buffer
-         if (nout == 0 || nout >= fObjlen) {
-            nout = fObjlen;
-            // We used to delete fBuffer here, we no longer want to since
-            // the buffer (held by fCompressedBufferRef) might be re-used later.
-            fBuffer = fBufferRef->Buffer();
-            Create(fObjlen,file);
-            fBufferRef->SetBufferOffset(0);
-
-            Streamer(*fBufferRef);         //write key itself again
-            if ((nout+fKeylen)>buflen) {
-               Warning("WriteBuffer","Possible memory corruption due to compression algorithm, wrote %d bytes past the end of a block of %d bytes. fNbytes=%d, fObjLen=%d, fKeylen=%d",
-                  (nout+fKeylen-buflen),buflen,fNbytes,fObjlen,fKeylen);
-            }
-            goto WriteFile;
+      if (zstdDict)
+         file->AddZstdDictionary(*zstdDict);
+
+      // test if buffer has really been compressed. In case of small buffers
+      // when the buffer contains random data, it may happen that the compressed
+      // buffer is larger than the input. In this case, we write the original uncompressed buffer
+      if (noutot == 0 || noutot >= fObjlen) {
+         nout = fObjlen;
+         // We used to delete fBuffer here, we no longer want to since
+         // the buffer (held by fCompressedBufferRef) might be re-used later.
+         fBuffer = fBufferRef->Buffer();
+         Create(fObjlen,file);
+         fBufferRef->SetBufferOffset(0);
+
+         Streamer(*fBufferRef);         //write key itself again
+         if ((nout+fKeylen)>buflen) {
+            Warning("WriteBuffer","Possible memory corruption due to compression algorithm, wrote %d bytes past the end of a block of %d bytes. fNbytes=%d, fObjLen=%d, fKeylen=%d",
+               (nout+fKeylen-buflen),buflen,fNbytes,fObjlen,fKeylen);
          }
-         bufcur += nout;
-         noutot += nout;
-         objbuf += kMAXZIPBUF;
-         nzip   += kMAXZIPBUF;
+         goto WriteFile;
       }
       nout = noutot;
       Create(noutot,file);
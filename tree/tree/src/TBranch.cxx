@@ -50,6 +50,7 @@
 #include "snprintf.h"
 
 #include "TBranchIMTHelper.h"
+#include "ZipZSTD.h"
 
 #include "ROOT/TIOFeatures.hxx"
 
@@ -452,6 +453,9 @@ TBranch::~TBranch()
    delete fBrowsables;
    fBrowsables = 0;
 
+   delete fZstdDictionaryTrainer;
+   fZstdDictionaryTrainer = nullptr;
+
    // Note: We do *not* have ownership of the buffer.
    fEntryBuffer = 0;
 
@@ -2706,6 +2710,72 @@ void TBranch::SetCompressionSettings(Int_t settings)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Compress the baskets of this branch and of its sub-branches with the ZSTD
+/// dictionary 'content', in the format produced by `zstd --train` or
+/// ZDICT_trainFromBuffer(). This only affects the baskets compressed with ZSTD;
+/// the dictionary is stored in the file when the first of them is written.
+/// Returns false if 'content' is not a ZSTD dictionary.
+
+Bool_t TBranch::SetZstdDictionary(const void *content, Int_t size)
+{
+   auto dict = ROOT::Internal::RZstdDictionary::Register(content, size > 0 ? size : 0);
+   if (!dict) {
+      Error("SetZstdDictionary", "not a ZSTD dictionary");
+      return kFALSE;
+   }
+   delete fZstdDictionaryTrainer;
+   fZstdDictionaryTrainer = nullptr;
+   fZstdDictionary = dict;
+
+   Int_t nb = fBranches.GetEntriesFast();
+   for (Int_t i=0;i<nb;i++) {
+      TBranch *branch = (TBranch*)fBranches.UncheckedAt(i);
+      branch->SetZstdDictionary(content, size);
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Train, for this branch and for each of its sub-branches, a ZSTD dictionary
+/// of at most 'capacity' bytes from the first baskets of the branch; the
+/// following baskets are compressed with it. This only affects the baskets
+/// compressed with ZSTD and pays off for small baskets, which on their own
+/// offer little redundancy to the compression. 0 stops the ongoing trainings.
+///
+/// The dictionaries are stored in the file; reading it back requires a ROOT
+/// version supporting ZSTD dictionaries.
+
+void TBranch::SetZstdDictionaryTraining(Int_t capacity)
+{
+   delete fZstdDictionaryTrainer;
+   fZstdDictionaryTrainer = capacity > 0 ? new ROOT::Internal::RZstdDictionaryTrainer(capacity) : nullptr;
+
+   Int_t nb = fBranches.GetEntriesFast();
+   for (Int_t i=0;i<nb;i++) {
+      TBranch *branch = (TBranch*)fBranches.UncheckedAt(i);
+      branch->SetZstdDictionaryTraining(capacity);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the ZSTD dictionary to compress the basket buffer of 'nbytes' bytes
+/// with, after having used the buffer as sample for the training of the
+/// dictionary if it is ongoing.
+
+const ROOT::Internal::RZstdDictionary *TBranch::UpdateZstdDictionary(const char *buffer, Int_t nbytes)
+{
+   if (fZstdDictionaryTrainer) {
+      if (auto dict = fZstdDictionaryTrainer->AddSample(buffer, nbytes))
+         fZstdDictionary = dict;
+      if (fZstdDictionaryTrainer->IsDone()) {
+         delete fZstdDictionaryTrainer;
+         fZstdDictionaryTrainer = nullptr;
+      }
+   }
+   return fZstdDictionary;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Update the default value for the branch's fEntryOffsetLen if and only if
 /// it was already non zero (and the new value is not zero)
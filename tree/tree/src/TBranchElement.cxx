@@ -5552,10 +5552,19 @@ void TBranchElement::SetActionSequence(TClass *originalClass, TStreamerInfo *loc
    }
 
    if (actionSequence) delete actionSequence;
-   auto original = create(localInfo, GetCollectionProxy(), originalClass);
+   TVirtualCollectionProxy *proxy = GetCollectionProxy();
+   auto original = create(localInfo, proxy, originalClass);
 
    actionSequence = original->CreateSubSequence(fNewIDs, fOffset, create);
 
+   if (actionSequence->fLoopConfig
+       && (create == TStreamerInfoActions::TActionSequence::ReadMemberWiseActionsCollectionCreator
+           || create == TStreamerInfoActions::TActionSequence::WriteMemberWiseActionsCollectionCreator)) {
+      // The original sequence is shared by all the branches with the same layout
+      // and loops over its own copy of the proxy, loop over ours instead.
+      actionSequence->fLoopConfig->fProxy = proxy;
+   }
+
    if (!isSplitNode)
       fNewIDs.erase(fNewIDs.begin());
 
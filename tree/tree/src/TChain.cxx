@@ -1948,6 +1948,12 @@ Long64_t TChain::Merge(TCollection* /* list */, TFileMergeInfo *)
 /// in which they will be needed when reading the whole tree
 /// sequentially.
 ///
+/// In 'fast' mode, the single-cluster trees of small input files are
+/// combined into larger clusters in the output, up to the auto-flush
+/// setting of the input trees. Add "KeepClusters" to 'option' to keep
+/// one cluster per input file instead. Branches disabled with
+/// SetBranchStatus are not copied.
+///
 /// ## IMPORTANT Note 1: AUTOMATIC FILE OVERFLOW
 ///
 /// When merging many files, it may happen that the resulting file
@@ -431,6 +431,7 @@ End_Macro
 #include <cstdio>
 #include <climits>
 #include <algorithm>
+#include <numeric>
 #include <set>
 
 #ifdef R__USE_IMT
@@ -440,6 +441,7 @@ End_Macro
 
 constexpr Int_t   kNEntriesResort    = 100;
 constexpr Float_t kNEntriesResortInv = 1.f/kNEntriesResort;
+constexpr Int_t   kMinParallelFillBranches = 16;
 
 Int_t    TTree::fgBranchStyle = 1;  // Use new TBranch style with TBranchElement.
 Long64_t TTree::fgMaxTreeSize = 100000000000LL;
@@ -1492,6 +1494,7 @@ Long64_t TTree::AutoSave(Option_t* option)
       if (gDebug > 0) Info("AutoSave", "calling FlushBaskets \n");
       FlushBasketsImpl();
    }
+   FlushFillBranchTimes();
 
    fSavedBytes = GetZipBytes();
 
@@ -3478,6 +3481,11 @@ namespace {
 /// - AsIsIndexOnError [default]: In case of missing TTreeIndex, the resulting TTree index has gaps.
 /// - BuildIndexOnError : If any of the underlying TTree objects do not have a TTreeIndex,
 ///                          all TTreeIndex are 'ignored' and the missing piece are rebuilt.
+///
+/// If 'option' contains the word 'ParallelFill', the entries that are not fast-cloned
+/// (for example because the compression settings differ) are filled, and their baskets
+/// compressed, with TTree::SetParallelFill enabled on this tree.
+/// The previous setting of this tree is restored afterwards.
 
 Long64_t TTree::CopyEntries(TTree* tree, Long64_t nentries /* = -1 */, Option_t* option /* = "" */)
 {
@@ -3517,6 +3525,19 @@ Long64_t TTree::CopyEntries(TTree* tree, Long64_t nentries /* = -1 */, Option_t*
       }
    }
    if (gDebug > 0 && cacheSize != -1) Info("CopyEntries","Using Cache size: %d\n",cacheSize);
+   // The parallel fill is only enabled for the copy, the setting of the caller is restored on return.
+   struct RParallelFillRestorer {
+      TTree *fTree;
+      Bool_t fEnabled;
+      ~RParallelFillRestorer()
+      {
+         if (fTree)
+            fTree->SetParallelFill(fEnabled);
+      }
+   } parallelFillRestorer{opt.Contains("parallelfill") ? this : nullptr, GetParallelFill()};
+   if (opt.Contains("parallelfill")) {
+      SetParallelFill(kTRUE);
+   }
 
    Long64_t nbytes = 0;
    Long64_t treeEntries = tree->GetEntriesFast();
@@ -3875,6 +3896,11 @@ Long64_t TTree::Draw(const char* varexp, const TCut& selection, Option_t* option
 ///    - if expression has more than four fields the option "PARA"or "CANDLE"
 ///      can be used.
 ///    - If option contains the string "goff", no graphics is generated.
+///    - If option contains the string "jit", the expression and the selection
+///      are translated to C++ and compiled once with cling instead of being
+///      interpreted for each entry (see TTreeFormula::JITCompile). Expressions
+///      that can not be translated are silently interpreted as usual. This can
+///      be made the default with `TTreeFormula.JIT: 1` in the rootrc file.
 ///
 /// \param [in] nentries is the number of entries to process (default is all)
 ///
@@ -4557,6 +4583,10 @@ Int_t TTree::Fill()
       fIMTZipBytes.store(0);
       fIMTTotBytes.store(0);
    }
+   // The branches of the TRefTable must see the objects in order, see SetParallelFill.
+   const bool parallelFill = useIMT && fIMTParallelFill && !fBranchRef && nbranches >= kMinParallelFillBranches;
+   if (parallelFill)
+      FillBranchesParallel();
 #endif
 
    for (Int_t i = 0; i < nbranches; ++i) {
@@ -4569,7 +4599,9 @@ Int_t TTree::Fill()
 #ifndef R__USE_IMT
       nwrite = branch->FillImpl(nullptr);
 #else
-      nwrite = branch->FillImpl(useIMT ? &imtHelper : nullptr);
+      // In parallel mode the branches are already filled, we only collect the results
+      // so that the error reporting stays in the order of the branches.
+      nwrite = parallelFill ? fFillBranchBytes[i] : branch->FillImpl(useIMT ? &imtHelper : nullptr);
 #endif
       if (nwrite < 0) {
          if (nerror < 2) {
@@ -5074,6 +5106,7 @@ Int_t TTree::FlushBaskets(Bool_t create_cluster) const
 Int_t TTree::FlushBasketsImpl() const
 {
    if (!fDirectory) return 0;
+   const_cast<TTree*>(this)->FlushFillBranchTimes();
    Int_t nbytes = 0;
    Int_t nerror = 0;
    TObjArray *lb = const_cast<TTree*>(this)->GetListOfBranches();
@@ -5740,6 +5773,113 @@ void TTree::InitializeBranchLists(bool checkLeafCount)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the top-level branches in parallel tasks (see SetParallelFill).
+///
+/// Each task fills a contiguous group of branches, in order. The baskets that
+/// become full are compressed and written by the task that filled them. The
+/// number of bytes (or the error code) of each branch is stored in
+/// fFillBranchBytes and is processed sequentially by TTree::Fill.
+
+void TTree::FillBranchesParallel()
+{
+#ifdef R__USE_IMT
+   const Int_t nbranches = fBranches.GetEntriesFast();
+   if (fFillGroups.empty() || fFillGroups.back() != nbranches)
+      GroupBranchesForFill();
+
+   // Enable this IMT use case (activate its locks)
+   ROOT::Internal::TParBranchProcessingRAII pbpRAII;
+
+   auto fillGroup = [&](Int_t g) {
+      for (Int_t i = fFillGroups[g]; i < fFillGroups[g + 1]; ++i) {
+         TBranch *branch = (TBranch *)fBranches.UncheckedAt(i);
+         if (branch->TestBit(kDoNotProcess)) {
+            fFillBranchBytes[i] = 0;
+            continue;
+         }
+         auto start = std::chrono::steady_clock::now();
+         fFillBranchBytes[i] = branch->FillImpl(nullptr);
+         auto end = std::chrono::steady_clock::now();
+         fFillBranchTimes[i] += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+      }
+   };
+
+   ROOT::TThreadExecutor pool;
+   pool.Foreach(fillGroup, ROOT::TSeqI(fFillGroups.size() - 1));
+
+   // Re-group branches if necessary
+   if (++fNFillsSinceGrouping == kNEntriesResort)
+      GroupBranchesForFill();
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Report the fill times of the branches accumulated by FillBranchesParallel to
+/// the TTreePerfStats, if any, and restart the measurement.
+
+void TTree::FlushFillBranchTimes()
+{
+#ifdef R__USE_IMT
+   if (fNFillsSinceGrouping == 0)
+      return;
+   if (fPerfStats) {
+      const Int_t n = std::min(fBranches.GetEntriesFast(), (Int_t)fFillBranchTimes.size());
+      for (Int_t i = 0; i < n; ++i)
+         fPerfStats->FillBranchEvent((TBranch *)fBranches.UncheckedAt(i), 1e-9 * fFillBranchTimes[i]);
+   }
+   std::fill(fFillBranchTimes.begin(), fFillBranchTimes.end(), 0LL);
+   fNFillsSinceGrouping = 0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Split the top-level branches into contiguous groups of similar cost, each
+/// group being filled by one task in FillBranchesParallel.
+///
+/// The cost of a branch is its fill time since the last grouping (or since the
+/// times were reported, see FlushFillBranchTimes) or, when no time was recorded
+/// yet, its size on file. Small branches are thus gathered
+/// in the same task to amortize the scheduling overhead.
+
+void TTree::GroupBranchesForFill()
+{
+#ifdef R__USE_IMT
+   const Int_t nbranches = fBranches.GetEntriesFast();
+   if (fFillBranchTimes.size() != unsigned(nbranches)) {
+      FlushFillBranchTimes();
+      fFillBranchTimes.assign(nbranches, 0LL);
+      fFillBranchBytes.assign(nbranches, 0);
+   }
+
+   std::vector<Long64_t> cost(fFillBranchTimes);
+   Long64_t total = std::accumulate(cost.begin(), cost.end(), 0LL);
+   if (total == 0) {
+      for (Int_t i = 0; i < nbranches; ++i)
+         cost[i] = 1 + ((TBranch *)fBranches.UncheckedAt(i))->GetTotBytes("*");
+      total = std::accumulate(cost.begin(), cost.end(), 0LL);
+   }
+
+   // A few tasks per thread to let the scheduler balance the load.
+   const Int_t ntasks = std::max(1, std::min(nbranches, 4 * (Int_t)ROOT::GetThreadPoolSize()));
+   const Long64_t target = total / ntasks;
+
+   fFillGroups.clear();
+   fFillGroups.push_back(0);
+   Long64_t groupCost = 0;
+   for (Int_t i = 0; i < nbranches; ++i) {
+      groupCost += cost[i];
+      if (groupCost >= target && i + 1 < nbranches) {
+         fFillGroups.push_back(i + 1);
+         groupCost = 0;
+      }
+   }
+   fFillGroups.push_back(nbranches);
+
+   FlushFillBranchTimes();
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Sorts top-level branches by the last average task time recorded per branch.
 
@@ -8214,6 +8354,31 @@ void TTree::SetBasketSize(const char* bname, Int_t buffsize)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Train a ZSTD dictionary of at most 'capacity' bytes for each branch matching
+/// the wildcarded name 'bname' from its first baskets, to compress the following
+/// ones; 0 stops the trainings. See TBranch::SetZstdDictionaryTraining.
+
+void TTree::SetZstdDictionaryTraining(const char *bname, Int_t capacity)
+{
+   Int_t nleaves = fLeaves.GetEntriesFast();
+   TRegexp re(bname, kTRUE);
+   Int_t nb = 0;
+   for (Int_t i = 0; i < nleaves; i++)  {
+      TLeaf* leaf = (TLeaf*) fLeaves.UncheckedAt(i);
+      TBranch* branch = (TBranch*) leaf->GetBranch();
+      TString s = branch->GetName();
+      if (strcmp(bname, branch->GetName()) && (s.Index(re) == kNPOS)) {
+         continue;
+      }
+      nb++;
+      branch->SetZstdDictionaryTraining(capacity);
+   }
+   if (!nb) {
+      Error("SetZstdDictionaryTraining", "unknown branch -> '%s'", bname);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Change branch address, dealing with clone trees properly.
 /// See TTree::CheckBranchAddressType for the semantic of the return value.
@@ -9131,6 +9296,30 @@ void TTree::SetParallelUnzip(Bool_t opt, Float_t RelSize)
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable or disable the parallel filling of the top-level branches.
+///
+/// When implicit multi-threading is enabled (ROOT::EnableImplicitMT) and this
+/// option is set, TTree::Fill serializes the top-level branches in parallel
+/// tasks instead of one after the other. This is useful for trees with
+/// thousands of branches, where Fill itself is the bottleneck. Branches are
+/// gathered in groups of similar cost (measured while filling) so that small
+/// branches do not pay one task each. The content of the tree does not depend
+/// on the number of threads.
+///
+/// The objects connected to the branches must not be shared between top-level
+/// branches, since they are streamed concurrently. The option has no effect for
+/// trees with less than 16 top-level branches or with a TBranchRef.
+/// When a TTreePerfStats is attached to the tree, the time spent filling each
+/// branch is reported to it (see TTreePerfStats::Print).
+
+void TTree::SetParallelFill(Bool_t enabled)
+{
+   FlushFillBranchTimes();
+   fIMTParallelFill = enabled;
+   fFillGroups.clear();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set perf stats
 
@@ -36,8 +36,17 @@ Class implementing or helping  the various TTree cloning method
 #include "TTreeCache.h"
 #include "snprintf.h"
 
+#include "TFileCacheWrite.h"
+
 #include <algorithm>
 
+namespace {
+/// Default size of the write cache used while copying the baskets.
+constexpr Int_t kDefaultWriteCacheSize = 8 * 1024 * 1024;
+/// Cluster size, in compressed bytes, used when the auto-flush setting does not specify one.
+constexpr Long64_t kDefaultClusterBytes = 30000000;
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Bool_t TTreeCloner::CompareSeek::operator()(UInt_t i1, UInt_t i2)
@@ -100,6 +109,22 @@ Bool_t TTreeCloner::CompareEntry::operator()(UInt_t i1, UInt_t i2)
 /// This means that on the file the baskets will be in the order
 /// in which they will be needed when reading the whole tree
 /// sequentially.
+///
+/// Only the branches present in the output tree are copied, so a subset
+/// of the input branches can be fast cloned by disabling the others
+/// (TTree::SetBranchStatus) before calling TTree::CloneTree or TTree::CopyEntries.
+///
+/// When the input tree is made of a single cluster which fits, together
+/// with the last cluster of the output tree, within the output's auto-flush
+/// setting, the two clusters are combined into one (see CoalesceClusterRanges).
+/// This avoids ending up with many tiny clusters when merging many small files.
+/// The baskets themselves are copied unchanged. Adding "KeepClusters" to
+/// 'method' (or passing the kKeepClusters option) preserves the input clusters
+/// as they are.
+///
+/// The baskets are written through a TFileCacheWrite, so that consecutive
+/// baskets are sent to the output file in large writes (unless the output
+/// file already has a write cache, see SetWriteCacheSize).
 
 TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t options) :
    fWarningMsg(),
@@ -122,10 +147,14 @@ TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t option
    fToStartEntries(0),
    fCacheSize(0LL),
    fFileCache(nullptr),
-   fPrevCache(nullptr)
+   fPrevCache(nullptr),
+   fWriteCacheSize(kDefaultWriteCacheSize)
 {
    TString opt(method);
    opt.ToLower();
+   if (opt.Contains("keepclusters")) {
+      fOptions |= kKeepClusters;
+   }
    if (opt.Contains("sortbasketsbybranch")) {
       //::Info("TTreeCloner::TTreeCloner","use: kSortBasketsByBranch");
       fCloneMethod = TTreeCloner::kSortBasketsByBranch;
@@ -434,13 +463,14 @@ void TTreeCloner::CollectBaskets()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Make sure that all the needed TStreamerInfo are
-/// present in the output file
+/// Make sure that all the needed TStreamerInfo, and the ZSTD dictionaries
+/// the copied baskets may be compressed with, are present in the output file
 
 void TTreeCloner::CopyStreamerInfos()
 {
    TFile *fromFile = fFromTree->GetDirectory()->GetFile();
    TFile *toFile = fToTree->GetDirectory()->GetFile();
+   toFile->AddZstdDictionaries(*fromFile);
    TList *l = fromFile->GetStreamerInfoList();
    TIter next(l);
    TStreamerInfo *oldInfo;
@@ -595,7 +625,8 @@ void TTreeCloner::ImportClusterRanges()
    // SetEntries was not done.
    fToTree->SetEntries(fToTree->GetEntries() - fFromTree->GetTree()->GetEntries());
 
-   fToTree->ImportClusterRanges( fFromTree->GetTree() );
+   if ((fOptions & kKeepClusters) || !CoalesceClusterRanges())
+      fToTree->ImportClusterRanges( fFromTree->GetTree() );
 
    // This is only updated by TTree::Fill upon seeing a Flush event in TTree::Fill
    // So we need to propagate (this has also the advantage of turning on the
@@ -605,6 +636,90 @@ void TTreeCloner::ImportClusterRanges()
    fToTree->SetEntries(fToTree->GetEntries() + fFromTree->GetTree()->GetEntries());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Append the entries of the input tree to the last cluster of the output
+/// tree rather than starting a new cluster.
+///
+/// This is done only if the input tree is a single cluster and the combined
+/// cluster does not exceed the input's auto-flush setting (a number of
+/// entries if positive, of compressed bytes if negative). Only the cluster
+/// ranges are updated; the baskets are copied as they are since they already
+/// end on the boundary of the input cluster.
+///
+/// Must be called before the input entries are added to the output tree.
+/// Return true if the cluster ranges of the output tree were updated.
+
+Bool_t TTreeCloner::CoalesceClusterRanges()
+{
+   TTree *from = fFromTree->GetTree();
+   const Long64_t nentries = from->GetEntries();
+   const Long64_t toEntries = fToTree->GetEntries();
+   if (nentries == 0 || toEntries == 0)
+      return kFALSE;
+
+   auto fromClusters = from->GetClusterIterator(0);
+   fromClusters.Next();
+   if (fromClusters.GetNextEntry() < nentries)
+      return kFALSE;
+
+   // Locate the last cluster of the output tree. When its range has no fixed
+   // cluster size, the whole range is the only safe choice.
+   Int_t range = 0;
+   while (range < fToTree->fNClusterRange && fToTree->fClusterRangeEnd[range] < toEntries - 1)
+      ++range;
+   const Long64_t rangeStart = range ? fToTree->fClusterRangeEnd[range - 1] + 1 : 0;
+   const Long64_t clusterSize =
+      range < fToTree->fNClusterRange ? fToTree->fClusterSize[range] : fToTree->fAutoFlush;
+   Long64_t lastStart = rangeStart;
+   if (clusterSize > 0)
+      lastStart += ((toEntries - 1 - rangeStart) / clusterSize) * clusterSize;
+
+   const Long64_t combinedEntries = toEntries - lastStart + nentries;
+   const Long64_t autoflush = from->GetAutoFlush();
+   if (autoflush > 0) {
+      if (combinedEntries > autoflush)
+         return kFALSE;
+   } else {
+      const Double_t maxBytes = autoflush < 0 ? -autoflush : kDefaultClusterBytes;
+      const Double_t lastBytes = Double_t(fToTree->GetZipBytes()) * (toEntries - lastStart) / toEntries;
+      if (lastBytes + from->GetZipBytes() > maxBytes)
+         return kFALSE;
+   }
+
+   const Int_t newsize = range + 2;
+   if (newsize > fToTree->fMaxClusterRange) {
+      if (fToTree->fMaxClusterRange) {
+         fToTree->fClusterRangeEnd = (Long64_t*)TStorage::ReAlloc(fToTree->fClusterRangeEnd,
+                                                                  newsize*sizeof(Long64_t),fToTree->fMaxClusterRange*sizeof(Long64_t));
+         fToTree->fClusterSize = (Long64_t*)TStorage::ReAlloc(fToTree->fClusterSize,
+                                                              newsize*sizeof(Long64_t),fToTree->fMaxClusterRange*sizeof(Long64_t));
+      } else {
+         fToTree->fClusterRangeEnd = new Long64_t[newsize];
+         fToTree->fClusterSize = new Long64_t[newsize];
+      }
+      fToTree->fMaxClusterRange = newsize;
+   }
+
+   // Keep the ranges before the last cluster and end the one containing it
+   // just before it, then add a range holding exactly the combined cluster.
+   Int_t nranges = range;
+   if (rangeStart < lastStart) {
+      fToTree->fClusterRangeEnd[range] = lastStart - 1;
+      fToTree->fClusterSize[range] = clusterSize;
+      ++nranges;
+   }
+   fToTree->fClusterRangeEnd[nranges] = toEntries + nentries - 1;
+   fToTree->fClusterSize[nranges] = combinedEntries;
+   fToTree->fNClusterRange = nranges + 1;
+   fToTree->fAutoFlush = autoflush;
+
+   Long64_t autosave = fToTree->GetAutoSave();
+   if (autoflush > 0 && autosave > 0) {
+      fToTree->SetAutoSave( autoflush*(autosave/autoflush) );
+   }
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set the TFile cache size to be used.
 /// Note that the default is to use the same size as the default TTreeCache for
@@ -686,6 +801,15 @@ UInt_t TTreeCloner::FillCache(UInt_t from)
 
 void TTreeCloner::WriteBaskets()
 {
+   // The baskets are appended one after the other at the end of the output
+   // file: go through a write cache to combine them into large writes.
+   TFile *outfile = fToTree->GetCurrentFile();
+   TFileCacheWrite *writeCache = nullptr;
+   if (fWriteCacheSize > 0 && fMaxBaskets > 1 && outfile && !outfile->GetCacheWrite() &&
+       outfile != fFromTree->GetCurrentFile()) {
+      writeCache = new TFileCacheWrite(outfile, fWriteCacheSize);
+   }
+
    TBasket *basket = new TBasket();
    for(UInt_t j = 0, notCached = 0; j<fMaxBaskets; ++j) {
       TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
@@ -721,4 +845,9 @@ void TTreeCloner::WriteBaskets()
       }
    }
    delete basket;
+
+   if (writeCache) {
+      writeCache->Flush();
+      outfile->SetCacheWrite(nullptr);
+   }
 }
@@ -2,6 +2,7 @@
 #include "TROOT.h"
 #include "TSystem.h"
 #include "TTree.h"
+#include "TVirtualPerfStats.h"
 
 #include "gtest/gtest.h"
 
@@ -28,4 +29,158 @@ TEST(TTreeImplicitMT, flushBaskets)
    gSystem->Unlink(ofileName);
 }
 
+TEST(TTreeImplicitMT, parallelFill)
+{
+   ROOT::EnableImplicitMT();
+   const auto ofileName = "parallelFillMT.root";
+   const int nbranches = 200;
+   const int nentries = 1000;
+   {
+      TFile f(ofileName, "RECREATE");
+      TTree t("t", "t");
+      t.SetParallelFill();
+      EXPECT_TRUE(t.GetParallelFill());
+      std::vector<int> values(nbranches);
+      std::vector<std::vector<float>> arrays(nbranches);
+      for (int b = 0; b < nbranches; ++b) {
+         t.Branch(("i" + std::to_string(b)).c_str(), &values[b]);
+         t.Branch(("v" + std::to_string(b)).c_str(), &arrays[b]);
+      }
+      for (int e = 0; e < nentries; ++e) {
+         for (int b = 0; b < nbranches; ++b) {
+            values[b] = e * b;
+            arrays[b].assign(e % 7, 0.5f * b);
+         }
+         EXPECT_GT(t.Fill(), 0);
+      }
+      t.Write();
+   }
+   {
+      TFile f(ofileName);
+      auto t = f.Get<TTree>("t");
+      ASSERT_NE(t, nullptr);
+      EXPECT_EQ(t->GetEntries(), nentries);
+      int i17 = -1;
+      std::vector<float> *v42 = nullptr;
+      t->SetBranchAddress("i17", &i17);
+      t->SetBranchAddress("v42", &v42);
+      for (int e = 0; e < nentries; ++e) {
+         t->GetEntry(e);
+         EXPECT_EQ(i17, e * 17);
+         ASSERT_EQ(v42->size(), e % 7u);
+         for (auto x : *v42)
+            EXPECT_FLOAT_EQ(x, 21.f);
+      }
+      t->ResetBranchAddresses();
+      delete v42;
+   }
+   gSystem->Unlink(ofileName);
+}
+
+// Counts the fill times reported by TTree::Fill in parallel mode.
+class FillTimesPerfStats : public TVirtualPerfStats {
+   void SetFile(TFile *) override {}
+
+public:
+   int fNBranchEvents = 0;
+   double fFillTime = 0.;
+
+   void FillBranchEvent(TBranch *, Double_t filltime) override
+   {
+      ++fNBranchEvents;
+      fFillTime += filltime;
+   }
+   void SimpleEvent(EEventType) override {}
+   void PacketEvent(const char *, const char *, const char *, Long64_t, Double_t, Double_t, Double_t, Long64_t) override
+   {
+   }
+   void FileEvent(const char *, const char *, const char *, const char *, Bool_t) override {}
+   void FileOpenEvent(TFile *, const char *, Double_t) override {}
+   void FileReadEvent(TFile *, Int_t, Double_t) override {}
+   void UnzipEvent(TObject *, Long64_t, Double_t, Int_t, Int_t) override {}
+   void RateEvent(Double_t, Double_t, Long64_t, Long64_t) override {}
+   void SetBytesRead(Long64_t) override {}
+   Long64_t GetBytesRead() const override { return 0; }
+   void SetNumEvents(Long64_t) override {}
+   Long64_t GetNumEvents() const override { return 0; }
+   void PrintBasketInfo(Option_t *) const override {}
+   void SetLoaded(TBranch *, size_t) override {}
+   void SetLoaded(size_t, size_t) override {}
+   void SetLoadedMiss(TBranch *, size_t) override {}
+   void SetLoadedMiss(size_t, size_t) override {}
+   void SetMissed(TBranch *, size_t) override {}
+   void SetMissed(size_t, size_t) override {}
+   void SetUsed(TBranch *, size_t) override {}
+   void SetUsed(size_t, size_t) override {}
+   void UpdateBranchIndices(TObjArray *) override {}
+};
+
+TEST(TTreeImplicitMT, copyEntriesParallelFill)
+{
+   ROOT::EnableImplicitMT();
+   const int nbranches = 20;
+   std::vector<int> values(nbranches);
+   TTree in("in", "in");
+   TTree out("out", "out");
+   in.SetDirectory(nullptr);
+   out.SetDirectory(nullptr);
+   for (int b = 0; b < nbranches; ++b) {
+      const auto name = "i" + std::to_string(b);
+      in.Branch(name.c_str(), &values[b]);
+      out.Branch(name.c_str(), &values[b]);
+   }
+   for (int e = 0; e < 10; ++e) {
+      for (int b = 0; b < nbranches; ++b)
+         values[b] = e + b;
+      in.Fill();
+   }
+
+   // the option only applies to the copy
+   EXPECT_FALSE(out.GetParallelFill());
+   EXPECT_GT(out.CopyEntries(&in, -1, "ParallelFill"), 0);
+   EXPECT_EQ(out.GetEntries(), 10);
+   EXPECT_FALSE(out.GetParallelFill());
+
+   out.SetParallelFill();
+   EXPECT_GT(out.CopyEntries(&in, -1, "ParallelFill"), 0);
+   EXPECT_TRUE(out.GetParallelFill());
+}
+
+TEST(TTreeImplicitMT, parallelFillTimes)
+{
+   ROOT::EnableImplicitMT();
+   const auto ofileName = "parallelFillTimesMT.root";
+   const int nbranches = 20;
+   // less entries than needed to regroup the branches, the times are reported by the flush
+   const int nentries = 50;
+   FillTimesPerfStats perf;
+   {
+      TFile f(ofileName, "RECREATE");
+      TTree t("t", "t");
+      t.SetPerfStats(&perf);
+      t.SetParallelFill();
+      std::vector<double> values(nbranches);
+      for (int b = 0; b < nbranches; ++b)
+         t.Branch(("d" + std::to_string(b)).c_str(), &values[b]);
+
+      for (int e = 0; e < nentries; ++e)
+         t.Fill();
+      EXPECT_EQ(perf.fNBranchEvents, 0);
+      t.FlushBaskets();
+      EXPECT_EQ(perf.fNBranchEvents, nbranches);
+      EXPECT_GT(perf.fFillTime, 0.);
+
+      // and when the parallel fill is turned off
+      for (int e = 0; e < nentries; ++e)
+         t.Fill();
+      t.SetParallelFill(kFALSE);
+      EXPECT_EQ(perf.fNBranchEvents, 2 * nbranches);
+      t.FlushBaskets();
+      EXPECT_EQ(perf.fNBranchEvents, 2 * nbranches);
+
+      t.SetPerfStats(nullptr);
+   }
+   gSystem->Unlink(ofileName);
+}
+
 #endif // R__USE_IMT
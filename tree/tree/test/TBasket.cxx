@@ -4,7 +4,9 @@
 #include "TBranch.h"
 #include "TEnum.h"
 #include "TEnumConstant.h"
+#include "TFile.h"
 #include "TMemFile.h"
+#include "TSystem.h"
 #include "TTree.h"
 
 #include "gtest/gtest.h"
@@ -403,3 +405,40 @@ TEST(TBasket, TestSettingIOBits)
    readEntryOffset = reinterpret_cast<Bool_t *>(reinterpret_cast<char *>(basket2) + offset);
    EXPECT_EQ(*readEntryOffset, kTRUE);
 }
+
+TEST(TBasket, ZstdDictionaryTraining)
+{
+   const char *fname = "tbasket_zstd_dictionary.root";
+   const Int_t nEntries = 100000;
+   {
+      TFile f(fname, "RECREATE", "", ROOT::RCompressionSetting::EDefaults::kUseGeneralPurpose);
+      TTree t("t", "Tree with small baskets");
+      Double_t x;
+      t.Branch("x", &x, "x/D", 1000);
+      t.SetZstdDictionaryTraining("x", 1024);
+      for (Int_t i = 0; i < nEntries; ++i) {
+         x = 0.25 * (i % 1000);
+         t.Fill();
+      }
+      t.Write();
+   }
+
+   TFile f(fname);
+   ASSERT_FALSE(f.IsZombie());
+   std::unique_ptr<TList> infos(f.GetStreamerInfoList());
+   ASSERT_NE(nullptr, infos);
+   auto dicts = dynamic_cast<TList *>(infos->FindObject("listOfZstdDictionaries"));
+   ASSERT_NE(nullptr, dicts);
+   EXPECT_EQ(1, dicts->GetEntries());
+
+   auto t = f.Get<TTree>("t");
+   ASSERT_NE(nullptr, t);
+   Double_t x;
+   t->SetBranchAddress("x", &x);
+   ASSERT_EQ(nEntries, t->GetEntries());
+   for (Int_t i = 0; i < nEntries; ++i) {
+      ASSERT_GT(t->GetEntry(i), 0);
+      EXPECT_EQ(0.25 * (i % 1000), x);
+   }
+   gSystem->Unlink(fname);
+}
@@ -1,7 +1,9 @@
 #include "TFile.h"
 #include "TTree.h"
+#include "TChain.h"
 #include "TBranch.h"
 #include "TRandom.h"
+#include "TSystem.h"
 
 #include "gtest/gtest.h"
 
@@ -53,3 +55,89 @@ TEST_F(TTreeClusterTest, countBaskets)
 
    delete file;
 }
+
+static void WriteSmallClusterFiles(int nfiles)
+{
+   for (int i = 0; i < nfiles; ++i) {
+      TFile file(TString::Format("TTreeClusterCoalesce_in_%d.root", i), "RECREATE");
+      TTree tree("tree", "A small tree");
+      // A different auto-flush per file forces TTree::ImportClusterRanges to record a range per file.
+      tree.SetAutoFlush(100 + i);
+      Int_t x = 0;
+      Double_t y = 0;
+      tree.Branch("x", &x);
+      tree.Branch("y", &y);
+      for (Int_t ev = 0; ev < 20; ++ev) {
+         x = 20 * i + ev;
+         y = 0.5 * x;
+         tree.Fill();
+      }
+      file.Write();
+   }
+}
+
+static void RemoveSmallClusterFiles(int nfiles)
+{
+   for (int i = 0; i < nfiles; ++i)
+      gSystem->Unlink(TString::Format("TTreeClusterCoalesce_in_%d.root", i));
+}
+
+static Long64_t CountClusters(TTree *tree)
+{
+   Long64_t nclusters = 0;
+   auto clusters = tree->GetClusterIterator(0);
+   while (clusters.Next() < tree->GetEntries())
+      ++nclusters;
+   return nclusters;
+}
+
+TEST(TTreeClusterCoalesce, FastMerge)
+{
+   WriteSmallClusterFiles(4);
+
+   TChain chain("tree");
+   chain.Add("TTreeClusterCoalesce_in_*.root");
+   chain.SetBranchStatus("y", false);
+   auto merged = new TFile("TTreeClusterCoalesce_merged.root", "RECREATE");
+   chain.Merge(merged, 0, "fast");
+
+   {
+      TFile file("TTreeClusterCoalesce_merged.root");
+      auto tree = file.Get<TTree>("tree");
+      ASSERT_NE(tree, nullptr);
+      EXPECT_EQ(tree->GetEntries(), 80);
+      EXPECT_EQ(tree->GetListOfBranches()->GetEntries(), 1);
+      EXPECT_EQ(CountClusters(tree), 1);
+
+      Int_t x = -1;
+      tree->SetBranchAddress("x", &x);
+      for (Long64_t entry = 0; entry < tree->GetEntries(); ++entry) {
+         tree->GetEntry(entry);
+         EXPECT_EQ(x, entry);
+      }
+   }
+
+   RemoveSmallClusterFiles(4);
+   gSystem->Unlink("TTreeClusterCoalesce_merged.root");
+}
+
+TEST(TTreeClusterCoalesce, KeepClusters)
+{
+   WriteSmallClusterFiles(4);
+
+   TChain chain("tree");
+   chain.Add("TTreeClusterCoalesce_in_*.root");
+   auto merged = new TFile("TTreeClusterCoalesce_kept.root", "RECREATE");
+   chain.Merge(merged, 0, "fast KeepClusters");
+
+   {
+      TFile file("TTreeClusterCoalesce_kept.root");
+      auto tree = file.Get<TTree>("tree");
+      ASSERT_NE(tree, nullptr);
+      EXPECT_EQ(tree->GetEntries(), 80);
+      EXPECT_EQ(CountClusters(tree), 4);
+   }
+
+   RemoveSmallClusterFiles(4);
+   gSystem->Unlink("TTreeClusterCoalesce_kept.root");
+}
@@ -62,6 +62,7 @@ protected:
    Bool_t         fCleanElist;     //  true if original Tree elist must be saved
    Bool_t         fObjEval;        //  true if fVar1 returns an object (or pointer to).
    Long64_t       fCurrentSubEntry; // Current subentry when fSelectMultiple is true. Used to fill TEntryListArray
+   Bool_t         fJIT;            //! true if the formulas should be compiled with cling (see TTreeFormula::JITCompile)
 
 protected:
    virtual void      ClearFormula();
@@ -113,6 +114,7 @@ public:
    virtual void      ProcessFillMultiple(Long64_t entry);
    virtual void      ProcessFillObject(Long64_t entry);
    virtual void      SetEstimate(Long64_t n);
+   void              SetJIT(Bool_t jit = kTRUE) { fJIT = jit; }
    virtual UInt_t    SplitNames(const TString &varexp, std::vector<TString> &names);
    virtual void      TakeAction();
    virtual void      TakeEstimate();
@@ -131,6 +131,14 @@ protected:
 
    RealInstanceCache fRealInstanceCache; //! Cache accelerating the GetRealInstance function
 
+   // Signature of the cling-compiled version of the expression, see JITCompile()
+   typedef Double_t (*JITFunc_t)(void *formula, Int_t instance, Double_t (*operand)(void *, Int_t, Int_t));
+
+   JITFunc_t   fJITFunction = nullptr;    //! Compiled expression, null if the interpreter is used
+   Bool_t      fJITShortCircuit = kFALSE; //! True if the compiled expression contains && or ||
+   Bool_t      fJITWillLoad = kFALSE;     //! True if the current compiled evaluation must load the branches
+   Bool_t      fJITOutOfRange = kFALSE;   //! Set when one of the operands is out of range for the current instance
+
    TTreeFormula(const char *name, const char *formula, TTree *tree, const std::vector<std::string>& aliases);
    void Init(const char *name, const char *formula);
    Bool_t      BranchHasMethod(TLeaf* leaf, TBranch* branch, const char* method,const char* params, Long64_t readentry) const;
@@ -149,6 +157,10 @@ protected:
    virtual void*     GetValuePointerFromMethod(Int_t i, TLeaf *leaf) const;
    Int_t             GetRealInstance(Int_t instance, Int_t codeindex);
 
+   Double_t          EvalJITInstance(Int_t instance);
+   Double_t          EvalJITOperand(Int_t code, Int_t instance);
+   static Double_t   JITOperandAccessor(void *formula, Int_t code, Int_t instance);
+
    void              LoadBranches();
    Bool_t            LoadCurrentDim();
    void              ResetDimensions();
@@ -198,8 +210,10 @@ public:
    //the mutable keyword.
    //NOTE: Also modify the code in PrintValue which current goes around this limitation :(
    virtual Bool_t      IsInteger(Bool_t fast=kTRUE) const;
+           Bool_t      IsJITCompiled() const { return fJITFunction != nullptr; }
            Bool_t      IsQuickLoad() const { return fQuickLoad; }
    virtual Bool_t      IsString() const;
+           Bool_t      JITCompile();
    virtual Bool_t      Notify() { UpdateFormulaLeaves(); return kTRUE; }
    virtual char       *PrintValue(Int_t mode=0) const;
    virtual char       *PrintValue(Int_t mode, Int_t instance, const char *decform = "9.9") const;
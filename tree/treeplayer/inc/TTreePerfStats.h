@@ -75,6 +75,7 @@ protected:
 
    std::unordered_map<TBranch*, size_t>  fBranchIndexCache; // Cache the index of the branch in the cache's array.
    std::vector<std::vector<BasketInfo> > fBasketsInfo;      // Details on which baskets was used, cached, 'miss-cached' or read uncached.Browse
+   std::unordered_map<TBranch*, Double_t> fBranchFillTime; //! Time spent filling each top-level branch (TTree::SetParallelFill)
 
    BasketInfo &GetBasketInfo(TBranch *b, size_t basketNumber);
    BasketInfo &GetBasketInfo(size_t bi, size_t basketNumber);
@@ -111,6 +112,7 @@ public:
    virtual Double_t GetUnzipTime() const {return fUnzipTime; }
    virtual void     Paint(Option_t *chopt="");
    virtual void     Print(Option_t *option="") const;
+           void     PrintFillInfo(Option_t *option = "") const;
 
    virtual void     SimpleEvent(EEventType) {}
    virtual void     PacketEvent(const char *, const char *, const char *,
@@ -118,6 +120,7 @@ public:
    virtual void     FileEvent(const char *, const char *, const char *, const char *, Bool_t) {}
    virtual void     FileOpenEvent(TFile *, const char *, Double_t) {}
    virtual void     FileReadEvent(TFile *file, Int_t len, Double_t start);
+   virtual void     FillBranchEvent(TBranch *branch, Double_t filltime);
    virtual void     UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen);
    virtual void     RateEvent(Double_t , Double_t , Long64_t , Long64_t) {}
 
@@ -78,6 +78,7 @@ TSelectorDraw::TSelectorDraw()
    fWeight         = 1;
    fCurrentSubEntry = -1;
    fTreeElistArray  = 0;
+   fJIT             = kFALSE;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -991,6 +992,7 @@ Bool_t TSelectorDraw::CompileVariables(const char *varexp, const char *selection
          fSelect = 0;
          return kFALSE;
       }
+      if (fJIT) fSelect->JITCompile();
    }
 
    // if varexp is empty, take first column by default
@@ -1025,6 +1027,7 @@ Bool_t TSelectorDraw::CompileVariables(const char *varexp, const char *selection
       fVar[i] = new TTreeFormula(TString::Format("Var%i", i + 1), varnames[i].Data(), fTree);
       fVar[i]->SetQuickLoad(kTRUE);
       if(!fVar[i]->GetNdim()) { ClearFormula(); return kFALSE; }
+      if (fJIT) fVar[i]->JITCompile();
       fManager->Add(fVar[i]);
    }
    fManager->Sync();
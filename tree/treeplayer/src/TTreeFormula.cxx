@@ -44,6 +44,7 @@
 #include "strlcpy.h"
 #include "snprintf.h"
 #include "TEntryList.h"
+#include "TVirtualMutex.h"
 
 #include <cctype>
 #include <cstdio>
@@ -51,6 +52,8 @@
 #include <cstdlib>
 #include <typeinfo>
 #include <algorithm>
+#include <map>
+#include <type_traits>
 
 const Int_t kMaxLen     = 1024;
 
@@ -3944,6 +3947,7 @@ T TTreeFormula::EvalInstance(Int_t instance, const char *stringStackArg[])
 // Note that the redundance and structure in this code is tailored to improve
 // efficiencies.
    if (TestBit(kMissingLeaf)) return 0;
+   if (std::is_same<T, Double_t>::value && fJITFunction && !fAxis) return EvalJITInstance(instance);
    if (fNoper == 1 && fNcodes > 0) {
 
       switch (fLookupType[0]) {
@@ -4412,6 +4416,238 @@ template double TTreeFormula::EvalInstance<double> (int, char const**);
 template long double TTreeFormula::EvalInstance<long double> (int, char const**);
 template long long TTreeFormula::EvalInstance<long long> (int, char const**);
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Helpers used by the cling-compiled expressions. They reproduce exactly the
+/// protections against indeterminations applied by TTreeFormula::EvalInstance.
+
+const char *gJITHelpers = R"CODE(
+#include "TMath.h"
+#include <algorithm>
+#include <cmath>
+namespace TTreeFormulaJIT {
+inline double Div(double a, double b) { return b == 0 ? 0 : a / b; }
+inline double Mod(double a, double b) { return double((long long)a % (long long)b); }
+inline double Tan(double a) { return TMath::Cos(a) == 0 ? 0 : TMath::Tan(a); }
+inline double ACos(double a) { return TMath::Abs(a) > 1 ? 0 : TMath::ACos(a); }
+inline double ASin(double a) { return TMath::Abs(a) > 1 ? 0 : TMath::ASin(a); }
+inline double TanH(double a) { return TMath::CosH(a) == 0 ? 0 : TMath::TanH(a); }
+inline double ACosH(double a) { return a < 1 ? 0 : TMath::ACosH(a); }
+inline double ATanH(double a) { return TMath::Abs(a) > 1 ? 0 : TMath::ATanH(a); }
+inline double Log(double a) { return a > 0 ? TMath::Log(a) : 0; }
+inline double Log10(double a) { return a > 0 ? TMath::Log10(a) : 0; }
+inline double Exp(double a) { return a < -700 ? 0 : (a > 700 ? TMath::Exp(700) : TMath::Exp(a)); }
+inline double Sign(double a) { return a < 0 ? -1 : 1; }
+inline double Int(double a) { return double((long long)a); }
+inline unsigned long long Bits(double a) { return (unsigned long long)a; }
+}
+)CODE";
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Translate the expression into C++ and compile it with cling.
+///
+/// The operators are taken from the already parsed list of operations, so the
+/// compiled code follows exactly the same precedence and the same protections
+/// (e.g. division by zero) as the interpreted version. The tree variables are
+/// read back through TTreeFormula::EvalJITOperand, so array instances, variable
+/// indices and TFormLeafInfo chains are handled as in the interpreter.
+///
+/// Expressions using strings, aliases, external functions, graphical cuts,
+/// the ternary operator or the array reduction functions (Sum$, Min$, ...)
+/// are not supported; in that case kFALSE is returned and EvalInstance keeps
+/// using the interpreter. Identical expressions share the same compiled
+/// function.
+
+Bool_t TTreeFormula::JITCompile()
+{
+   if (fJITFunction) return kTRUE;
+   if (TestBit(kMissingLeaf) || fNoper < 2 || fAxis || IsString()) return kFALSE;
+
+   std::vector<TString> stack;
+   Bool_t shortCircuit = kFALSE;
+
+   for (Int_t i = 0; i < fNoper; ++i) {
+      const Int_t oper = GetOper()[i];
+      const Int_t action = oper >> kTFOperShift;
+      const Int_t param = oper & kTFOperMask;
+
+      // Number of operands consumed by the operation.
+      Int_t nargs = 0;
+      TString fmt;
+      switch (action) {
+         case kEnd:         nargs = -1; break;
+         case kConstant:    stack.push_back(TString::Format("double(%.17g)", fConst[param])); continue;
+         case kpi:          stack.push_back("TMath::Pi()"); continue;
+         case kBoolOptimize: shortCircuit = kTRUE; continue; // the C++ operators already short-circuit
+         case kAdd:         nargs = 2; fmt = "(%s+%s)"; break;
+         case kSubstract:   nargs = 2; fmt = "(%s-%s)"; break;
+         case kMultiply:    nargs = 2; fmt = "(%s*%s)"; break;
+         case kDivide:      nargs = 2; fmt = "TTreeFormulaJIT::Div(%s,%s)"; break;
+         case kModulo:      nargs = 2; fmt = "TTreeFormulaJIT::Mod(%s,%s)"; break;
+         case kcos:         nargs = 1; fmt = "TMath::Cos(%s)"; break;
+         case ksin:         nargs = 1; fmt = "TMath::Sin(%s)"; break;
+         case ktan:         nargs = 1; fmt = "TTreeFormulaJIT::Tan(%s)"; break;
+         case kacos:        nargs = 1; fmt = "TTreeFormulaJIT::ACos(%s)"; break;
+         case kasin:        nargs = 1; fmt = "TTreeFormulaJIT::ASin(%s)"; break;
+         case katan:        nargs = 1; fmt = "TMath::ATan(%s)"; break;
+         case kcosh:        nargs = 1; fmt = "TMath::CosH(%s)"; break;
+         case ksinh:        nargs = 1; fmt = "TMath::SinH(%s)"; break;
+         case ktanh:        nargs = 1; fmt = "TTreeFormulaJIT::TanH(%s)"; break;
+         case kacosh:       nargs = 1; fmt = "TTreeFormulaJIT::ACosH(%s)"; break;
+         case kasinh:       nargs = 1; fmt = "TMath::ASinH(%s)"; break;
+         case katanh:       nargs = 1; fmt = "TTreeFormulaJIT::ATanH(%s)"; break;
+         case katan2:       nargs = 2; fmt = "TMath::ATan2(%s,%s)"; break;
+         case kfmod:        nargs = 2; fmt = "std::fmod(%s,%s)"; break;
+         case kpow:         nargs = 2; fmt = "TMath::Power(%s,%s)"; break;
+         case ksq:          nargs = 1; fmt = "TMath::Sq(%s)"; break;
+         case ksqrt:        nargs = 1; fmt = "TMath::Sqrt(TMath::Abs(%s))"; break;
+         case kmin:         nargs = 2; fmt = "std::min<double>(%s,%s)"; break;
+         case kmax:         nargs = 2; fmt = "std::max<double>(%s,%s)"; break;
+         case klog:         nargs = 1; fmt = "TTreeFormulaJIT::Log(%s)"; break;
+         case kexp:         nargs = 1; fmt = "TTreeFormulaJIT::Exp(%s)"; break;
+         case klog10:       nargs = 1; fmt = "TTreeFormulaJIT::Log10(%s)"; break;
+         case kabs:         nargs = 1; fmt = "TMath::Abs(%s)"; break;
+         case ksign:        nargs = 1; fmt = "TTreeFormulaJIT::Sign(%s)"; break;
+         case kint:         nargs = 1; fmt = "TTreeFormulaJIT::Int(%s)"; break;
+         case kSignInv:     nargs = 1; fmt = "(-%s)"; break;
+         case kAnd:         nargs = 2; fmt = "double(%s!=0 && %s!=0)"; break;
+         case kOr:          nargs = 2; fmt = "double(%s!=0 || %s!=0)"; break;
+         case kEqual:       nargs = 2; fmt = "double(%s==%s)"; break;
+         case kNotEqual:    nargs = 2; fmt = "double(%s!=%s)"; break;
+         case kLess:        nargs = 2; fmt = "double(%s<%s)"; break;
+         case kGreater:     nargs = 2; fmt = "double(%s>%s)"; break;
+         case kLessThan:    nargs = 2; fmt = "double(%s<=%s)"; break;
+         case kGreaterThan: nargs = 2; fmt = "double(%s>=%s)"; break;
+         case kNot:         nargs = 1; fmt = "double(%s==0)"; break;
+         case kBitAnd:      nargs = 2; fmt = "double(TTreeFormulaJIT::Bits(%s) & TTreeFormulaJIT::Bits(%s))"; break;
+         case kBitOr:       nargs = 2; fmt = "double(TTreeFormulaJIT::Bits(%s) | TTreeFormulaJIT::Bits(%s))"; break;
+         case kLeftShift:   nargs = 2; fmt = "double(TTreeFormulaJIT::Bits(%s) << TTreeFormulaJIT::Bits(%s))"; break;
+         case kRightShift:  nargs = 2; fmt = "double(TTreeFormulaJIT::Bits(%s) >> TTreeFormulaJIT::Bits(%s))"; break;
+         case kDefinedVariable: {
+            switch (fLookupType[param]) {
+               case kDirect: case kMethod: case kDataMember: case kTreeMember:
+               case kIndexOfEntry: case kIndexOfLocalEntry: case kEntries: case kLocalEntries:
+               case kLength: case kIteration: case kEntryList:
+                  stack.push_back(TString::Format("operand(formula,%d,instance)", param));
+                  continue;
+               default:
+                  return kFALSE;
+            }
+         }
+         default:
+            // Strings, aliases, function calls, jumps, ...
+            return kFALSE;
+      }
+      if (nargs < 0) break;
+      if ((Int_t)stack.size() < nargs) return kFALSE;
+      if (nargs == 1) {
+         stack.back() = TString::Format(fmt.Data(), stack.back().Data());
+      } else {
+         TString right = stack.back();
+         stack.pop_back();
+         stack.back() = TString::Format(fmt.Data(), stack.back().Data(), right.Data());
+      }
+   }
+   if (stack.size() != 1) return kFALSE;
+
+   static ROOT::Internal::TJITFunctionCache gCompiled;
+   static Bool_t gHelpersDeclared = kFALSE;
+
+   R__LOCKGUARD(gROOTMutex);
+
+   std::string body = stack.back().Data();
+   void *func = nullptr;
+   if (!gCompiled.Find(body, func)) {
+      if (!gInterpreter) return kFALSE;
+      if (!gHelpersDeclared) {
+         if (!gInterpreter->Declare(gJITHelpers)) return kFALSE;
+         gHelpersDeclared = kTRUE;
+      }
+      const Int_t id = gCompiled.NextId();
+      TString name = TString::Format("TTreeFormulaJIT::Expr%d", id);
+      TString code = TString::Format("#pragma cling optimize(3)\n"
+                                     "namespace TTreeFormulaJIT {\n"
+                                     "double Expr%d(void *formula, int instance, double (*operand)(void *, int, int))\n"
+                                     "{\n   (void)formula; (void)instance; (void)operand;\n   return %s;\n}\n}\n",
+                                     id, body.c_str());
+      func = gCompiled.Compile(body, code.Data(), name.Data());
+      if (!func) {
+         Warning("JITCompile", "Compilation of %s failed, using the interpreter", GetTitle());
+      }
+   }
+   fJITFunction = reinterpret_cast<JITFunc_t>(func);
+   fJITShortCircuit = shortCircuit;
+   return fJITFunction != nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the cling-compiled version of the expression.
+
+Double_t TTreeFormula::EvalJITInstance(Int_t instance)
+{
+   const Bool_t willLoad = (instance==0 || fNeedLoading); fNeedLoading = kFALSE;
+   // We do not know whether the compiled code skipped some operands, so if it can
+   // do so, always behave as if it did (i.e. check the branches of the operands that
+   // are evaluated after instance 0).
+   if (willLoad) fDidBooleanOptimization = fJITShortCircuit;
+
+   fJITWillLoad = willLoad;
+   fJITOutOfRange = kFALSE;
+   Double_t result = fJITFunction(this, instance, &TTreeFormula::JITOperandAccessor);
+   return fJITOutOfRange ? 0 : result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Static trampoline passed to the compiled expression to read the operands.
+
+Double_t TTreeFormula::JITOperandAccessor(void *formula, Int_t code, Int_t instance)
+{
+   return static_cast<TTreeFormula*>(formula)->EvalJITOperand(code, instance);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the value of the tree variable 'code' for the compiled expression.
+///
+/// This is the same as the kDefinedVariable case of EvalInstance except that,
+/// if the instance is out of range, fJITOutOfRange is set (and the whole
+/// expression evaluates to 0, as in the interpreter).
+
+Double_t TTreeFormula::EvalJITOperand(Int_t code, Int_t instance)
+{
+   const Bool_t willLoad = fJITWillLoad;
+   switch (fLookupType[code]) {
+      case kIndexOfEntry:      return fTree->GetReadEntry();
+      case kIndexOfLocalEntry: return fTree->GetTree()->GetReadEntry();
+      case kEntries:           return fTree->GetEntries();
+      case kLocalEntries:      return fTree->GetTree()->GetEntries();
+      case kLength:            return fManager->fNdata;
+      case kIteration:         return instance;
+      case kEntryList: {
+         TEntryList *elist = (TEntryList*)fExternalCuts.At(code);
+         return elist->Contains(fTree->GetReadEntry());
+      }
+   }
+
+   // The TT_EVAL_INIT_LOOP and TREE_EVAL_INIT_LOOP macros return 0 when the
+   // instance is out of range, record it until proven otherwise.
+   const Bool_t outOfRange = fJITOutOfRange;
+   fJITOutOfRange = kTRUE;
+   Double_t result = 0;
+   switch (fLookupType[code]) {
+      case kDirect:     { TT_EVAL_INIT_LOOP; result = leaf->GetTypedValue<Double_t>(real_instance); break; }
+      case kMethod:     { TT_EVAL_INIT_LOOP; result = GetValueFromMethod(code,leaf); break; }
+      case kDataMember: { TT_EVAL_INIT_LOOP; result = ((TFormLeafInfo*)fDataMembers.UncheckedAt(code))->
+                                 GetTypedValue<Double_t>(leaf,real_instance); break; }
+      case kTreeMember: { TREE_EVAL_INIT_LOOP; result = ((TFormLeafInfo*)fDataMembers.UncheckedAt(code))->
+                                 GetTypedValue<Double_t>((TLeaf*)0x0,real_instance); break; }
+   }
+   fJITOutOfRange = outOfRange;
+   return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return DataMember corresponding to code.
 ///
@@ -98,6 +98,7 @@ The Physical disk speed is DiskIO + DiskIO*ReadExtra/100.
 #include "TMath.h"
 
 #include <iostream>
+#include <algorithm>
 
 ClassImp(TTreePerfStats);
 
@@ -320,6 +321,16 @@ void TTreePerfStats::UnzipEvent(TObject * tree, Long64_t /* pos */, Double_t sta
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Record the time spent filling a top-level branch.
+/// This is called periodically by TTree::Fill when the branches are filled in
+/// parallel (see TTree::SetParallelFill).
+
+void TTreePerfStats::FillBranchEvent(TBranch *branch, Double_t filltime)
+{
+   fBranchFillTime[branch] += filltime;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// When the run is finished this function must be called
 /// to save the current parameters in the file and Tree in this object
@@ -536,6 +547,8 @@ void TTreePerfStats::Paint(Option_t *option)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Print the TTree I/O perf stats.
+/// If option contains "fill", also print the time spent filling each
+/// branch (see PrintFillInfo).
 
 void TTreePerfStats::Print(Option_t * option) const
 {
@@ -573,6 +586,38 @@ void TTreePerfStats::Print(Option_t * option) const
    }
    if (basket)
       PrintBasketInfo(option);
+   if (opts.Contains("fill"))
+      PrintFillInfo(option);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the time spent filling the top-level branches, most expensive first.
+/// Only the 20 most expensive branches are printed unless the option contains
+/// "allfillinfo".
+
+void TTreePerfStats::PrintFillInfo(Option_t *option) const
+{
+   TString opts(option);
+   opts.ToLower();
+   Bool_t all = opts.Contains("allfillinfo");
+
+   std::vector<std::pair<Double_t, TBranch *>> sorted;
+   Double_t total = 0;
+   for (auto &entry : fBranchFillTime) {
+      sorted.emplace_back(entry.second, entry.first);
+      total += entry.second;
+   }
+   std::sort(sorted.begin(), sorted.end(),
+             [](const std::pair<Double_t, TBranch *> &a, const std::pair<Double_t, TBranch *> &b) {
+                return a.first > b.first;
+             });
+
+   printf("FillTime  = %7.3f seconds in %zu branches\n", total, sorted.size());
+   const size_t nprint = all ? sorted.size() : std::min<size_t>(sorted.size(), 20);
+   for (size_t i = 0; i < nprint; ++i) {
+      printf("  br=%zu %s fill time: %7.3f seconds (%5.2f per cent)\n", i, sorted[i].second->GetName(),
+             sorted[i].first, total > 0 ? 100. * sorted[i].first / total : 0.);
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -26,6 +26,7 @@ extra libraries (Histogram, display, etc).
 #include "TROOT.h"
 #include "TApplication.h"
 #include "TSystem.h"
+#include "TEnv.h"
 #include "TFile.h"
 #include "TEventList.h"
 #include "TEntryList.h"
@@ -415,8 +416,14 @@ Long64_t TTreePlayer::DrawSelect(const char *varexp0, const char *selection, Opt
    // Do not process more than fMaxEntryLoop entries
    if (nentries > fTree->GetMaxEntryLoop()) nentries = fTree->GetMaxEntryLoop();
 
+   // Option "jit" is handled here, it is not a drawing option
+   TString drawopt = option;
+   Ssiz_t jitpos = drawopt.Index("jit", 0, TString::kIgnoreCase);
+   if (jitpos != kNPOS) drawopt.Remove(jitpos, 3);
+   fSelector->SetJIT(jitpos != kNPOS || gEnv->GetValue("TTreeFormula.JIT", 0));
+
    // invoke the selector
-   Long64_t nrows = Process(fSelector,option,nentries,firstentry);
+   Long64_t nrows = Process(fSelector,drawopt,nentries,firstentry);
    fSelectedRows = nrows;
    fDimension = fSelector->GetDimension();
 
@@ -2411,6 +2418,9 @@ void TTreePlayer::RecursiveRemove(TObject *obj)
 ///       conversion specifier is given, will be suffixed by the letter g.
 ///       before being passed to fprintf.  If no format is specified for a
 ///       column, the default is used  (aka ${colsize}.${precision}g )
+/// -  jit
+///       Compile the selection and the columns with cling instead of
+///       interpreting them (see TTreeFormula::JITCompile).
 ///
 /// For example:
 /// ~~~{.cpp}
@@ -2619,6 +2629,10 @@ Long64_t TTreePlayer::Scan(const char *varexp, const char *selection,
       var[ui] = new TTreeFormula("Var1",cnames[ui].Data(),fTree);
       fFormulaList->Add(var[ui]);
    }
+   if (opt.Contains("jit") || gEnv->GetValue("TTreeFormula.JIT", 0)) {
+      if (select) select->JITCompile();
+      for (ui=0;ui<ncols;ui++) var[ui]->JITCompile();
+   }
 
 //*-*- Create a TreeFormulaManager to coordinate the formulas
    TTreeFormulaManager *manager=0;
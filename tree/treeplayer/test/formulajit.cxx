@@ -0,0 +1,73 @@
+#include "TTree.h"
+#include "TTreeFormula.h"
+
+#include "gtest/gtest.h"
+
+static void FillJITTree(TTree &t)
+{
+   int n = 0;
+   float x = 0;
+   double arr[3];
+   t.Branch("n", &n);
+   t.Branch("x", &x);
+   t.Branch("arr", arr, "arr[3]/D");
+   for (int i = 0; i < 20; ++i) {
+      n = i;
+      x = 0.5f * i - 3;
+      for (int j = 0; j < 3; ++j)
+         arr[j] = i * j - 4.;
+      t.Fill();
+   }
+}
+
+TEST(TTreeFormulaJIT, SameResultAsInterpreter)
+{
+   TTree t("t", "t");
+   t.SetDirectory(nullptr);
+   FillJITTree(t);
+
+   const char *exprs[] = {"x*n+3", "sqrt(x)/(n-2)", "n%3 + (x>0 && n<10)", "arr*2-x", "log(arr)+exp(x)",
+                          "abs(arr[1])*sin(x)", "!(n==4) || x<0", "(n&3)|(n<<1)"};
+   for (auto expr : exprs) {
+      TTreeFormula interpreted("interpreted", expr, &t);
+      TTreeFormula compiled("compiled", expr, &t);
+      EXPECT_TRUE(compiled.JITCompile()) << expr;
+      EXPECT_TRUE(compiled.IsJITCompiled()) << expr;
+      for (Long64_t entry = 0; entry < t.GetEntries(); ++entry) {
+         t.LoadTree(entry);
+         interpreted.GetNdata();
+         const Int_t ndata = compiled.GetNdata();
+         for (Int_t i = 0; i < ndata; ++i)
+            EXPECT_DOUBLE_EQ(interpreted.EvalInstance(i), compiled.EvalInstance(i)) << expr << " entry " << entry;
+      }
+   }
+}
+
+TEST(TTreeFormulaJIT, FallbackToInterpreter)
+{
+   TTree t("t", "t");
+   t.SetDirectory(nullptr);
+   FillJITTree(t);
+
+   // Array reductions are not translated.
+   TTreeFormula sum("sum", "Sum$(arr)+x", &t);
+   EXPECT_FALSE(sum.JITCompile());
+   EXPECT_FALSE(sum.IsJITCompiled());
+   t.LoadTree(2);
+   sum.GetNdata();
+   EXPECT_DOUBLE_EQ(sum.EvalInstance(0), (-4. - 2. + 0.) + (1. - 3.));
+}
+
+TEST(TTreeFormulaJIT, Draw)
+{
+   TTree t("t", "t");
+   t.SetDirectory(nullptr);
+   FillJITTree(t);
+
+   const Long64_t nInterpreted = t.Draw("arr*x", "n>3 && arr[2]>0", "goff");
+   std::vector<double> interpreted(t.GetV1(), t.GetV1() + nInterpreted);
+   const Long64_t nCompiled = t.Draw("arr*x", "n>3 && arr[2]>0", "goff jit");
+   ASSERT_EQ(nInterpreted, nCompiled);
+   for (Long64_t i = 0; i < nCompiled; ++i)
+      EXPECT_DOUBLE_EQ(interpreted[i], t.GetV1()[i]);
+}